@@ -30,6 +30,7 @@
 #include <list>
 #include <unordered_map>
 #include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
 #include <CLRX/amdasm/Commons.h>
 #include <CLRX/amdasm/AsmSource.h>
 #include <CLRX/amdasm/AsmFormats.h>
@@ -202,8 +203,10 @@ struct AsmSymbol
     { return hasValue || expression!=nullptr; }
 };
 
-/// assembler symbol map
-typedef std::unordered_map<CString, AsmSymbol> AsmSymbolMap;
+/// assembler symbol map (symbols can be allocated in assembler's memory arena)
+typedef std::unordered_map<CString, AsmSymbol, std::hash<CString>,
+        std::equal_to<CString>, ArenaAllocator<std::pair<const CString, AsmSymbol> > >
+        AsmSymbolMap;
 /// assembler symbol entry
 typedef AsmSymbolMap::value_type AsmSymbolEntry;
 
@@ -589,6 +592,8 @@ struct AsmWaitConfig
     cxuint waitQueuesNum;
     AsmDelayInstrTypeEntry delayInstrTypes[ASM_DELAY_INSTR_MAX_TYPES_NUM];
     uint16_t waitQueueSizes[ASM_WAIT_MAX_TYPES_NUM];
+    /// names of wait queues (counters) used in messages
+    const char* waitQueueNames[ASM_WAIT_MAX_TYPES_NUM];
 };
 
 enum : cxbyte
@@ -666,6 +671,19 @@ struct AsmScope
     AsmScope(AsmScope* _parent = nullptr, bool _temporary= false)
             : parent(_parent), temporary(_temporary), enumCount(0)
     { }
+    /// constructor with memory arena for symbols
+    AsmScope(AsmScope* _parent, MemoryArena* symbolArena, bool _temporary = false)
+            : parent(_parent), symbolMap(0, AsmSymbolMap::hasher(),
+              AsmSymbolMap::key_equal(), AsmSymbolMap::allocator_type(symbolArena)),
+              temporary(_temporary), enumCount(0)
+    { }
+    /// constructor with initial symbols and memory arena for symbols
+    AsmScope(AsmScope* _parent, std::initializer_list<AsmSymbolEntry> symbols,
+             MemoryArena* symbolArena, bool _temporary = false)
+            : parent(_parent), symbolMap(symbols, 0, AsmSymbolMap::hasher(),
+              AsmSymbolMap::key_equal(), AsmSymbolMap::allocator_type(symbolArena)),
+              temporary(_temporary), enumCount(0)
+    { }
     /// destructor
     ~AsmScope();
     
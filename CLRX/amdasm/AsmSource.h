@@ -186,6 +186,24 @@ public:
         LineNo lineNo;    ///< line number
         RefPtr<const AsmSource> source; ///< source
     };
+    
+    /// type of substitution in compiled macro
+    enum SubstType: cxbyte
+    {
+        SUBST_NONE = 0,     ///< no substitution (backslash is kept)
+        SUBST_ARG,          ///< macro argument
+        SUBST_COUNTER,      ///< macro counter ('\@')
+        SUBST_SEPARATOR     ///< empty separator ('\()') or backslash at end
+    };
+    
+    /// substitution (backslash) in compiled macro content
+    struct Substitution
+    {
+        size_t position;    ///< position of backslash in content
+        size_t argIndex;    ///< index of argument in sorted arguments (for SUBST_ARG)
+        size_t length;      ///< length of replaced text after backslash
+        SubstType type;     ///< substitution type
+    };
 private:
     LineNo contentLineNo;
     AsmSourcePos sourcePos;
@@ -193,6 +211,8 @@ private:
     std::vector<char> content;
     std::vector<SourceTrans> sourceTranslations;
     std::vector<LineTrans> colTranslations;
+    bool compiled;
+    std::vector<Substitution> substitutions;
 public:
     /// constructor
     AsmMacro(const AsmSourcePos& pos, const Array<AsmMacroArg>& args);
@@ -230,6 +250,16 @@ public:
     /// get argument
     const AsmMacroArg& getArg(size_t i) const
     { return args[i]; }
+    
+    /// compile macro (find all substitutions for non-altmacro mode)
+    /** must be called after adding all lines */
+    void compile();
+    /// return true if macro is compiled
+    bool isCompiled() const
+    { return compiled; }
+    /// get substitutions of compiled macro (sorted by position)
+    const std::vector<Substitution>& getSubstitutions() const
+    { return substitutions; }
 };
 
 /// assembler repeat
@@ -406,6 +436,35 @@ public:
     { return type; }
 };
 
+/// filtered lines of source file (shared by assemblers by include cache)
+struct AsmFilteredFile: public RefCountable
+{
+    /// filtered line
+    struct Line
+    {
+        size_t offset;      ///< offset in content
+        size_t size;        ///< line size
+        size_t colTransIndex;   ///< index of first column translation of line
+        LineNo lineNo;      ///< line number after reading line
+    };
+    /// warning or error printed while filtering
+    struct Diagnostic
+    {
+        size_t lineIndex;   ///< index of line while reading which is printed
+        LineCol lineCol;    ///< line and column
+        bool error;         ///< true if error
+        CString message;    ///< message
+    };
+    
+    CString path;       ///< resolved path of file
+    uint64_t fileSize;  ///< size of file
+    std::pair<uint64_t, uint64_t> contentHash;  ///< hash of file content
+    std::vector<char> content;  ///< content of filtered lines
+    std::vector<Line> lines;    ///< lines
+    std::vector<LineTrans> colTranslations; ///< column translations of lines
+    std::vector<Diagnostic> diagnostics;    ///< diagnostics
+};
+
 /// assembler input layout filter
 /** filters input from comments and join splitted lines by backslash.
  * readLine returns prepared line which have only space (' ') and
@@ -423,10 +482,16 @@ private:
     };
     
     bool managed;
-    std::istream* stream;
+    std::istream* stream;   ///< input stream (null if source file is mapped)
+    MappedFile mappedFile;  ///< mapped source file
     LineMode mode;
     size_t stmtPos;
+    RefPtr<AsmFilteredFile> filteredFile;   ///< recorded filtered lines
     
+    void mapSourceFile(const CString& filename);
+    const char* filterLine(Assembler& assembler, size_t& lineSize);
+    void printFilterWarning(Assembler& assembler, LineCol lineCol, const char* message);
+    void printFilterError(Assembler& assembler, LineCol lineCol, const char* message);
 public:
     /// constructor with input stream and their filename
     explicit AsmStreamInputFilter(std::istream& is, const CString& filename = "");
@@ -440,6 +505,31 @@ public:
     /// destructor
     ~AsmStreamInputFilter();
     
+    /// calculate hash of content of mapped file (returns false if stream is read)
+    /** must be called before reading first line (lines are filtered in place) */
+    bool calculateContentHash(std::pair<uint64_t, uint64_t>& hash) const;
+    
+    /// record filtered lines to file (put to include cache at end of source)
+    /** must be called before reading first line (hashes unfiltered content) */
+    void recordFilteredLines(RefPtr<AsmFilteredFile> file);
+    
+    const char* readLine(Assembler& assembler, size_t& lineSize);
+};
+
+/// assembler input filter that reads already filtered lines (from include cache)
+class AsmCachedInputFilter: public AsmInputFilter
+{
+private:
+    RefPtr<const AsmFilteredFile> filteredFile;
+    size_t lineIndex;
+    size_t diagIndex;
+public:
+    /// constructor with filename and filtered file
+    AsmCachedInputFilter(const CString& filename, RefPtr<const AsmFilteredFile> filteredFile);
+    /// constructor with source position, filename and filtered file
+    AsmCachedInputFilter(const AsmSourcePos& pos, const CString& filename,
+                RefPtr<const AsmFilteredFile> filteredFile);
+    
     const char* readLine(Assembler& assembler, size_t& lineSize);
 };
 
@@ -462,6 +552,7 @@ private:
     const LineTrans* curColTrans;
     size_t realLinePos; ///< real line size
     bool alternateMacro;
+    size_t substIndex;  ///< index of next substitution (for compiled macro)
 public:
     /// constructor with input macro, source position and arguments map
     AsmMacroInputFilter(RefPtr<const AsmMacro> macro, const AsmSourcePos& pos,
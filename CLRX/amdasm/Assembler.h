@@ -29,8 +29,11 @@
 #include <istream>
 #include <ostream>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <utility>
+#include <memory>
+#include <functional>
 #include <stack>
 #include <list>
 #include <unordered_set>
@@ -61,10 +64,55 @@ enum: Flags
     ASM_BUGGYFPLIT = 8, ///< buggy handling of fpliterals (including fp constants)
     ASM_MACRONOCASE = 16, /// disable case-insensitive naming (default)
     ASM_OLDMODPARAM = 32,   ///< use old modifier parametrization (values 0 and 1 only)
+    ASM_STATS = 64,     ///< collect statistics (phase times, counters)
+    ASM_INCLUDECACHE = 128, ///< use process-wide cache of filtered include files
+    ASM_CHECKWAITS = 256,   ///< warn about missing and too broad waits (wait scheduler)
+    ASM_FILEHASHES = 512,   ///< record hashes of content of source files while reading
     ASM_TESTRESOLVE = (1U<<30), ///< enable resolving symbols if ASM_TESTRUN enabled
     ASM_TESTRUN = (1U<<31), ///< only for running tests
     ASM_ALL = FLAGS_ALL&~(ASM_TESTRUN|ASM_TESTRESOLVE|ASM_BUGGYFPLIT|ASM_MACRONOCASE|
-                    ASM_OLDMODPARAM)  ///< all flags
+                    ASM_OLDMODPARAM|ASM_STATS|ASM_INCLUDECACHE|
+                    ASM_CHECKWAITS|ASM_FILEHASHES)  ///< all flags
+};
+
+/// assembler phase (used by statistics)
+enum class AsmPhase: cxuint
+{
+    OTHER = 0,      ///< labels, assignments and rest of statement handling
+    INPUT,          ///< reading and filtering source lines
+    MACRO,          ///< macro substitution and repetitions
+    PSEUDO_OP,      ///< handling pseudo-ops
+    EXPRESSION,     ///< parsing and evaluating expressions
+    INSTRUCTION,    ///< encoding instructions
+    RESOLVING,      ///< resolving symbols and expressions after source end
+    PREPARE_BINARY, ///< preparing binary by format handler
+    WRITE_BINARY,   ///< writing binary by format handler
+    REG_ALLOC,      ///< register allocation
+    WAIT_SCHEDULE   ///< wait scheduling
+};
+
+enum: cxuint {
+    ASM_PHASES_NUM = cxuint(AsmPhase::WAIT_SCHEDULE)+1  ///< number of phases
+};
+
+/// get name of assembler phase
+extern const char* getAsmPhaseName(AsmPhase phase);
+
+/// assembler statistics
+/** filled only if assembler has been compiled with statistics (HAVE_ASM_STATS).
+ * Phase times are measured only if ASM_STATS flag has been enabled.
+ * Time of the phase does not include time of the nested phases */
+struct AsmStats
+{
+    uint64_t phaseTimes[ASM_PHASES_NUM];    ///< wall time of phases in nanoseconds
+    uint64_t linesNum;          ///< number of read source lines (after filtering)
+    uint64_t macroExpansions;   ///< number of macro substitutions
+    uint64_t repetitionsNum;    ///< number of repetitions (rept, irp, for, while)
+    uint64_t symbolsNum;        ///< number of symbols in all scopes
+    uint64_t relocationsNum;    ///< number of relocations
+    uint64_t unevalExpressionsNum;  ///< number of expressions not evaluated at parsing
+    uint64_t exprAllocsNum;     ///< number of allocated expressions
+    uint64_t inputFilterAllocsNum;  ///< number of allocated input filters
 };
 
 struct AsmRegVar;
@@ -120,6 +168,8 @@ protected:
     size_t readOffset;  ///< read offset
     size_t instrStructPos;  ///< position in instr struct
     size_t regVarUsagesPos; ///< position in regvar usage
+    size_t usagesNum;   ///< number of pushed usages
+    size_t instrsNum;   ///< number of instructions with usages
     uint16_t pushedArgs;    ///< pushed args
     cxbyte argPos;      ///< argument position
     cxbyte argFlags;    ///< ???
@@ -173,6 +223,16 @@ public:
     /// push regvar or register from usereg pseudo-op
     void pushUseRegUsage(const AsmRegVarUsage& rvu);
     
+    /// get number of pushed usages
+    size_t getUsagesNum() const
+    { return usagesNum; }
+    /// get number of instructions with usages (usages at same offset)
+    size_t getInstrsNum() const
+    { return instrsNum; }
+    /// get size of encoded usages (in bytes)
+    size_t getEncodedSize() const
+    { return instrStruct.size() + regVarUsages.size(); }
+    
     /// get RW flags (used by assembler)
     virtual cxbyte getRwFlags(AsmRegField regField, uint16_t rstart,
                       uint16_t rend) const = 0;
@@ -184,6 +244,42 @@ public:
                     cxbyte* linearDeps) const = 0;
 };
 
+/// register usages decoded from usage handler (structure of arrays)
+/** usages are grouped by instruction: usages of i'th instruction have indices
+ * from instrUsageStarts[i] to instrUsageStarts[i+1]. Arrays are reserved for
+ * sizes counted by usage handler. Code blocks hold index of their first instruction */
+struct ISAUsageArrays
+{
+    std::vector<size_t> instrOffsets;   ///< offsets of instructions
+    std::vector<uint32_t> instrUsageStarts; ///< first usages of instructions (and end)
+    std::vector<const AsmRegVar*> regVars;  ///< regvars (null if register)
+    std::vector<uint16_t> rstarts;  ///< register starts
+    std::vector<uint16_t> rends;    ///< register ends
+    std::vector<AsmRegField> regFields; ///< places in instruction
+    std::vector<cxbyte> rwFlags;    ///< rw flags (7 bit - from usereg pseudo-op)
+    std::vector<cxbyte> aligns;     ///< register alignments
+    
+    /// clear arrays
+    void clear();
+    /// decode all usages from usage handler
+    void assign(ISAUsageHandler& usageHandler);
+    /// get instructions number
+    size_t getInstrsNum() const
+    { return instrOffsets.size(); }
+    /// get usages number
+    size_t getUsagesNum() const
+    { return regVars.size(); }
+    /// get usage (instrIndex - index of instruction of usage)
+    AsmRegVarUsage getUsage(size_t instrIndex, size_t usageIndex) const
+    { return { instrOffsets[instrIndex], regVars[usageIndex], rstarts[usageIndex],
+            rends[usageIndex], regFields[usageIndex], cxbyte(rwFlags[usageIndex] & 0x7f),
+            aligns[usageIndex], (rwFlags[usageIndex] & 0x80) != 0 }; }
+    /// get index of first instruction at or after offset
+    size_t lowerBound(size_t offset) const;
+    /// get size of arrays (in bytes)
+    size_t getMemorySize() const;
+};
+
 /// ISA regvar linear handler
 class ISALinearDepHandler
 {
@@ -423,6 +519,13 @@ public:
     const AsmWaitConfig& getWaitConfig() const;
 };
 
+/// register allocation mode
+enum class AsmRegAllocMode: cxbyte
+{
+    GRAPH_COLORING = 0, ///< coloring of interference graph (fewer registers)
+    LINEAR_SCAN         ///< linear scan over live intervals (faster)
+};
+
 class AsmRegAllocator
 {
 public:
@@ -463,8 +566,8 @@ public:
         bool haveEnd;   ///< code have end
         // key - regvar, value - SSA info for this regvar
         Array<std::pair<AsmSingleVReg, SSAInfo> > ssaInfoMap;
-        ISAUsageHandler::ReadPos usagePos;
-        size_t linearDepPos;
+        size_t usagePos; ///< first instruction in usage arrays
+        size_t linearDepPos; ///< first linear dep (set by createSSAData)
     };
     
     typedef Array<std::pair<size_t, size_t> > OutLiveness;
@@ -472,8 +575,49 @@ public:
      // first - orig ssaid, second - dest ssaid
     typedef std::pair<size_t, size_t> SSAReplace;
     typedef std::unordered_map<AsmSingleVReg, VectorSet<SSAReplace> > SSAReplacesMap;
-    // interference graph type
-    typedef Array<DTreeSet<size_t> > InterGraph;
+    /// interference graph
+    /** edges are collected in bit matrix for small graphs or in adjacency lists
+     * for big graphs. After adding edges, finalize builds sorted adjacency lists */
+    class InterGraph
+    {
+    private:
+        size_t nodesNum;
+        size_t rowWords;    // words in bit matrix row (0 if adjacency lists are used)
+        std::vector<uint64_t> matrix;
+        std::vector<std::vector<size_t> > nodeEdges;
+        Array<size_t> adjStarts;
+        Array<size_t> adjNodes;
+    public:
+        /// max nodes number for bit matrix
+        static const size_t maxMatrixNodesNum = 8192;
+        
+        /// constructor
+        InterGraph() : nodesNum(0), rowWords(0)
+        { }
+        /// clear graph and set nodes number
+        void resize(size_t nodesNum);
+        /// clear graph
+        void clear()
+        { resize(0); }
+        /// get nodes number
+        size_t size() const
+        { return nodesNum; }
+        /// add edges between node and other nodes
+        void addEdges(size_t node, const std::vector<size_t>& nodes);
+        /// build adjacency lists (must be called after adding edges)
+        void finalize();
+        /// returns true if graph has edge between nodes (after finalize)
+        bool hasEdge(size_t node1, size_t node2) const;
+        /// get node degree (after finalize)
+        size_t degree(size_t node) const
+        { return adjStarts[node+1] - adjStarts[node]; }
+        /// get first neighbor of node (after finalize)
+        const size_t* adjBegin(size_t node) const
+        { return adjNodes.data() + adjStarts[node]; }
+        /// get end of neighbors of node (after finalize)
+        const size_t* adjEnd(size_t node) const
+        { return adjNodes.data() + adjStarts[node+1]; }
+    };
     typedef std::unordered_map<AsmSingleVReg, std::vector<size_t> > VarIndexMap;
     struct LinearDep
     {
@@ -491,6 +635,8 @@ private:
     std::vector<CodeBlock> codeBlocks;
     SSAReplacesMap ssaReplacesMap;
     size_t regTypesNum;
+    AsmRegAllocMode allocMode;
+    ISAUsageArrays usageArrays;
     
     Array<OutLiveness> outLivenesses[MAX_REGTYPES_NUM];
     size_t graphVregsCounts[MAX_REGTYPES_NUM];
@@ -511,18 +657,36 @@ public:
     
     void createCodeStructure(const std::vector<AsmCodeFlowEntry>& codeFlow,
              size_t codeSize, const cxbyte* code);
+    /// decode usages to usage arrays and set usage positions of code blocks
+    void createUsageArrays(ISAUsageHandler& usageHandler);
+    /// create SSA data (calls createUsageArrays)
     void createSSAData(ISAUsageHandler& usageHandler,
                 ISALinearDepHandler& linDepHandler);
     void applySSAReplaces();
+    /// create livenesses (needs usage arrays and positions from createSSAData)
     void createLivenesses(ISAUsageHandler& usageHandler,
                 ISALinearDepHandler& linDepHandler);
+    /// keep registers of delayed operations live until wait for their results
+    void extendDelayedOpLivenesses(ISAWaitHandler& waitHandler);
     void createInterferenceGraph();
     void colorInterferenceGraph();
+    /// allocate registers by linear scan (uses livenesses instead of graph)
+    void linearScanRegisters();
     
     void allocateRegisters(AsmSectionId sectionId);
     
+    /// get register allocation mode
+    AsmRegAllocMode getAllocMode() const
+    { return allocMode; }
+    /// set register allocation mode (used by allocateRegisters)
+    void setAllocMode(AsmRegAllocMode mode)
+    { allocMode = mode; }
+    
     const std::vector<CodeBlock>& getCodeBlocks() const
     { return codeBlocks; }
+    /// get usages decoded by createUsageArrays
+    const ISAUsageArrays& getUsageArrays() const
+    { return usageArrays; }
     const SSAReplacesMap& getSSAReplacesMap() const
     { return ssaReplacesMap; }
     const Array<OutLiveness>* getOutLivenesses() const
@@ -533,6 +697,8 @@ public:
     
     const VarIndexMap* getVregIndexMaps() const
     { return vregIndexMaps; }
+    const Array<cxuint>* getGraphColorMaps() const
+    { return graphColorMaps; }
     
     const std::unordered_map<size_t, VIdxSetEntry>& getVIdxRoutineMap() const
     { return vidxRoutineMap; }
@@ -547,20 +713,34 @@ private:
     const AsmWaitConfig& waitConfig;
     Assembler& assembler;
     const std::vector<AsmRegAllocator::CodeBlock>& codeBlocks;
+    const ISAUsageArrays& usageArrays;
     const AsmRegAllocator::VarIndexMap* vregIndexMaps;
     const Array<cxuint>* graphColorMaps;
     bool onlyWarnings;
     std::vector<AsmWaitInstr> neededWaitInstrs;
+    std::vector<AsmWaitInstr> tooBroadWaitInstrs;
 public:
+    /// constructor
+    /** code blocks and usage arrays are from register allocator
+     * (after createUsageArrays) */
     AsmWaitScheduler(const AsmWaitConfig& asmWaitConfig, Assembler& assembler,
             const std::vector<AsmRegAllocator::CodeBlock>& codeBlocks,
+            const ISAUsageArrays& usageArrays,
             const AsmRegAllocator::VarIndexMap* vregIndexMaps,
             const Array<cxuint>* graphColorMaps, bool onlyWarnings);
     
-    void schedule();
+    /// find waits needed before instructions in code of section
+    /** waits already put in code are taken into account. If onlyWarnings enabled,
+     * then prints warnings about missing and too broad waits */
+    void schedule(AsmSectionId sectionId);
     
+    /// get needed waits (sorted by offset)
     const std::vector<AsmWaitInstr>& getNeededWaitInstrs() const
     { return neededWaitInstrs; }
+    /// get waits from code stronger than needed by next instruction (sorted by offset)
+    /** every entry holds offset of wait in code and waits which are enough */
+    const std::vector<AsmWaitInstr>& getTooBroadWaitInstrs() const
+    { return tooBroadWaitInstrs; }
 };
 
 /// type of clause
@@ -592,6 +772,7 @@ public:
     typedef std::unordered_map<CString, AsmKernelId> KernelMap;
 private:
     friend class AsmStreamInputFilter;
+    friend class AsmCachedInputFilter;
     friend class AsmMacroInputFilter;
     friend class AsmForInputFilter;
     friend class AsmExpression;
@@ -604,6 +785,9 @@ private:
     friend class AsmROCmHandler;
     friend class ISAAssembler;
     friend class AsmRegAllocator;
+    friend class AsmWaitScheduler;
+    friend class AsmPhaseGuard;
+    friend class AsmCachedSession;
     
     friend struct AsmParseUtils; // INTERNAL LOGIC
     friend struct AsmPseudoOps; // INTERNAL LOGIC
@@ -628,6 +812,10 @@ private:
     ISAAssembler* isaAssembler;
     std::vector<DefSym> defSyms;
     std::vector<CString> includeDirs;
+    std::vector<CString> dependencyFiles;
+    std::vector<CString> absentDependencyFiles;
+    std::vector<std::pair<uint64_t, uint64_t> > sourceFileHashes;
+    std::vector<std::pair<uint64_t, uint64_t> > dependencyFileHashes;
     std::vector<AsmSection> sections;
     std::vector<Array<AsmSectionId> > relSpacesSections;
     std::unordered_set<AsmSymbolEntry*> symbolSnapshots;
@@ -635,7 +823,11 @@ private:
     std::vector<AsmExpression*> unevalExpressions;
     std::vector<AsmRelocation> relocations;
     std::unordered_map<const AsmRegVar*, AsmRegVarLinears> regVarLinearsMap;
+    MemoryArena symbolArena;    // symbols of scopes (freed with assembler)
     AsmScope globalScope;
+    // backward and forward symbol of local labels (by label name)
+    std::unordered_map<CString, std::pair<AsmSymbolEntry*, AsmSymbolEntry*> >
+            localLabelEntries;
     AsmMacroMap macroMap;
     std::stack<AsmScope*> scopeStack;
     std::vector<AsmScope*> abandonedScopes;
@@ -676,6 +868,12 @@ private:
     AsmSectionId& currentSection;
     uint64_t& currentOutPos;
     
+    // statistics (updated also by const methods, like writeBinary)
+    bool collectStats;
+    mutable cxuint currentPhase; // ASM_PHASES_NUM - no phase
+    mutable uint64_t phaseStartTime;
+    mutable AsmStats stats;
+    
     bool withSectionDiffs() const
     { return formatHandler!=nullptr && formatHandler->isSectionDiffsResolvable(); }
     
@@ -708,6 +906,9 @@ private:
     LineCol translatePos(size_t pos) const
     { return currentInputFilter->translatePos(pos); }
     
+    // switch to new phase and returns previous phase (time goes to previous phase)
+    cxuint switchPhase(cxuint phase) const;
+    
     bool parseLiteral(uint64_t& value, const char*& linePtr);
     bool parseLiteralNoError(uint64_t& value, const char*& linePtr);
     bool parseString(std::string& outString, const char*& linePtr);
@@ -743,6 +944,8 @@ private:
     bool putRepetitionContent(AsmRepeat& repeat);
     
     void initializeOutputFormat();
+    /// print warnings about missing and too broad waits in code sections
+    void checkWaits();
     
     bool pushClause(const char* string, AsmClauseType clauseType)
     {
@@ -789,6 +992,12 @@ private:
     
     /// returns false when includeLevel is too deep, throw error if failed a file opening
     bool includeFile(const char* pseudoOpPlace, const std::string& filename);
+    /// open input filter for file (from include cache if ASM_INCLUDECACHE enabled)
+    /** if ASM_FILEHASHES enabled, then hash of file content is added to fileHashes */
+    AsmInputFilter* openFileInputFilter(const AsmSourcePos* pos, const CString& filename,
+                std::vector<std::pair<uint64_t, uint64_t> >& fileHashes);
+    /// open source file (from include cache if ASM_INCLUDECACHE enabled)
+    AsmInputFilter* openSourceFile(const CString& filename);
     
     ParseState makeMacroSubstitution(const char* string);
     
@@ -894,6 +1103,9 @@ public:
     /// write binary to array
     void writeBinary(Array<cxbyte>& array) const;
     
+    /// clear process-wide cache of filtered include files (used by ASM_INCLUDECACHE)
+    static void clearIncludeCache();
+    
     /// get AMD driver version
     uint32_t getDriverVersion() const
     { return driverVersion; }
@@ -956,11 +1168,32 @@ public:
     /// get true if buggyFPLit enabled
     bool isBuggyFPLit() const
     { return buggyFPLit; }
+    /// get statistics (phase times are filled if ASM_STATS has been enabled)
+    const AsmStats& getStats() const
+    { return stats; }
     /// get include directory list
     const std::vector<CString>& getIncludeDirs() const
     { return includeDirs; }
     /// adds include directory
     void addIncludeDir(const CString& includeDir);
+    /// get files that has been included or read (by '.incbin') during assembling
+    const std::vector<CString>& getDependencyFiles() const
+    { return dependencyFiles; }
+    /// get paths of includes and '.incbin' files which has been tried and did not exist
+    /** these files must not exist to get this same include resolution */
+    const std::vector<CString>& getAbsentDependencyFiles() const
+    { return absentDependencyFiles; }
+    /// get hashes of content of opened source files (if ASM_FILEHASHES enabled)
+    /** hashes are in order of source files given in constructor and they are
+     * calculated from content which has been read by assembler */
+    const std::vector<std::pair<uint64_t, uint64_t> >& getSourceFileHashes() const
+    { return sourceFileHashes; }
+    /// get hashes of content of dependency files (if ASM_FILEHASHES enabled)
+    /** every hash corresponds to file from getDependencyFiles() and it is calculated
+     * from content which has been read by assembler (whole content of file for
+     * '.incbin' with regular file, otherwise read part of file) */
+    const std::vector<std::pair<uint64_t, uint64_t> >& getDependencyFileHashes() const
+    { return dependencyFileHashes; }
     /// get symbols map
     const AsmSymbolMap& getSymbolMap() const
     { return globalScope.symbolMap; }
@@ -1000,6 +1233,72 @@ public:
     { return formatHandler; }
 };
 
+/// cached assembling session
+/** Session keeps last assembler and its output binary and messages between calls
+ * of 'assemble'. Whole result is reused if content of any source file, included
+ * file or file read by '.incbin' has not been changed and if include resolution
+ * would give these same files. Content is checked against hashes of content that
+ * has been read while assembling, hence assemblers must be created with
+ * ASM_FILEHASHES flag.
+ * This is not incremental assembling: if any file has been changed, then all
+ * sources are assembled again. If assemblers are created with ASM_INCLUDECACHE flag,
+ * then only filtered lines of every unchanged source file (main or included)
+ * are reused. Sources that should be reused must be given by filenames
+ * (not by input stream). After failed assembling always assemble again.
+ */
+class AsmCachedSession: public NonCopyableAndNonMovable
+{
+public:
+    /// assembler factory (should create new assembler that prints to given stream)
+    /** assembler must be created with ASM_FILEHASHES flag */
+    typedef std::function<Assembler*(std::ostream& msgStream)> AssemblerFactory;
+private:
+    struct SourceFile
+    {
+        CString filename;
+        std::pair<uint64_t, uint64_t> hash;
+    };
+    AssemblerFactory factory;
+    std::ostream& messageStream;
+    std::ostringstream assemblerMsgStream; // must live longer than assembler
+    std::unique_ptr<Assembler> assembler;
+    std::vector<SourceFile> sourceFiles;
+    std::vector<CString> absentFiles;   // must not exist to reuse result
+    std::string messages;
+    Array<cxbyte> binary;
+    bool binaryWritten;
+    bool good;
+    bool reused;
+    
+    bool sourcesUnchanged() const;
+    void collectSourceFiles();
+public:
+    /// constructor
+    /**
+     * \param factory assembler factory
+     * \param msgStream stream for messages (also replayed messages)
+     */
+    explicit AsmCachedSession(const AssemblerFactory& factory,
+                std::ostream& msgStream = std::cerr);
+    
+    /// assemble if any source has been changed, otherwise reuse previous result
+    /** previous messages will be printed again if result has been reused
+     * \return true if assembling has been succeeded
+     */
+    bool assemble();
+    
+    /// returns true if last 'assemble' reused previous result
+    bool isReused() const
+    { return reused; }
+    
+    /// get last assembler (null if not assembled yet)
+    const Assembler* getAssembler() const
+    { return assembler.get(); }
+    
+    /// get output binary (written once for every assembling)
+    const Array<cxbyte>& getBinary();
+};
+
 inline void ISAAssembler::printWarning(const char* linePtr, const char* message)
 { assembler.printWarning(linePtr, message); }
 
@@ -30,6 +30,7 @@
 #include <vector>
 #include <utility>
 #include <memory>
+#include <functional>
 #include <CLRX/amdbin/AmdBinaries.h>
 #include <CLRX/amdbin/AmdCL2Binaries.h>
 #include <CLRX/amdbin/ROCmBinaries.h>
@@ -71,10 +72,11 @@ enum: Flags
     DISASM_CODEPOS = 0x200,   ///< print code position
     DISASM_HSACONFIG = 0x400,  ///< print HSA configuration
     DISASM_HSALAYOUT = 0x800,  ///< print in HSA layout (like Gallium or ROCm)
+    DISASM_PARALLEL = 0x1000,  ///< disassemble codes of kernels concurrently
     
     ///< all disassembler flags (without config)
     DISASM_ALL = FLAGS_ALL&(~(DISASM_CONFIG|DISASM_BUGGYFPLIT|
-                    DISASM_HSACONFIG|DISASM_HSALAYOUT))
+                    DISASM_HSACONFIG|DISASM_HSALAYOUT|DISASM_PARALLEL))
 };
 
 struct GCNDisasmUtils;
@@ -106,6 +108,7 @@ protected:
     size_t labelStartOffset; /// < start offset of labels
     size_t inputSize;   ///< size of input
     const cxbyte* input;    ///< input code
+    bool inputDecoded;  ///< true if decoded instructions match input (reset by setInput)
     bool dontPrintLabelsAfterCode;
     std::vector<size_t> labels; ///< list of local labels
     std::vector<std::pair<size_t, CString> > namedLabels;   ///< named labels
@@ -136,6 +139,7 @@ public:
     {
         this->inputSize = inputSize;
         this->input = input;
+        this->inputDecoded = false;
         this->startOffset = startOffset;
         this->labelStartOffset = labelStartOffset;
     }
@@ -187,6 +191,32 @@ public:
     /// flush output
     void flushOutput()
     { return output.flush(); }
+    
+    /// disassemble many codes concurrently
+    /** every code is disassembled by own disassembler to own output.
+     * \param isaDisassembler main ISA disassembler
+     * \param codesNum number of codes
+     * \param firstSection section number of first code (for labels)
+     * \param setupCode function that sets input and relocations for code
+     * \param outputs output for every code
+     */
+    static void disassembleCodesParallel(ISADisassembler* isaDisassembler,
+            size_t codesNum, size_t firstSection,
+            const std::function<void(size_t, ISADisassembler*)>& setupCode,
+            std::vector<std::string>& outputs);
+};
+
+/// decoded GCN instruction
+struct GCNDisasmInstr
+{
+    size_t pos;         ///< position in code (in 32-bit words)
+    uint32_t insnCode;  ///< first word of instruction
+    uint32_t insnCode2; ///< second word of instruction (or literal)
+    uint32_t tableIndex;    ///< index in instruction table (by code)
+    uint32_t wordsNum;  ///< number of words (number of zeroes for zero words)
+    uint16_t opcode;    ///< opcode
+    cxbyte encoding;    ///< GCN encoding (GCNENC_NONE if illegal or zero words)
+    bool isIllegal;     ///< true if instruction is illegal
 };
 
 /// GCN architectur dissassembler
@@ -194,6 +224,7 @@ class GCNDisassembler: public ISADisassembler
 {
 private:
     bool instrOutOfCode;
+    std::vector<GCNDisasmInstr> instrs;
     
     friend struct GCNDisasmUtils; // INTERNAL LOGIC
 public:
@@ -202,6 +233,13 @@ public:
     /// destructor
     ~GCNDisassembler();
     
+    /// decode instructions from input code
+    /** returns true if last instruction is not finished */
+    bool decodeInstructions();
+    /// get decoded instructions (after decodeInstructions)
+    const std::vector<GCNDisasmInstr>& getDecodedInstrs() const
+    { return instrs; }
+    
     /// analyze code before disassemblying
     void analyzeBeforeDisassemble();
     /// disassemble code
@@ -384,6 +422,7 @@ private:
     std::ostream& output;
     Flags flags;
     size_t sectionCount;
+    cxuint threadsNum;
 public:
     /// constructor for 32-bit GPU binary
     /**
@@ -487,6 +526,13 @@ public:
     void setFlags(Flags flags)
     { this->flags = flags; }
     
+    /// get threads number used by parallel disassembling (0 - all hardware threads)
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    /// set threads number used by parallel disassembling (0 - all hardware threads)
+    void setThreadsNum(cxuint threadsNum)
+    { this->threadsNum = threadsNum; }
+    
     /// get deviceType
     GPUDeviceType getDeviceType() const;
     
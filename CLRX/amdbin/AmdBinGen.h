@@ -208,6 +208,7 @@ class AmdGPUBinGenerator: public NonCopyableAndNonMovable
 private:
     bool manageable;
     const AmdInput* input;
+    cxuint threadsNum;
     
     void generateInternal(std::ostream* osPtr, std::vector<char>* vPtr,
              Array<cxbyte>* aPtr) const;
@@ -241,6 +242,14 @@ public:
     /// set input
     void setInput(const AmdInput* input);
     
+    /// get threads number used to generate inner binaries
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    /// set threads number used to generate inner binaries
+    /** 1 - serial generation (default), 0 - all hardware threads */
+    void setThreadsNum(cxuint threadsNum)
+    { this->threadsNum = threadsNum; }
+    
     /// generates binary
     void generate(Array<cxbyte>& array) const;
     
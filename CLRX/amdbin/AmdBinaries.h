@@ -61,6 +61,8 @@ enum : Flags {
     AMDBIN_INNER_CREATE_CALNOTES = 0x10000, ///< create CAL notes for AMD inner GPU binary
     
     AMDBIN_CREATE_ALL = ELF_CREATE_ALL | 0xffff0, ///< all AMD binaries creation flags
+    /// parse inner binaries and kernel infos when they are accessed first time
+    AMDBIN_CREATE_LAZY = 0x100000,
     AMDBIN_INNER_SHIFT = 12 ///< shift for convert inner binary flags into elf binary flags
 };
 
@@ -419,12 +421,19 @@ protected:
     AmdMainType type;   ///< type of binaries
     Array<KernelInfo> kernelInfos;    ///< kernel informations
     KernelInfoMap kernelInfosMap;   ///< kernel informations map
+    /// once flags for kernel informations (only if they are parsed lazily)
+    std::unique_ptr<OnceFlag[]> kernelInfoOnceFlags;
     
     CString driverInfo; ///< driver info string
     CString compileOptions; ///< compiler options string
     
     /// constructor
     explicit AmdMainBinaryBase(AmdMainType type);
+    
+    /// parse kernel information with specified index (used by lazy parsing)
+    virtual void parseKernelInfo(size_t index);
+    /// parse kernel information if it is not yet parsed (only lazy parsing)
+    void loadKernelInfo(size_t index) const;
 public:
     virtual ~AmdMainBinaryBase();
     
@@ -438,11 +447,24 @@ public:
     
     /// get kernel informations array
     const KernelInfo* getKernelInfos() const
-    { return kernelInfos.data(); }
+    {
+        if (kernelInfoOnceFlags)
+            for (size_t i = 0; i < kernelInfos.size(); i++)
+                loadKernelInfo(i);
+        return kernelInfos.data();
+    }
     
     /// get kernel information with specified index
     const KernelInfo& getKernelInfo(size_t index) const
-    { return kernelInfos[index]; }
+    {
+        if (kernelInfoOnceFlags)
+            loadKernelInfo(index);
+        return kernelInfos[index];
+    }
+    
+    /// get kernel name with specified index (does not parse kernel information)
+    const CString& getKernelName(size_t index) const
+    { return kernelInfos[index].kernelName; }
     
     /// get kernel information with specified kernel name (requires kernel info map)
     const KernelInfo& getKernelInfo(const char* name) const;
@@ -471,6 +493,14 @@ struct AmdGPUKernelHeader
     cxbyte* data;   ///< data
 };
 
+/// AMD GPU inner binary region in main binary (used by lazy parsing)
+struct AmdGPUInnerBinaryRegion
+{
+    CString kernelName; ///< kernel name
+    size_t size;    ///< size
+    cxbyte* data;   ///< data
+};
+
 /// main AMD GPU binary base class
 class AmdMainGPUBinaryBase: public AmdMainBinaryBase
 {
@@ -482,6 +512,11 @@ public:
 protected:
     Array<AmdInnerGPUBinary32> innerBinaries;   ///< inner binaries
     InnerBinaryMap innerBinaryMap;  ///< inner binary map
+    /// inner binary regions (only if inner binaries are parsed lazily)
+    Array<AmdGPUInnerBinaryRegion> innerBinaryRegions;
+    /// once flags for inner binaries (only if inner binaries are parsed lazily)
+    std::unique_ptr<OnceFlag[]> innerBinaryOnceFlags;
+    Flags innerBinaryFlags; ///< creation flags for inner binaries
     std::unique_ptr<AmdGPUKernelMetadata[]> metadatas;  ///< AMD metadatas
     Array<AmdGPUKernelHeader> kernelHeaders;    ///< kernel headers
     KernelHeaderMap kernelHeaderMap;    ///< kernel header map
@@ -494,6 +529,11 @@ protected:
     /// initialize main gpu binary (internal use only)
     template<typename Types>
     void initMainGPUBinary(typename Types::ElfBinary& binary);
+    
+    /// parse kernel information with specified index (used by lazy parsing)
+    void parseKernelInfo(size_t index);
+    /// parse inner binary if it is not yet parsed (only lazy parsing)
+    void loadInnerBinary(size_t index) const;
 public:
     /// get number of inner binaries
     size_t getInnerBinariesNum() const
@@ -501,11 +541,19 @@ public:
     
     /// get inner binary with specified index
     AmdInnerGPUBinary32& getInnerBinary(size_t index)
-    { return innerBinaries[index]; }
+    {
+        if (innerBinaryOnceFlags)
+            loadInnerBinary(index);
+        return innerBinaries[index];
+    }
     
     /// get inner binary with specified index
     const AmdInnerGPUBinary32& getInnerBinary(size_t index) const
-    { return innerBinaries[index]; }
+    {
+        if (innerBinaryOnceFlags)
+            loadInnerBinary(index);
+        return innerBinaries[index];
+    }
     
     /// get inner binary with specified name (requires inner binary map)
     const AmdInnerGPUBinary32& getInnerBinary(const char* name) const;
@@ -70,7 +70,9 @@ enum : Flags {
     ELF_CREATE_SECTIONMAP = 1,  ///< create map of sections
     ELF_CREATE_SYMBOLMAP = 2,   ///< create map of symbols
     ELF_CREATE_DYNSYMMAP = 4,   ///< create map of dynamic symbols
-    ELF_CREATE_ALL = 0xf  ///< creation flags for ELF binaries
+    ELF_CREATE_ALL = 0xf,  ///< creation flags for ELF binaries
+    /// use hash index instead sorting of maps (opt-in, not included in ELF_CREATE_ALL)
+    ELF_CREATE_HASHINDEX = 0x80000000U
 };
 
 /// Bin exception class
@@ -165,6 +167,9 @@ protected:
     SectionIndexMap sectionIndexMap;    ///< section's index map
     SymbolIndexMap symbolIndexMap;      ///< symbol's index map
     SymbolIndexMap dynSymIndexMap;      ///< dynamic symbol's index map
+    Array<size_t> sectionHashIndex;  ///< hash index of section's map
+    Array<size_t> symbolHashIndex;   ///< hash index of symbol's map
+    Array<size_t> dynSymHashIndex;   ///< hash index of dynamic symbol's map
     
     typename Types::Size symbolsNum;    ///< symbols number
     typename Types::Size dynSymbolsNum; ///< dynamic symbols number
@@ -174,6 +179,22 @@ protected:
     uint16_t dynSymEntSize; ///< dynamic symbol entry size in a dynamic symbol's table
     typename Types::Size dynamicEntSize; ///< get dynamic entry size
     
+    /// build hash index for index map (called in constructor)
+    static void buildHashIndex(const SectionIndexMap& indexMap, Array<size_t>& hashIndex);
+    
+    /// find name in index map through hash index
+    static SectionIndexMap::const_iterator findInHashIndex(
+            const SectionIndexMap& indexMap, const Array<size_t>& hashIndex,
+            const char* name);
+    
+    /// find name in index map (uses hash index if ELF_CREATE_HASHINDEX is set)
+    SectionIndexMap::const_iterator findInIndexMap(const SectionIndexMap& indexMap,
+            const Array<size_t>& hashIndex, const char* name) const
+    {
+        if ((creationFlags & ELF_CREATE_HASHINDEX) != 0)
+            return findInHashIndex(indexMap, hashIndex, name);
+        return binaryMapFind(indexMap.begin(), indexMap.end(), name, CStringLess());
+    }
 public:
     ElfBinaryTemplate();
     /** constructor.
@@ -201,6 +222,10 @@ public:
     bool hasDynSymbolMap() const
     { return (creationFlags & ELF_CREATE_DYNSYMMAP) != 0; }
     
+    /// returns true if names in index maps are found through hash index
+    bool hasHashIndex() const
+    { return (creationFlags & ELF_CREATE_HASHINDEX) != 0; }
+    
     /// get size of binaries
     size_t getSize() const
     { return binaryCodeSize; }
@@ -332,8 +357,7 @@ public:
     /// get section iterator with specified name (requires section index map)
     SectionIndexMap::const_iterator getSectionIter(const char* name) const
     {
-        SectionIndexMap::const_iterator it = binaryMapFind(
-                    sectionIndexMap.begin(), sectionIndexMap.end(), name, CStringLess());
+        SectionIndexMap::const_iterator it = findInIndexMap(sectionIndexMap, sectionHashIndex, name);
         if (it == sectionIndexMap.end())
             throw BinException(std::string("Can't find Elf")+Types::bitName+" Section");
         return it;
@@ -359,8 +383,7 @@ public:
     /// get symbol iterator with specified name (requires symbol index map)
     SymbolIndexMap::const_iterator getSymbolIter(const char* name) const
     {
-        SymbolIndexMap::const_iterator it = binaryMapFind(
-                    symbolIndexMap.begin(), symbolIndexMap.end(), name, CStringLess());
+        SymbolIndexMap::const_iterator it = findInIndexMap(symbolIndexMap, symbolHashIndex, name);
         if (it == symbolIndexMap.end())
             throw BinException(std::string("Can't find Elf")+Types::bitName+" Symbol");
         return it;
@@ -369,8 +392,7 @@ public:
     /// get dynamic symbol iterator with specified name (requires dynamic symbol index map)
     SymbolIndexMap::const_iterator getDynSymbolIter(const char* name) const
     {
-        SymbolIndexMap::const_iterator it = binaryMapFind(
-                    dynSymIndexMap.begin(), dynSymIndexMap.end(), name, CStringLess());
+        SymbolIndexMap::const_iterator it = findInIndexMap(dynSymIndexMap, dynSymHashIndex, name);
         if (it == dynSymIndexMap.end())
             throw BinException(std::string("Can't find Elf")+Types::bitName+" DynSymbol");
         return it;
@@ -844,7 +866,14 @@ private:
     uint32_t bucketsNum;
     std::unique_ptr<uint32_t[]> hashCodes;
     bool isHashDynSym;
-    
+    // layout of string tables (computed with size, reused while generating)
+    std::unique_ptr<uint32_t[]> symNameSizes;   // with null char, 0 if empty name
+    std::unique_ptr<uint32_t[]> dynSymNameSizes;
+    std::unique_ptr<uint32_t[]> sectionNameSizes;   // for regions
+    uint64_t strTabSize, dynStrSize, shStrTabSize;
+    cxuint symLastLocal, dynSymLastLocal;
+    
+    void computeStrTabLayout();
     void computeSize();
 public:
     ElfBinaryGenTemplate();
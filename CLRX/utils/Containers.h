@@ -31,6 +31,8 @@
 #include <utility>
 #include <unordered_map>
 #include <initializer_list>
+#include <new>
+#include <type_traits>
 
 /// main namespace
 namespace CLRX
@@ -610,6 +612,143 @@ public:
     }
 };
 
+/** Memory arena **/
+
+/// memory arena for small objects (all memory is freed in bulk at destruction)
+/** Objects are allocated from big chunks. Freed objects are kept in free lists
+ * (separately for every size) and they are reused by next allocations.
+ */
+class MemoryArena
+{
+private:
+    static const size_t chunkSize = 65536;
+    static const size_t unitSize = 16;
+    static const size_t maxObjectSize = 512;
+    
+    std::vector<char*> chunks;
+    char* chunkPos;
+    size_t chunkFree;
+    void* freeLists[maxObjectSize/unitSize];
+    
+    static size_t unitsNum(size_t size)
+    { return (size + unitSize-1) / unitSize; }
+public:
+    /// constructor
+    MemoryArena() : chunkPos(nullptr), chunkFree(0)
+    { std::fill(freeLists, freeLists + maxObjectSize/unitSize, nullptr); }
+    /// destructor
+    ~MemoryArena()
+    {
+        for (char* chunk: chunks)
+            delete[] chunk;
+    }
+    
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+    
+    /// allocate memory for object
+    void* allocate(size_t size)
+    {
+        const size_t units = unitsNum(size);
+        if (units == 0 || units > maxObjectSize/unitSize)
+            return ::operator new(size);
+        void*& freeList = freeLists[units-1];
+        if (freeList != nullptr)
+        {
+            // reuse freed object
+            void* ptr = freeList;
+            freeList = *reinterpret_cast<void**>(ptr);
+            return ptr;
+        }
+        const size_t bytes = units*unitSize;
+        if (chunkFree < bytes)
+        {
+            chunks.push_back(new char[chunkSize]);
+            chunkPos = chunks.back();
+            chunkFree = chunkSize;
+        }
+        void* ptr = chunkPos;
+        chunkPos += bytes;
+        chunkFree -= bytes;
+        return ptr;
+    }
+    
+    /// free memory of object (put to free list)
+    void deallocate(void* ptr, size_t size)
+    {
+        const size_t units = unitsNum(size);
+        if (units == 0 || units > maxObjectSize/unitSize)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        *reinterpret_cast<void**>(ptr) = freeLists[units-1];
+        freeLists[units-1] = ptr;
+    }
+    
+    /// get number of allocated chunks
+    size_t getChunksNum() const
+    { return chunks.size(); }
+};
+
+/// allocator that allocates single objects in memory arena
+/** If arena is not set then it uses standard heap.
+ * Arrays (for example, hash table buckets) are always allocated in standard heap.
+ * Copy of container gets allocator without arena.
+ */
+template<typename T>
+class ArenaAllocator
+{
+private:
+    template<typename U> friend class ArenaAllocator;
+    MemoryArena* arena;
+public:
+    typedef T value_type;   ///< value type
+    typedef std::true_type propagate_on_container_move_assignment;  ///< propagate on move
+    typedef std::true_type propagate_on_container_swap; ///< propagate on swap
+    
+    /// constructor
+    ArenaAllocator(MemoryArena* _arena = nullptr) : arena(_arena)
+    { }
+    /// constructor from other allocator
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena)
+    { }
+    
+    /// get arena
+    MemoryArena* getArena() const
+    { return arena; }
+    
+    /// allocate n objects
+    T* allocate(size_t n)
+    {
+        if (arena != nullptr && n == 1)
+            return reinterpret_cast<T*>(arena->allocate(sizeof(T)));
+        return reinterpret_cast<T*>(::operator new(n*sizeof(T)));
+    }
+    /// deallocate n objects
+    void deallocate(T* ptr, size_t n)
+    {
+        if (arena != nullptr && n == 1)
+            arena->deallocate(ptr, sizeof(T));
+        else
+            ::operator delete(ptr);
+    }
+    
+    /// copy of container should not use arena (it can live longer than arena)
+    ArenaAllocator select_on_container_copy_construction() const
+    { return ArenaAllocator(); }
+    
+    /// equality operator
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const
+    { return arena == other.arena; }
+    /// inequality operator
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const
+    { return arena != other.arena; }
+};
+
 };
 
 namespace std
@@ -135,6 +135,46 @@ protected:
     std::streambuf* setbuf(char_type* buffer, std::streamsize size);
 };
 
+class FastOutputBuffer;
+
+/// output stream buffer that gathers output as list of segments (scatter/gather)
+/** Written data is copied into held buffer, but external data (added by addExternal)
+ * is only referenced and it must be valid until gathered output will be written out.
+ */
+class GatherStreamBuf: public std::streambuf
+{
+private:
+    struct Segment
+    {
+        const char* external;   // null if segment is in held buffer
+        size_t offset;  // offset in held buffer
+        size_t size;
+    };
+    std::vector<char> data;
+    std::vector<Segment> segments;
+    uint64_t size;
+public:
+    /// constructor
+    GatherStreamBuf();
+    /// destructor
+    ~GatherStreamBuf() = default;
+    
+    /// add reference to external data (without copying)
+    void addExternal(size_t length, const char* external);
+    
+    /// get size of gathered output
+    uint64_t getSize() const
+    { return size; }
+    
+    /// write out gathered output
+    void writeTo(FastOutputBuffer& fob) const;
+protected:
+    /// overflow implementation
+    int_type overflow(int_type ch);
+    /// xsputn implementation
+    std::streamsize xsputn(const char_type* s, std::streamsize n);
+};
+
 /// specialized input stream that holds external array for memory saving
 class ArrayIStream: public std::istream
 {
@@ -288,6 +328,28 @@ public:
     { return buffer.getVector(); }
 };
 
+/// output stream that gathers output as list of segments (scatter/gather)
+class GatherOStream: public std::ostream
+{
+private:
+    GatherStreamBuf buffer;
+public:
+    /// constructor
+    GatherOStream();
+    /// destructor
+    ~GatherOStream() = default;
+    
+    /// get gathering stream buffer
+    GatherStreamBuf& getGatherBuf()
+    { return buffer; }
+    /// get size of gathered output
+    uint64_t getSize() const
+    { return buffer.getSize(); }
+    /// write out gathered output
+    void writeTo(FastOutputBuffer& fob) const
+    { buffer.writeTo(fob); }
+};
+
 /*
  * adaptor
  */
@@ -355,6 +417,7 @@ private:
     cxuint bufSize;
     std::unique_ptr<char[]> buffer;
     uint64_t written;
+    GatherStreamBuf* gatherBuf;
 public:
     /// constructor with inBufSize and output
     /**
@@ -362,7 +425,16 @@ public:
      * \param output output stream
      */
     FastOutputBuffer(cxuint _bufSize, std::ostream& output) : os(output), endPos(0),
-            bufSize(_bufSize), buffer(new char[_bufSize]), written(0)
+            bufSize(_bufSize), buffer(new char[_bufSize]), written(0), gatherBuf(nullptr)
+    { }
+    /// constructor with inBufSize and gathering output
+    /**
+     * \param _bufSize max buffer size
+     * \param output gathering output stream
+     */
+    FastOutputBuffer(cxuint _bufSize, GatherOStream& output) : os(output), endPos(0),
+            bufSize(_bufSize), buffer(new char[_bufSize]), written(0),
+            gatherBuf(&output.getGatherBuf())
     { }
     /// destructor
     ~FastOutputBuffer()
@@ -413,6 +485,26 @@ public:
         written += length;
     }
     
+    /// write data from external memory
+    /** if output is gathering stream, then data is only referenced (not copied),
+     * hence it must be valid until gathered output will be written out */
+    void writeExternal(size_t length, const char* data)
+    {
+        if (gatherBuf == nullptr || length <= bufSize-endPos)
+            write(length, data);
+        else
+        {
+            flush();
+            gatherBuf->addExternal(length, data);
+            written += length;
+        }
+    }
+    
+    /// write array of objects from external memory (see writeExternal)
+    template<typename T>
+    void writeExternalArray(size_t size, const T* t)
+    { writeExternal(sizeof(T)*size, reinterpret_cast<const char*>(t)); }
+    
     /// write string
     void writeString(const char* string)
     { write(::strlen(string), string); }
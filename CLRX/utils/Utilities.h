@@ -32,6 +32,7 @@
 #include <cstdint>
 #include <mutex>
 #include <atomic>
+#include <functional>
 #ifdef _MSC_VER
 #include <intrin.h>
 #endif
@@ -349,6 +350,25 @@ struct CStringHash
     }
 };
 
+/// calculate 128-bit hash of data (non-cryptographic, MurmurHash3 x64 variant)
+/**
+ * \param size size of data in bytes
+ * \param data data
+ * \param seed initial seed
+ * \return hash as pair of 64-bit words
+ */
+extern std::pair<uint64_t, uint64_t> calculateHash128(size_t size, const void* data,
+            uint64_t seed = 0);
+
+/// calculate 32-bit hash of null-terminated string (FNV-1a)
+inline uint32_t calculateFNV1aHash(const char* str)
+{
+    uint32_t hash = 2166136261U;
+    for (; *str != 0; str++)
+        hash = (hash ^ cxbyte(*str)) * 16777619U;
+    return hash;
+}
+
 /// counts leading zeroes for 32-bit unsigned integer. For zero behavior is undefined
 inline cxuint CLZ32(uint32_t v);
 /// counts leading zeroes for 64-bit unsigned integer. For zero behavior is undefined
@@ -778,6 +798,48 @@ extern bool isFileExists(const char* path);
  */
 extern Array<cxbyte> loadDataFromFile(const char* filename);
 
+/// memory-mapped file (private mapping, changes are not written to file)
+/** Content of the file is mapped to memory without copying, hence binary classes can
+ * parse it in place. Pages are copied only if they are modified.
+ * If file can not be mapped (pipe or device) then content is loaded to memory
+ * like in loadDataFromFile. */
+class MappedFile: public NonCopyableAndNonMovable
+{
+private:
+    cxbyte* content;
+    size_t contentSize;
+    bool mapped;
+    Array<cxbyte> loadedContent;
+public:
+    /// empty constructor
+    MappedFile();
+    /** constructor - maps file
+     * \param filename filename
+     */
+    explicit MappedFile(const char* filename);
+    ~MappedFile();
+    
+    /** maps file (or loads if file can not be mapped)
+     * \param filename filename
+     */
+    void open(const char* filename);
+    /// unmap file
+    void close();
+    
+    /// get content of file
+    cxbyte* data()
+    { return content; }
+    /// get content of file
+    const cxbyte* data() const
+    { return content; }
+    /// get size of content
+    size_t size() const
+    { return contentSize; }
+    /// returns true if file is mapped (not loaded to memory)
+    bool isMapped() const
+    { return mapped; }
+};
+
 /// convert to filesystem from unified path (with slashes)
 extern void filesystemPath(char* path);
 /// convert to filesystem from unified path (with slashes)
@@ -1062,6 +1124,23 @@ inline void callOnce(OnceFlag& flag, Callable&& f, Args&&... args)
 }
 #endif
 
+/* parallel jobs */
+
+/// get number of hardware threads (at least one)
+extern cxuint getHardwareThreadsNum();
+
+/// run jobs in parallel
+/** call job routine for every job index from 0 to jobsNum-1 in a pool of threads.
+ * The caller thread also executes jobs. Jobs are picked in order of indices.
+ * If any job throws exception, then remaining jobs will not be started and
+ * first exception will be rethrown after finishing all threads.
+ * \param jobsNum number of jobs
+ * \param threadsNum maximal number of threads (if zero then number of hardware threads)
+ * \param job job routine (called with job index)
+ */
+extern void runParallelJobs(size_t jobsNum, cxuint threadsNum,
+            const std::function<void(size_t)>& job);
+
 };
 
 #endif
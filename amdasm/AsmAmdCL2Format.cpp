@@ -35,84 +35,12 @@
 
 using namespace CLRX;
 
-// all AmdCL2 pseudo-op names (sorted)
-static const char* amdCL2PseudoOpNamesTbl[] =
-{
-    "acl_version", "arch_minor", "arch_stepping",
-    "arg", "bssdata", "call_convention", "codeversion",
-    "compile_options", "config", "control_directive",
-    "cws", "debug_private_segment_buffer_sgpr",
-    "debug_wavefront_private_segment_offset_sgpr",
-    "debugmode", "default_hsa_features",
-    "dims", "driver_version", "dx10clamp", "exceptions",
-    "floatmode", "gds_segment_size", "gdssize", "get_driver_version",
-    "globaldata", "group_segment_align",
-    "hsaconfig", "hsalayout", "ieeemode", "inner",
-    "isametadata", "kcode", "kcodeend", "kernarg_segment_align",
-    "kernarg_segment_size", "kernel_code_entry_offset",
-    "kernel_code_prefetch_offset", "kernel_code_prefetch_size",
-    "localsize", "machine", "max_scratch_backing_memory",
-    "metadata", "pgmrsrc1", "pgmrsrc2", "priority",
-    "private_elem_size", "private_segment_align",
-    "privmode", "reqd_work_group_size",
-    "reserved_sgprs", "reserved_vgprs",
-    "runtime_loader_kernel_symbol", "rwdata", "sampler",
-    "samplerinit", "samplerreloc", "scratchbuffer", "setup",
-    "setupargs", "sgprsnum", "stub", "tgsize",
-    "use_debug_enabled", "use_dispatch_id",
-    "use_dispatch_ptr", "use_dynamic_call_stack",
-    "use_flat_scratch_init", "use_grid_workgroup_count",
-    "use_kernarg_segment_ptr", "use_ordered_append_gds",
-    "use_private_segment_buffer", "use_private_segment_size",
-    "use_ptr64", "use_queue_ptr", "use_xnack_enabled",
-    "useargs", "useenqueue", "usegeneric",
-    "userdatanum", "usesetup", "vectypehint", "vgprsnum",
-    "wavefront_sgpr_count", "wavefront_size",
-    "work_group_size_hint", "workgroup_fbarrier_count",
-    "workgroup_group_segment_size", "workitem_private_segment_size",
-    "workitem_vgpr_count"
-};
-
-// all enums for AmdCL2 pseudo-ops
+// all enums for AmdCL2 pseudo-ops (list in AsmAmdCL2PseudoOps.inc)
 enum
 {
-    AMDCL2OP_ACL_VERSION = 0, AMDCL2OP_ARCH_MINOR, AMDCL2OP_ARCH_STEPPING,
-    AMDCL2OP_ARG, AMDCL2OP_BSSDATA, AMDCL2OP_CALL_CONVENTION, AMDCL2OP_CODEVERSION, 
-    AMDCL2OP_COMPILE_OPTIONS, AMDCL2OP_CONFIG, AMDCL2OP_CONTROL_DIRECTIVE,
-    AMDCL2OP_CWS, AMDCL2OP_DEBUG_PRIVATE_SEGMENT_BUFFER_SGPR,
-    AMDCL2OP_DEBUG_WAVEFRONT_PRIVATE_SEGMENT_OFFSET_SGPR,
-    AMDCL2OP_DEBUGMODE, AMDCL2OP_DEFAULT_HSA_FEATURES,
-    AMDCL2OP_DIMS, AMDCL2OP_DRIVER_VERSION, AMDCL2OP_DX10CLAMP, AMDCL2OP_EXCEPTIONS,
-    AMDCL2OP_FLOATMODE, AMDCL2OP_GDS_SEGMENT_SIZE,
-    AMDCL2OP_GDSSIZE, AMDCL2OP_GET_DRIVER_VERSION,
-    AMDCL2OP_GLOBALDATA, AMDCL2OP_GROUP_SEGMENT_ALIGN,
-    AMDCL2OP_HSACONFIG, AMDCL2OP_HSALAYOUT, AMDCL2OP_IEEEMODE, AMDCL2OP_INNER,
-    AMDCL2OP_ISAMETADATA, AMDCL2OP_KCODE, AMDCL2OP_KCODEEND,
-    AMDCL2OP_KERNARG_SEGMENT_ALIGN,
-    AMDCL2OP_KERNARG_SEGMENT_SIZE, AMDCL2OP_KERNEL_CODE_ENTRY_OFFSET,
-    AMDCL2OP_KERNEL_CODE_PREFETCH_OFFSET,
-    AMDCL2OP_KERNEL_CODE_PREFETCH_SIZE, AMDCL2OP_LOCALSIZE,
-    AMDCL2OP_MACHINE, AMDCL2OP_MAX_SCRATCH_BACKING_MEMORY,
-    AMDCL2OP_METADATA, AMDCL2OP_PGMRSRC1, AMDCL2OP_PGMRSRC2, AMDCL2OP_PRIORITY,
-    AMDCL2OP_PRIVATE_ELEM_SIZE, AMDCL2OP_PRIVATE_SEGMENT_ALIGN,
-    AMDCL2OP_PRIVMODE, AMDCL2OP_REQD_WORK_GROUP_SIZE,
-    AMDCL2OP_RESERVED_SGPRS, AMDCL2OP_RESERVED_VGPRS,
-    AMDCL2OP_RUNTIME_LOADER_KERNEL_SYMBOL, AMDCL2OP_RWDATA,
-    AMDCL2OP_SAMPLER, AMDCL2OP_SAMPLERINIT,
-    AMDCL2OP_SAMPLERRELOC, AMDCL2OP_SCRATCHBUFFER, AMDCL2OP_SETUP, AMDCL2OP_SETUPARGS,
-    AMDCL2OP_SGPRSNUM, AMDCL2OP_STUB, AMDCL2OP_TGSIZE,
-    AMDCL2OP_USE_DEBUG_ENABLED, AMDCL2OP_USE_DISPATCH_ID,
-    AMDCL2OP_USE_DISPATCH_PTR, AMDCL2OP_USE_DYNAMIC_CALL_STACK,
-    AMDCL2OP_USE_FLAT_SCRATCH_INIT, AMDCL2OP_USE_GRID_WORKGROUP_COUNT,
-    AMDCL2OP_USE_KERNARG_SEGMENT_PTR, AMDCL2OP_USE_ORDERED_APPEND_GDS,
-    AMDCL2OP_USE_PRIVATE_SEGMENT_BUFFER, AMDCL2OP_USE_PRIVATE_SEGMENT_SIZE,
-    AMDCL2OP_USE_PTR64, AMDCL2OP_USE_QUEUE_PTR, AMDCL2OP_USE_XNACK_ENABLED,
-    AMDCL2OP_USEARGS, AMDCL2OP_USEENQUEUE, AMDCL2OP_USEGENERIC,
-    AMDCL2OP_USERDATANUM, AMDCL2OP_USESETUP, AMDCL2OP_VECTYPEHINT, AMDCL2OP_VGPRSNUM,
-    AMDCL2OP_WAVEFRONT_SGPR_COUNT, AMDCL2OP_WAVEFRONT_SIZE,
-    AMDCL2OP_WORK_GROUP_SIZE_HINT,
-    AMDCL2OP_WORKGROUP_FBARRIER_COUNT, AMDCL2OP_WORKGROUP_GROUP_SEGMENT_SIZE,
-    AMDCL2OP_WORKITEM_PRIVATE_SEGMENT_SIZE, AMDCL2OP_WORKITEM_VGPR_COUNT
+#define ASM_PSEUDO_OP(enumName, name) enumName,
+#include "AsmAmdCL2PseudoOps.inc"
+#undef ASM_PSEUDO_OP
 };
 
 void AsmAmdCL2Handler::Kernel::initializeKernelConfig()
@@ -448,12 +376,8 @@ namespace CLRX
 
 bool AsmAmdCL2PseudoOps::checkPseudoOpName(const CString& string)
 {
-    if (string.empty() || string[0] != '.')
-        return false;
-    const size_t pseudoOp = binaryFind(amdCL2PseudoOpNamesTbl, amdCL2PseudoOpNamesTbl +
-                sizeof(amdCL2PseudoOpNamesTbl)/sizeof(char*), string.c_str()+1,
-               CStringLess()) - amdCL2PseudoOpNamesTbl;
-    return pseudoOp < sizeof(amdCL2PseudoOpNamesTbl)/sizeof(char*);
+    const AsmPseudoOpHashEntry* entry = findAsmPseudoOp(string);
+    return entry != nullptr && entry->indices[ASMPOTBL_AMDCL2] != UINT16_MAX;
 }
 
 void AsmAmdCL2PseudoOps::setAclVersion(AsmAmdCL2Handler& handler, const char* linePtr)
@@ -1493,9 +1417,7 @@ void AsmAmdCL2PseudoOps::doHSALayout(AsmAmdCL2Handler& handler, const char* pseu
 bool AsmAmdCL2Handler::parsePseudoOp(const CString& firstName,
        const char* stmtPlace, const char* linePtr)
 {
-    const size_t pseudoOp = binaryFind(amdCL2PseudoOpNamesTbl, amdCL2PseudoOpNamesTbl +
-                    sizeof(amdCL2PseudoOpNamesTbl)/sizeof(char*), firstName.c_str()+1,
-                   CStringLess()) - amdCL2PseudoOpNamesTbl;
+    const size_t pseudoOp = getAsmPseudoOpIndex(firstName, ASMPOTBL_AMDCL2);
     
     switch(pseudoOp)
     {
@@ -31,43 +31,12 @@
 
 using namespace CLRX;
 
-// all AMD Catalyst pseudo-op names (sorted)
-static const char* amdPseudoOpNamesTbl[] =
-{
-    "arg", "boolconsts", "calnote", "cbid",
-    "cbmask", "compile_options", "condout", "config",
-    "constantbuffers", "cws", "dims", "driver_info", "driver_version",
-    "earlyexit", "entry", "exceptions",
-    "floatconsts", "floatmode", "get_driver_version",
-    "globalbuffers", "globaldata", "header", "hwlocal",
-    "hwregion", "ieeemode", "inputs", "inputsamplers",
-    "intconsts", "localsize", "metadata", "outputs", "persistentbuffers",
-    "pgmrsrc2", "printfid", "privateid", "proginfo",
-    "reqd_work_group_size",
-    "sampler", "scratchbuffer", "scratchbuffers", "segment",
-    "sgprsnum", "subconstantbuffers", "tgsize", "uav", "uavid",
-    "uavmailboxsize", "uavopmask", "uavprivate", "useconstdata",
-    "useprintf", "userdata", "vgprsnum"
-};
-
-// all AMD Catalyst pseudo-op names (sorted)
+// all enums for AMD Catalyst pseudo-ops (list in AsmAmdPseudoOps.inc)
 enum
 {
-    AMDOP_ARG = 0, AMDOP_BOOLCONSTS, AMDOP_CALNOTE, AMDOP_CBID,
-    AMDOP_CBMASK, AMDOP_COMPILE_OPTIONS, AMDOP_CONDOUT, AMDOP_CONFIG,
-    AMDOP_CONSTANTBUFFERS, AMDOP_CWS, AMDOP_DIMS, AMDOP_DRIVER_INFO, AMDOP_DRIVER_VERSION,
-    AMDOP_EARLYEXIT, AMDOP_ENTRY, AMDOP_EXCEPTIONS,
-    AMDOP_FLOATCONSTS, AMDOP_FLOATMODE, AMDOP_GETDRVVER,
-    AMDOP_GLOBALBUFFERS, AMDOP_GLOBALDATA, AMDOP_HEADER, AMDOP_HWLOCAL,
-    AMDOP_HWREGION, AMDOP_IEEEMODE, AMDOP_INPUTS, AMDOP_INPUTSAMPLERS,
-    AMDOP_INTCONSTS, AMDOP_LOCALSIZE, AMDOP_METADATA,
-    AMDOP_OUTPUTS,AMDOP_PERSISTENTBUFFERS, AMDOP_PGMRSRC2,
-    AMDOP_PRINTFID, AMDOP_PRIVATEID, AMDOP_PROGINFO,
-    AMDOP_REQD_WORK_GROUP_SIZE,
-    AMDOP_SAMPLER, AMDOP_SCRATCHBUFFER, AMDOP_SCRATCHBUFFERS, AMDOP_SEGMENT,
-    AMDOP_SGPRSNUM, AMDOP_SUBCONSTANTBUFFERS, AMDOP_TGSIZE, AMDOP_UAV, AMDOP_UAVID,
-    AMDOP_UAVMAILBOXSIZE, AMDOP_UAVOPMASK, AMDOP_UAVPRIVATE, AMDOP_USECONSTDATA,
-    AMDOP_USEPRINTF, AMDOP_USERDATA, AMDOP_VGPRSNUM
+#define ASM_PSEUDO_OP(enumName, name) enumName,
+#include "AsmAmdPseudoOps.inc"
+#undef ASM_PSEUDO_OP
 };
 
 /*
@@ -288,12 +257,8 @@ namespace CLRX
 
 bool AsmAmdPseudoOps::checkPseudoOpName(const CString& string)
 {
-    if (string.empty() || string[0] != '.')
-        return false;
-    const size_t pseudoOp = binaryFind(amdPseudoOpNamesTbl, amdPseudoOpNamesTbl +
-                sizeof(amdPseudoOpNamesTbl)/sizeof(char*), string.c_str()+1,
-               CStringLess()) - amdPseudoOpNamesTbl;
-    return pseudoOp < sizeof(amdPseudoOpNamesTbl)/sizeof(char*);
+    const AsmPseudoOpHashEntry* entry = findAsmPseudoOp(string);
+    return entry != nullptr && entry->indices[ASMPOTBL_AMD] != UINT16_MAX;
 }
 
 void AsmAmdPseudoOps::setCompileOptions(AsmAmdHandler& handler, const char* linePtr)
@@ -1505,9 +1470,7 @@ void AsmAmdPseudoOps::doArg(AsmAmdHandler& handler, const char* pseudoOpPlace,
 bool AsmAmdHandler::parsePseudoOp(const CString& firstName,
        const char* stmtPlace, const char* linePtr)
 {
-    const size_t pseudoOp = binaryFind(amdPseudoOpNamesTbl, amdPseudoOpNamesTbl +
-                    sizeof(amdPseudoOpNamesTbl)/sizeof(char*), firstName.c_str()+1,
-                   CStringLess()) - amdPseudoOpNamesTbl;
+    const size_t pseudoOp = getAsmPseudoOpIndex(firstName, ASMPOTBL_AMD);
     
     switch(pseudoOp)
     {
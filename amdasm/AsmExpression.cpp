@@ -201,6 +201,7 @@ static bool checkSectionDiffs(size_t n, const RelMultiply* relMultiplies,
 AsmTryStatus AsmExpression::tryEvaluate(Assembler& assembler, size_t opStart, size_t opEnd,
             uint64_t& outValue, AsmSectionId& outSectionId, bool withSectionDiffs) const
 {
+    ASM_STATS_PHASE(assembler, AsmPhase::EXPRESSION)
     if (symOccursNum != 0)
         throw AsmException("Expression can't be evaluated if "
                     "symbols still are unresolved!");
@@ -1269,6 +1270,7 @@ AsmExpression* AsmExpression::createExprToEvaluate(Assembler& assembler) const
     std::unique_ptr<AsmExpression> newExpr(new AsmExpression(
             sourcePos, symOccursNum, relativeSymOccurs, ops.size(), ops.data(),
             msgPosNum, messagePositions.get(), argsNum, args.get(), false));
+    ASM_STATS_COUNT(assembler, exprAllocsNum)
     argsNum = 0;
     bool good = true;
     // try to resolve symbols
@@ -1349,6 +1351,7 @@ AsmExpression* AsmExpression::createExprToEvaluate(Assembler& assembler) const
 AsmExpression* AsmExpression::parse(Assembler& assembler, const char*& linePtr,
             bool makeBase, bool dontResolveSymbolsLater)
 {
+    ASM_STATS_PHASE(assembler, AsmPhase::EXPRESSION)
     struct ConExprOpEntry
     {
         AsmExprOp op;
@@ -1382,6 +1385,7 @@ AsmExpression* AsmExpression::parse(Assembler& assembler, const char*& linePtr,
     };
     ExpectedToken expectedToken = XT_FIRST;
     std::unique_ptr<AsmExpression> expr(new AsmExpression);
+    ASM_STATS_COUNT(assembler, exprAllocsNum)
     expr->sourcePos = assembler.getSourcePos(startString);
     
     while (linePtr != end)
@@ -1819,6 +1823,10 @@ AsmExpression* AsmExpression::parse(Assembler& assembler, const char*& linePtr,
         expr->setParams(symOccursNum, relativeSymOccurs,
                   ops.size(), ops.data(), outMsgPositions.size(), outMsgPositions.data(),
                   argsNum, args.data(), makeBase);
+#ifdef HAVE_ASM_STATS
+        if (symOccursNum != 0)
+            assembler.stats.unevalExpressionsNum++;
+#endif
         if (!makeBase)
         {
             // add expression into symbol occurrences in expressions
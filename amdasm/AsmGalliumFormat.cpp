@@ -35,94 +35,12 @@
 
 using namespace CLRX;
 
-// all Gallium pseudo-op names (sorted)
-static const char* galliumPseudoOpNamesTbl[] =
-{
-    "arch_minor", "arch_stepping",
-    "arg", "args", "call_convention", "codeversion",
-    "config", "control_directive",
-    "debug_private_segment_buffer_sgpr",
-    "debug_wavefront_private_segment_offset_sgpr",
-    "debugmode", "default_hsa_features",
-    "dims", "driver_version", "dx10clamp",
-    "entry", "exceptions", "floatmode", "gds_segment_size",
-    "get_driver_version", "get_llvm_version", "globaldata",
-    "group_segment_align",
-    "hsa_debugmode", "hsa_dims", "hsa_dx10clamp", "hsa_exceptions",
-    "hsa_floatmode", "hsa_ieeemode",
-    "hsa_localsize", "hsa_pgmrsrc1",
-    "hsa_pgmrsrc2", "hsa_priority", "hsa_privmode",
-    "hsa_scratchbuffer", "hsa_sgprsnum", "hsa_tgsize",
-    "hsa_userdatanum", "hsa_vgprsnum",
-    "ieeemode", "kcode", "kcodeend",
-    "kernarg_segment_align", "kernarg_segment_size",
-    "kernel_code_entry_offset", "kernel_code_prefetch_offset",
-    "kernel_code_prefetch_size",
-    "llvm_version", "localsize",
-    "machine", "max_scratch_backing_memory",
-    "pgmrsrc1", "pgmrsrc2", "priority",
-    "private_elem_size", "private_segment_align",
-    "privmode", "proginfo", "reserved_sgprs", "reserved_vgprs",
-    "runtime_loader_kernel_symbol",
-    "scratchbuffer", "scratchsym", "sgprsnum",
-    "spilledsgprs", "spilledvgprs", "tgsize",
-    "use_debug_enabled", "use_dispatch_id",
-    "use_dispatch_ptr", "use_dynamic_call_stack",
-    "use_flat_scratch_init", "use_grid_workgroup_count",
-    "use_kernarg_segment_ptr",
-    "use_ordered_append_gds", "use_private_segment_buffer",
-    "use_private_segment_size", "use_ptr64",
-    "use_queue_ptr", "use_xnack_enabled",
-    "userdatanum", "vgprsnum",
-    "wavefront_sgpr_count", "wavefront_size",
-    "workgroup_fbarrier_count", "workgroup_group_segment_size",
-    "workitem_private_segment_size", "workitem_vgpr_count"
-};
-
-// all enums for Gallium pseudo-ops
+// all enums for Gallium pseudo-ops (list in AsmGalliumPseudoOps.inc)
 enum
 {
-    GALLIUMOP_ARCH_MINOR = 0, GALLIUMOP_ARCH_STEPPING,
-    GALLIUMOP_ARG, GALLIUMOP_ARGS, GALLIUMOP_CALL_CONVENTION, GALLIUMOP_CODEVERSION,
-    GALLIUMOP_CONFIG, GALLIUMOP_CONTROL_DIRECTIVE,
-    GALLIUMOP_DEBUG_PRIVATE_SEGMENT_BUFFER_SGPR,
-    GALLIUMOP_DEBUG_WAVEFRONT_PRIVATE_SEGMENT_OFFSET_SGPR,
-    GALLIUMOP_DEBUGMODE, GALLIUMOP_DEFAULT_HSA_FEATURES,
-    GALLIUMOP_DIMS, GALLIUMOP_DRIVER_VERSION, GALLIUMOP_DX10CLAMP,
-    GALLIUMOP_ENTRY, GALLIUMOP_EXCEPTIONS, GALLIUMOP_FLOATMODE, GALLIUMOP_GDS_SEGMENT_SIZE,
-    GALLIUMOP_GET_DRIVER_VERSION, GALLIUMOP_GET_LLVM_VERSION, GALLIUMOP_GLOBALDATA,
-    GALLIUMOP_GROUP_SEGMENT_ALIGN,
-    GALLIUMOP_HSA_DEBUGMODE, GALLIUMOP_HSA_DIMS,
-    GALLIUMOP_HSA_DX10CLAMP, GALLIUMOP_HSA_EXCEPTIONS,
-    GALLIUMOP_HSA_FLOATMODE, GALLIUMOP_HSA_IEEEMODE,
-    GALLIUMOP_HSA_LOCALSIZE, GALLIUMOP_HSA_PGMRSRC1,
-    GALLIUMOP_HSA_PGMRSRC2, GALLIUMOP_HSA_PRIORITY, GALLIUMOP_HSA_PRIVMODE,
-    GALLIUMOP_HSA_SCRATCHBUFFER, GALLIUMOP_HSA_SGPRSNUM, GALLIUMOP_HSA_TGSIZE,
-    GALLIUMOP_HSA_USERDATANUM, GALLIUMOP_HSA_VGPRSNUM,
-    GALLIUMOP_IEEEMODE, GALLIUMOP_KCODE, GALLIUMOP_KCODEEND,
-    GALLIUMOP_KERNARG_SEGMENT_ALIGN, GALLIUMOP_KERNARG_SEGMENT_SIZE,
-    GALLIUMOP_KERNEL_CODE_ENTRY_OFFSET, GALLIUMOP_KERNEL_CODE_PREFETCH_OFFSET,
-    GALLIUMOP_KERNEL_CODE_PREFETCH_SIZE,
-    GALLIUMOP_LLVM_VERSION, GALLIUMOP_LOCALSIZE,
-    GALLIUMOP_MACHINE, GALLIUMOP_MAX_SCRATCH_BACKING_MEMORY,
-    GALLIUMOP_PGMRSRC1, GALLIUMOP_PGMRSRC2, GALLIUMOP_PRIORITY,
-    GALLIUMOP_PRIVATE_ELEM_SIZE, GALLIUMOP_PRIVATE_SEGMENT_ALIGN,
-    GALLIUMOP_PRIVMODE, GALLIUMOP_PROGINFO,
-    GALLIUMOP_RESERVED_SGPRS, GALLIUMOP_RESERVED_VGPRS,
-    GALLIUMOP_RUNTIME_LOADER_KERNEL_SYMBOL,
-    GALLIUMOP_SCRATCHBUFFER, GALLIUMOP_SCRATCHSYM, GALLIUMOP_SGPRSNUM,
-    GALLIUMOP_SPILLEDSGPRS, GALLIUMOP_SPILLEDVGPRS, GALLIUMOP_TGSIZE,
-    GALLIUMOP_USE_DEBUG_ENABLED, GALLIUMOP_USE_DISPATCH_ID,
-    GALLIUMOP_USE_DISPATCH_PTR, GALLIUMOP_USE_DYNAMIC_CALL_STACK,
-    GALLIUMOP_USE_FLAT_SCRATCH_INIT, GALLIUMOP_USE_GRID_WORKGROUP_COUNT,
-    GALLIUMOP_USE_KERNARG_SEGMENT_PTR,
-    GALLIUMOP_USE_ORDERED_APPEND_GDS, GALLIUMOP_USE_PRIVATE_SEGMENT_BUFFER,
-    GALLIUMOP_USE_PRIVATE_SEGMENT_SIZE, GALLIUMOP_USE_PTR64,
-    GALLIUMOP_USE_QUEUE_PTR, GALLIUMOP_USE_XNACK_ENABLED,
-    GALLIUMOP_USERDATANUM, GALLIUMOP_VGPRSNUM,
-    GALLIUMOP_WAVEFRONT_SGPR_COUNT, GALLIUMOP_WAVEFRONT_SIZE,
-    GALLIUMOP_WORKGROUP_FBARRIER_COUNT, GALLIUMOP_WORKGROUP_GROUP_SEGMENT_SIZE,
-    GALLIUMOP_WORKITEM_PRIVATE_SEGMENT_SIZE, GALLIUMOP_WORKITEM_VGPR_COUNT
+#define ASM_PSEUDO_OP(enumName, name) enumName,
+#include "AsmGalliumPseudoOps.inc"
+#undef ASM_PSEUDO_OP
 };
 
 void AsmGalliumHandler::Kernel::initializeAmdHsaKernelConfig()
@@ -341,12 +259,8 @@ namespace CLRX
 
 bool AsmGalliumPseudoOps::checkPseudoOpName(const CString& string)
 {
-    if (string.empty() || string[0] != '.')
-        return false;
-    const size_t pseudoOp = binaryFind(galliumPseudoOpNamesTbl, galliumPseudoOpNamesTbl +
-                sizeof(galliumPseudoOpNamesTbl)/sizeof(char*), string.c_str()+1,
-               CStringLess()) - galliumPseudoOpNamesTbl;
-    return pseudoOp < sizeof(galliumPseudoOpNamesTbl)/sizeof(char*);
+    const AsmPseudoOpHashEntry* entry = findAsmPseudoOp(string);
+    return entry != nullptr && entry->indices[ASMPOTBL_GALLIUM] != UINT16_MAX;
 }
 
 void AsmGalliumPseudoOps::setArchMinor(AsmGalliumHandler& handler, const char* linePtr)
@@ -1096,9 +1010,7 @@ void AsmGalliumPseudoOps::scratchSymbol(AsmGalliumHandler& handler, const char*
 bool AsmGalliumHandler::parsePseudoOp(const CString& firstName,
            const char* stmtPlace, const char* linePtr)
 {
-    const size_t pseudoOp = binaryFind(galliumPseudoOpNamesTbl, galliumPseudoOpNamesTbl +
-                    sizeof(galliumPseudoOpNamesTbl)/sizeof(char*), firstName.c_str()+1,
-                   CStringLess()) - galliumPseudoOpNamesTbl;
+    const size_t pseudoOp = getAsmPseudoOpIndex(firstName, ASMPOTBL_GALLIUM);
     
     switch(pseudoOp)
     {
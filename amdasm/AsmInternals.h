@@ -148,6 +148,51 @@ enum class AsmPredefined: cxbyte
     POLICY
 };
 
+// pseudo-op tables (index of table in pseudo-op hash entry)
+enum : cxuint
+{
+    ASMPOTBL_MAIN = 0,  // all main pseudo-ops
+    ASMPOTBL_OFFLINE,   // pseudo-ops used while skipping clauses
+    ASMPOTBL_MACRO_REPEAT,  // pseudo-ops not ignored while putting macro content
+    ASMPOTBL_GALLIUM,
+    ASMPOTBL_AMD,
+    ASMPOTBL_AMDCL2,
+    ASMPOTBL_ROCM,
+    ASMPOTBL_MAX
+};
+
+// table of pseudo-op names (without dot, sorted by name)
+struct CLRX_INTERNAL AsmPseudoOpNamesTable
+{
+    const char** names;
+    size_t namesNum;
+};
+
+// names of pseudo-ops for all tables (only for GCNTablesGen, see AsmPseudoOpNames.cpp)
+CLRX_INTERNAL extern const AsmPseudoOpNamesTable asmPseudoOpNamesTables[ASMPOTBL_MAX];
+
+// entry of pseudo-op perfect hash table (common for all pseudo-op tables)
+struct CLRX_INTERNAL AsmPseudoOpHashEntry
+{
+    const char* name;   // name without dot (null if slot is empty)
+    uint32_t hash;
+    uint16_t indices[ASMPOTBL_MAX]; // indices in tables (UINT16_MAX if not in table)
+};
+
+/* pseudo-op perfect hash generated at build time by GCNTablesGen */
+
+CLRX_INTERNAL extern const uint32_t asmPseudoOpHashBucketsNum;
+CLRX_INTERNAL extern const uint32_t asmPseudoOpHashTableSize;
+CLRX_INTERNAL extern const uint16_t asmPseudoOpHashDisps[];
+CLRX_INTERNAL extern const AsmPseudoOpHashEntry asmPseudoOpHashTable[];
+// number of pseudo-ops in every table
+CLRX_INTERNAL extern const size_t asmPseudoOpTablesSizes[ASMPOTBL_MAX];
+
+// find pseudo-op by name (with dot), returns null if not found
+CLRX_INTERNAL extern const AsmPseudoOpHashEntry* findAsmPseudoOp(const CString& name);
+// get index of pseudo-op in table (returns number of pseudo-ops if not found)
+CLRX_INTERNAL extern size_t getAsmPseudoOpIndex(const CString& name, cxuint table);
+
 struct CLRX_INTERNAL AsmPseudoOps: AsmParseUtils
 {
     /*
@@ -376,6 +421,56 @@ struct CLRX_INTERNAL AsmKcodePseudoOps : AsmParseUtils
         GOOD = false; \
     }
 
+/// process-wide cache of filtered include files (thread-safe, enabled by ASM_INCLUDECACHE)
+struct CLRX_INTERNAL AsmIncludeCache
+{
+    /// max size of all filtered lines in cache
+    static const size_t maxSize = 64U<<20;
+    
+    /// find filtered file (checks size and content hash of file)
+    /** if file is not in cache, then newFile is set to new filtered file
+     * to record (if file can be cached) */
+    static RefPtr<const AsmFilteredFile> find(const CString& filename,
+                RefPtr<AsmFilteredFile>& newFile);
+    /// put filtered file to cache
+    static void put(RefPtr<AsmFilteredFile> file);
+    /// clear cache
+    static void clear();
+};
+
+// statistics helpers (compiled out if HAVE_ASM_STATS is not defined)
+
+#ifdef HAVE_ASM_STATS
+// charges time to specified phase until end of the scope (if ASM_STATS enabled)
+class CLRX_INTERNAL AsmPhaseGuard
+{
+private:
+    const Assembler& assembler;
+    cxuint prevPhase;
+public:
+    AsmPhaseGuard(const Assembler& _assembler, AsmPhase phase) : assembler(_assembler),
+            prevPhase(ASM_PHASES_NUM)
+    {
+        if (assembler.collectStats)
+            prevPhase = assembler.switchPhase(cxuint(phase));
+    }
+    ~AsmPhaseGuard()
+    {
+        if (assembler.collectStats)
+            assembler.switchPhase(prevPhase);
+    }
+};
+
+#define ASM_STATS_PHASE(ASMR, PHASE) \
+    AsmPhaseGuard asmPhaseGuard((ASMR), (PHASE));
+
+#define ASM_STATS_COUNT(ASMR, FIELD) \
+    ((ASMR).stats.FIELD++);
+#else
+#define ASM_STATS_PHASE(ASMR, PHASE)
+#define ASM_STATS_COUNT(ASMR, FIELD)
+#endif
+
 extern CLRX_INTERNAL cxbyte cstrtobyte(const char*& str, const char* end);
 
 extern const cxbyte tokenCharTable[96] CLRX_INTERNAL;
@@ -0,0 +1,95 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* names of pseudo-ops (without dot) for all pseudo-op tables. They are used only by
+ * GCNTablesGen that generates the pseudo-op perfect hash. Names and pseudo-op enums
+ * (in AsmPseudoOps.cpp and in the sources of format handlers) are made from
+ * these same lists (Asm*PseudoOps.inc), hence their order always matches. */
+
+#include <CLRX/Config.h>
+#include "AsmInternals.h"
+
+using namespace CLRX;
+
+/// all main pseudo-ops (sorted by name)
+static const char* pseudoOpNamesTbl[] =
+{
+#define ASM_PSEUDO_OP(enumName, name) name,
+#include "AsmPseudoOps.inc"
+#undef ASM_PSEUDO_OP
+};
+
+// pseudo-ops used while skipping clauses
+static const char* offlinePseudoOpNamesTbl[] =
+{
+#define ASM_PSEUDO_OP(enumName, name) name,
+#include "AsmClausePseudoOps.inc"
+#undef ASM_PSEUDO_OP
+};
+
+/// pseudo-ops not ignored while putting macro content
+static const char* macroRepeatPseudoOpNamesTbl[] =
+{
+#define ASM_PSEUDO_OP(enumName, name) name,
+#include "AsmMacroPseudoOps.inc"
+#undef ASM_PSEUDO_OP
+};
+
+// all Gallium pseudo-op names (sorted)
+static const char* galliumPseudoOpNamesTbl[] =
+{
+#define ASM_PSEUDO_OP(enumName, name) name,
+#include "AsmGalliumPseudoOps.inc"
+#undef ASM_PSEUDO_OP
+};
+
+// all AMD Catalyst pseudo-op names (sorted)
+static const char* amdPseudoOpNamesTbl[] =
+{
+#define ASM_PSEUDO_OP(enumName, name) name,
+#include "AsmAmdPseudoOps.inc"
+#undef ASM_PSEUDO_OP
+};
+
+// all AmdCL2 pseudo-op names (sorted)
+static const char* amdCL2PseudoOpNamesTbl[] =
+{
+#define ASM_PSEUDO_OP(enumName, name) name,
+#include "AsmAmdCL2PseudoOps.inc"
+#undef ASM_PSEUDO_OP
+};
+
+// all ROCm pseudo-op names (sorted)
+static const char* rocmPseudoOpNamesTbl[] =
+{
+#define ASM_PSEUDO_OP(enumName, name) name,
+#include "AsmROCmPseudoOps.inc"
+#undef ASM_PSEUDO_OP
+};
+
+const AsmPseudoOpNamesTable CLRX::asmPseudoOpNamesTables[ASMPOTBL_MAX] =
+{
+    { pseudoOpNamesTbl, sizeof(pseudoOpNamesTbl)/sizeof(char*) },
+    { offlinePseudoOpNamesTbl, sizeof(offlinePseudoOpNamesTbl)/sizeof(char*) },
+    { macroRepeatPseudoOpNamesTbl, sizeof(macroRepeatPseudoOpNamesTbl)/sizeof(char*) },
+    { galliumPseudoOpNamesTbl, sizeof(galliumPseudoOpNamesTbl)/sizeof(char*) },
+    { amdPseudoOpNamesTbl, sizeof(amdPseudoOpNamesTbl)/sizeof(char*) },
+    { amdCL2PseudoOpNamesTbl, sizeof(amdCL2PseudoOpNamesTbl)/sizeof(char*) },
+    { rocmPseudoOpNamesTbl, sizeof(rocmPseudoOpNamesTbl)/sizeof(char*) }
+};
@@ -18,6 +18,7 @@
  */
 
 #include <CLRX/Config.h>
+#include <cstring>
 #include <string>
 #include <fstream>
 #include <utility>
@@ -32,164 +33,68 @@
 
 using namespace CLRX;
 
-// pseudo-ops used while skipping clauses
-static const char* offlinePseudoOpNamesTbl[] =
+// pseudo-ops used while skipping clauses (list in AsmClausePseudoOps.inc)
+enum
 {
-    "else", "elseif", "elseif32", "elseif64", "elseifarch",
-    "elseifb", "elseifc", "elseifdef",
-    "elseifeq", "elseifeqs", "elseiffmt",
-    "elseifge", "elseifgpu", "elseifgt",
-    "elseifle", "elseiflt", "elseifnarch", "elseifnb", "elseifnc",
-    "elseifndef", "elseifne", "elseifnes",
-    "elseifnfmt", "elseifngpu", "elseifnotdef",
-    "endif", "endm", "endmacro", "endr", "endrept", "for",
-    "if", "if32", "if64", "ifarch", "ifb", "ifc", "ifdef", "ifeq",
-    "ifeqs", "iffmt", "ifge", "ifgpu", "ifgt", "ifle",
-    "iflt", "ifnarch", "ifnb", "ifnc", "ifndef",
-    "ifne", "ifnes", "ifnfmt", "ifngpu", "ifnotdef",
-    "irp", "irpc", "macro", "rept", "while"
+#define ASM_PSEUDO_OP(enumName, name) enumName,
+#include "AsmClausePseudoOps.inc"
+#undef ASM_PSEUDO_OP
 };
 
 /// pseudo-ops not ignored while putting macro content
-static const char* macroRepeatPseudoOpNamesTbl[] =
+/// (list in AsmMacroPseudoOps.inc)
+enum
 {
-    "endm", "endmacro", "endr", "endrept", "for", "irp", "irpc", "macro", "rept", "while"
+#define ASM_PSEUDO_OP(enumName, name) enumName,
+#include "AsmMacroPseudoOps.inc"
+#undef ASM_PSEUDO_OP
 };
 
-// pseudo-ops used while skipping clauses
+// enum for all pseudo-ops (list in AsmPseudoOps.inc)
 enum
 {
-    ASMCOP_ELSE = 0, ASMCOP_ELSEIF, ASMCOP_ELSEIF32, ASMCOP_ELSEIF64, ASMCOP_ELSEIFARCH,
-    ASMCOP_ELSEIFB, ASMCOP_ELSEIFC, ASMCOP_ELSEIFDEF,
-    ASMCOP_ELSEIFEQ, ASMCOP_ELSEIFEQS, ASMCOP_ELSEIFFMT,
-    ASMCOP_ELSEIFGE, ASMCOP_ELSEIFGPU, ASMCOP_ELSEIFGT,
-    ASMCOP_ELSEIFLE, ASMCOP_ELSEIFLT, ASMCOP_ELSEIFNARCH, ASMCOP_ELSEIFNB, ASMCOP_ELSEIFNC,
-    ASMCOP_ELSEIFNDEF, ASMCOP_ELSEIFNE, ASMCOP_ELSEIFNES,
-    ASMCOP_ELSEIFNFMT, ASMCOP_ELSEIFNGPU, ASMCOP_ELSEIFNOTDEF,
-    ASMCOP_ENDIF, ASMCOP_ENDM, ASMCOP_ENDMACRO, ASMCOP_ENDR, ASMCOP_ENDREPT,
-    ASMCOP_FOR, ASMCOP_IF, ASMCOP_IF32, ASMCOP_IF64, ASMCOP_IFARCH, ASMCOP_IFB,
-    ASMCOP_IFC, ASMCOP_IFDEF, ASMCOP_IFEQ,
-    ASMCOP_IFEQS, ASMCOP_IFFMT, ASMCOP_IFGE, ASMCOP_IFGPU, ASMCOP_IFGT, ASMCOP_IFLE,
-    ASMCOP_IFLT, ASMCOP_IFNARCH, ASMCOP_IFNB, ASMCOP_IFNC, ASMCOP_IFNDEF,
-    ASMCOP_IFNE, ASMCOP_IFNES, ASMCOP_IFNFMT, ASMCOP_IFNGPU, ASMCOP_IFNOTDEF,
-    ASMCOP_IRP, ASMCOP_IRPC, ASMCOP_MACRO, ASMCOP_REPT, ASMCOP_WHILE
+#define ASM_PSEUDO_OP(enumName, name) enumName,
+#include "AsmPseudoOps.inc"
+#undef ASM_PSEUDO_OP
 };
 
-/// pseudo-ops not ignored while putting macro content
-enum
-{ ASMMROP_ENDM = 0, ASMMROP_ENDMACRO, ASMMROP_ENDR, ASMMROP_ENDREPT,
-    ASMMROP_FOR, ASMMROP_IRP, ASMMROP_IRPC, ASMMROP_MACRO, ASMMROP_REPT,
-    ASMMROP_WHILE };
+/*
+ * pseudo-op perfect hash table (hash and displace), generated by GCNTablesGen.
+ * one table holds pseudo-ops from all tables (main, offline, macro-repeat and
+ * format's tables), hence one lookup gives indices for all tables.
+ */
 
-/// all main pseudo-ops (sorted by name)
-static const char* pseudoOpNamesTbl[] =
+namespace CLRX
 {
-    "32bit", "64bit", "abort", "align", "altmacro",
-    "amd", "amdcl2", "arch", "ascii", "asciz",
-    "balign", "balignl", "balignw", "buggyfplit", "byte",
-    "cf_call", "cf_cjump", "cf_end",
-    "cf_jump", "cf_ret", "cf_start",
-    "data", "double", "else",
-    "elseif", "elseif32", "elseif64",
-    "elseifarch", "elseifb", "elseifc", "elseifdef",
-    "elseifeq", "elseifeqs", "elseiffmt",
-    "elseifge", "elseifgpu", "elseifgt",
-    "elseifle", "elseiflt", "elseifnarch", "elseifnb",
-    "elseifnc", "elseifndef", "elseifne", "elseifnes",
-    "elseifnfmt", "elseifngpu", "elseifnotdef",
-    "end", "endif", "endm", "endmacro",
-    "endr", "endrept", "ends", "endscope",
-    "enum", "equ", "equiv", "eqv",
-    "err", "error", "exitm", "extern",
-    "fail", "file", "fill", "fillq",
-    "float", "for", "format", "gallium", "get_64bit", "get_arch",
-    "get_format", "get_gpu", "get_policy", "get_version", "global",
-    "globl", "gpu", "half", "hword", "if", "if32", "if64",
-    "ifarch", "ifb", "ifc", "ifdef", "ifeq",
-    "ifeqs", "iffmt", "ifge", "ifgpu", "ifgt", "ifle",
-    "iflt", "ifnarch", "ifnb", "ifnc", "ifndef",
-    "ifne", "ifnes", "ifnfmt", "ifngpu", "ifnotdef", "incbin",
-    "include", "int", "irp", "irpc", "kernel", "lflags",
-    "line", "ln", "local", "long",
-    "macro", "macrocase", "main", "noaltmacro",
-    "nobuggyfplit", "nomacrocase", "nooldmodparam", "octa",
-    "offset", "oldmodparam", "org",
-    "p2align", "policy", "print", "purgem", "quad",
-    "rawcode", "regvar", "rept", "rocm", "rodata",
-    "rvlin", "rvlin_once", "sbttl", "scope", "section", "set",
-    "short", "single", "size", "skip",
-    "space", "string", "string16", "string32",
-    "string64", "struct", "text", "title",
-    "undef", "unusing", "usereg", "using", "version",
-    "warning", "weak", "while", "word"
-};
 
-// enum for all pseudo-ops
-enum
+const AsmPseudoOpHashEntry* findAsmPseudoOp(const CString& name)
 {
-    ASMOP_32BIT = 0, ASMOP_64BIT, ASMOP_ABORT, ASMOP_ALIGN, ASMOP_ALTMACRO,
-    ASMOP_AMD, ASMOP_AMDCL2, ASMOP_ARCH, ASMOP_ASCII, ASMOP_ASCIZ,
-    ASMOP_BALIGN, ASMOP_BALIGNL, ASMOP_BALIGNW, ASMOP_BUGGYFPLIT, ASMOP_BYTE,
-    ASMOP_CF_CALL, ASMOP_CF_CJUMP, ASMOP_CF_END,
-    ASMOP_CF_JUMP, ASMOP_CF_RET, ASMOP_CF_START,
-    ASMOP_DATA, ASMOP_DOUBLE, ASMOP_ELSE,
-    ASMOP_ELSEIF, ASMOP_ELSEIF32, ASMOP_ELSEIF64,
-    ASMOP_ELSEIFARCH, ASMOP_ELSEIFB, ASMOP_ELSEIFC, ASMOP_ELSEIFDEF,
-    ASMOP_ELSEIFEQ, ASMOP_ELSEIFEQS, ASMOP_ELSEIFFMT,
-    ASMOP_ELSEIFGE, ASMOP_ELSEIFGPU, ASMOP_ELSEIFGT,
-    ASMOP_ELSEIFLE, ASMOP_ELSEIFLT, ASMOP_ELSEIFNARCH, ASMOP_ELSEIFNB,
-    ASMOP_ELSEIFNC, ASMOP_ELSEIFNDEF, ASMOP_ELSEIFNE, ASMOP_ELSEIFNES,
-    ASMOP_ELSEIFNFMT, ASMOP_ELSEIFNGPU, ASMOP_ELSEIFNOTDEF,
-    ASMOP_END, ASMOP_ENDIF, ASMOP_ENDM, ASMOP_ENDMACRO,
-    ASMOP_ENDR, ASMOP_ENDREPT, ASMOP_ENDS, ASMOP_ENDSCOPE,
-    ASMOP_ENUM, ASMOP_EQU, ASMOP_EQUIV, ASMOP_EQV,
-    ASMOP_ERR, ASMOP_ERROR, ASMOP_EXITM, ASMOP_EXTERN,
-    ASMOP_FAIL, ASMOP_FILE, ASMOP_FILL, ASMOP_FILLQ,
-    ASMOP_FLOAT, ASMOP_FOR, ASMOP_FORMAT, ASMOP_GALLIUM, ASMOP_GET_64BIT, ASMOP_GET_ARCH,
-    ASMOP_GET_FORMAT, ASMOP_GET_GPU, ASMOP_GET_POLICY, ASMOP_GET_VERSION, ASMOP_GLOBAL,
-    ASMOP_GLOBL, ASMOP_GPU, ASMOP_HALF, ASMOP_HWORD, ASMOP_IF, ASMOP_IF32, ASMOP_IF64,
-    ASMOP_IFARCH, ASMOP_IFB, ASMOP_IFC, ASMOP_IFDEF, ASMOP_IFEQ,
-    ASMOP_IFEQS, ASMOP_IFFMT, ASMOP_IFGE, ASMOP_IFGPU, ASMOP_IFGT, ASMOP_IFLE,
-    ASMOP_IFLT, ASMOP_IFNARCH, ASMOP_IFNB, ASMOP_IFNC, ASMOP_IFNDEF,
-    ASMOP_IFNE, ASMOP_IFNES, ASMOP_IFNFMT, ASMOP_IFNGPU, ASMOP_IFNOTDEF, ASMOP_INCBIN,
-    ASMOP_INCLUDE, ASMOP_INT, ASMOP_IRP, ASMOP_IRPC, ASMOP_KERNEL, ASMOP_LFLAGS,
-    ASMOP_LINE, ASMOP_LN, ASMOP_LOCAL, ASMOP_LONG,
-    ASMOP_MACRO, ASMOP_MACROCASE, ASMOP_MAIN, ASMOP_NOALTMACRO,
-    ASMOP_NOBUGGYFPLIT, ASMOP_NOMACROCASE, ASMOP_NOOLDMODPARAM, ASMOP_OCTA,
-    ASMOP_OFFSET, ASMOP_OLDMODPARAM, ASMOP_ORG,
-    ASMOP_P2ALIGN, ASMOP_POLICY, ASMOP_PRINT, ASMOP_PURGEM, ASMOP_QUAD,
-    ASMOP_RAWCODE, ASMOP_REGVAR, ASMOP_REPT, ASMOP_ROCM, ASMOP_RODATA,
-    ASMOP_RVLIN, ASMOP_RVLIN_ONCE, ASMOP_SBTTL, ASMOP_SCOPE, ASMOP_SECTION, ASMOP_SET,
-    ASMOP_SHORT, ASMOP_SINGLE, ASMOP_SIZE, ASMOP_SKIP,
-    ASMOP_SPACE, ASMOP_STRING, ASMOP_STRING16, ASMOP_STRING32,
-    ASMOP_STRING64, ASMOP_STRUCT, ASMOP_TEXT, ASMOP_TITLE,
-    ASMOP_UNDEF, ASMOP_UNUSING, ASMOP_USEREG, ASMOP_USING, ASMOP_VERSION,
-    ASMOP_WARNING, ASMOP_WEAK, ASMOP_WHILE, ASMOP_WORD
-};
+    if (name.empty() || name[0] != '.')
+        return nullptr;
+    const char* pname = name.c_str()+1;
+    const uint32_t hash = calculateFNV1aHash(pname);
+    const uint32_t disp = asmPseudoOpHashDisps[hash & (asmPseudoOpHashBucketsNum-1)];
+    const AsmPseudoOpHashEntry& entry = asmPseudoOpHashTable[
+            getPerfectHashPos(hash, disp) & (asmPseudoOpHashTableSize-1)];
+    if (entry.name == nullptr || entry.hash != hash || ::strcmp(entry.name, pname) != 0)
+        return nullptr;
+    return &entry;
+}
 
-namespace CLRX
+size_t getAsmPseudoOpIndex(const CString& name, cxuint table)
 {
+    const AsmPseudoOpHashEntry* entry = findAsmPseudoOp(name);
+    if (entry == nullptr || entry->indices[table] == UINT16_MAX)
+        return asmPseudoOpTablesSizes[table];
+    return entry->indices[table];
+}
 
 // checking whether name is pseudo-op name
 // (checking any extra pseudo-op provided by format handler)
 bool AsmPseudoOps::checkPseudoOpName(const CString& string)
 {
-    if (string.empty() || string[0] != '.')
-        return false;
-    const size_t pseudoOp = binaryFind(pseudoOpNamesTbl, pseudoOpNamesTbl +
-                    sizeof(pseudoOpNamesTbl)/sizeof(char*), string.c_str()+1,
-                   CStringLess()) - pseudoOpNamesTbl;
-    if (pseudoOp < sizeof(pseudoOpNamesTbl)/sizeof(char*))
-        return true;
-    if (AsmGalliumPseudoOps::checkPseudoOpName(string))
-        return true;
-    if (AsmAmdPseudoOps::checkPseudoOpName(string))
-        return true;
-    if (AsmAmdCL2PseudoOps::checkPseudoOpName(string))
-        return true;
-    if (AsmROCmPseudoOps::checkPseudoOpName(string))
-        return true;
-    return false;
+    // all pseudo-ops (also format's pseudo-ops) are in hash table
+    return findAsmPseudoOp(string) != nullptr;
 }
 
 };
@@ -198,9 +103,12 @@ bool AsmPseudoOps::checkPseudoOpName(const CString& string)
 void Assembler::parsePseudoOps(const CString& firstName,
        const char* stmtPlace, const char* linePtr)
 {
-    const size_t pseudoOp = binaryFind(pseudoOpNamesTbl, pseudoOpNamesTbl +
-                    sizeof(pseudoOpNamesTbl)/sizeof(char*), firstName.c_str()+1,
-                   CStringLess()) - pseudoOpNamesTbl;
+    // one lookup gives main pseudo-op and format's pseudo-ops
+    const AsmPseudoOpHashEntry* pseudoOpEntry = findAsmPseudoOp(firstName);
+    const size_t pseudoOp = (pseudoOpEntry != nullptr &&
+            pseudoOpEntry->indices[ASMPOTBL_MAIN] != UINT16_MAX) ?
+            pseudoOpEntry->indices[ASMPOTBL_MAIN] :
+            asmPseudoOpTablesSizes[ASMPOTBL_MAIN];
     
     switch(pseudoOp)
     {
@@ -708,10 +616,14 @@ void Assembler::parsePseudoOps(const CString& firstName,
             break;
         default:
         {
-            bool isGalliumPseudoOp = AsmGalliumPseudoOps::checkPseudoOpName(firstName);
-            bool isAmdPseudoOp = AsmAmdPseudoOps::checkPseudoOpName(firstName);
-            bool isAmdCL2PseudoOp = AsmAmdCL2PseudoOps::checkPseudoOpName(firstName);
-            bool isROCmPseudoOp = AsmROCmPseudoOps::checkPseudoOpName(firstName);
+            bool isGalliumPseudoOp = pseudoOpEntry != nullptr &&
+                    pseudoOpEntry->indices[ASMPOTBL_GALLIUM] != UINT16_MAX;
+            bool isAmdPseudoOp = pseudoOpEntry != nullptr &&
+                    pseudoOpEntry->indices[ASMPOTBL_AMD] != UINT16_MAX;
+            bool isAmdCL2PseudoOp = pseudoOpEntry != nullptr &&
+                    pseudoOpEntry->indices[ASMPOTBL_AMDCL2] != UINT16_MAX;
+            bool isROCmPseudoOp = pseudoOpEntry != nullptr &&
+                    pseudoOpEntry->indices[ASMPOTBL_ROCM] != UINT16_MAX;
             if (isGalliumPseudoOp || isAmdPseudoOp || isAmdCL2PseudoOp || isROCmPseudoOp)
             {
                 // initialize only if gallium pseudo-op or AMD pseudo-op
@@ -801,9 +713,7 @@ bool Assembler::skipClauses(bool exitm)
         CString pseudoOpName = extractSymName(linePtr, end, false);
         toLowerString(pseudoOpName);
         
-        const size_t pseudoOp = binaryFind(offlinePseudoOpNamesTbl,
-               offlinePseudoOpNamesTbl + sizeof(offlinePseudoOpNamesTbl)/sizeof(char*),
-               pseudoOpName.c_str()+1, CStringLess()) - offlinePseudoOpNamesTbl;
+        const size_t pseudoOp = getAsmPseudoOpIndex(pseudoOpName, ASMPOTBL_OFFLINE);
         
         // any conditional inside macro or repeat will be ignored
         bool insideMacroOrRepeat = !clauses.empty() && 
@@ -952,10 +862,8 @@ bool Assembler::putMacroContent(RefPtr<AsmMacro> macro)
         CString pseudoOpName = extractSymName(linePtr, end, false);
         toLowerString(pseudoOpName);
         
-        const size_t pseudoOp = binaryFind(macroRepeatPseudoOpNamesTbl,
-               macroRepeatPseudoOpNamesTbl + sizeof(macroRepeatPseudoOpNamesTbl) /
-               sizeof(char*), pseudoOpName.c_str()+1, CStringLess()) -
-               macroRepeatPseudoOpNamesTbl;
+        const size_t pseudoOp = getAsmPseudoOpIndex(pseudoOpName,
+                    ASMPOTBL_MACRO_REPEAT);
         // handle pseudo-op in macro content
         switch(pseudoOp)
         {
@@ -1021,10 +929,8 @@ bool Assembler::putRepetitionContent(AsmRepeat& repeat)
         
         CString pseudoOpName = extractSymName(linePtr, end, false);
         toLowerString(pseudoOpName);
-        const size_t pseudoOp = binaryFind(macroRepeatPseudoOpNamesTbl,
-               macroRepeatPseudoOpNamesTbl + sizeof(macroRepeatPseudoOpNamesTbl) /
-               sizeof(char*), pseudoOpName.c_str()+1, CStringLess()) -
-               macroRepeatPseudoOpNamesTbl;
+        const size_t pseudoOp = getAsmPseudoOpIndex(pseudoOpName,
+                    ASMPOTBL_MACRO_REPEAT);
         // handle pseudo-op in macro content
         switch(pseudoOp)
         {
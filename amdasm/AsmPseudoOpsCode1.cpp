@@ -311,7 +311,11 @@ void AsmPseudoOps::includeFile(Assembler& asmr, const char* pseudoOpPlace,
             return;
         }
         catch(const Exception& ex)
-        { failedOpen = true; }
+        {
+            failedOpen = true;
+            if (!isFileExists(sysfilename.c_str()))
+                asmr.absentDependencyFiles.push_back(sysfilename);
+        }
         
         // find in include paths
         for (const CString& incDir: asmr.includeDirs)
@@ -320,14 +324,19 @@ void AsmPseudoOps::includeFile(Assembler& asmr, const char* pseudoOpPlace,
             std::string incDirPath(incDir.c_str());
             // convert path to system path (with system dir separators)
             filesystemPath(incDirPath);
+            const std::string incPath = joinPaths(
+                            std::string(incDirPath.c_str()), sysfilename);
             try
             {
-                asmr.includeFile(pseudoOpPlace, joinPaths(
-                            std::string(incDirPath.c_str()), sysfilename));
+                asmr.includeFile(pseudoOpPlace, incPath);
                 break;
             }
             catch(const Exception& ex)
-            { failedOpen = true; }
+            {
+                failedOpen = true;
+                if (!isFileExists(incPath.c_str()))
+                    asmr.absentDependencyFiles.push_back(incPath);
+            }
         }
         // if not found
         if (failedOpen)
@@ -396,23 +405,30 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
     std::ifstream ifs;
     sysfilename = filename;
     filesystemPath(sysfilename);
+    std::string openedPath = sysfilename;
     // try in this directory
     ifs.open(sysfilename.c_str(), std::ios::binary);
     if (!ifs)
     {
+        if (!isFileExists(sysfilename.c_str()))
+            asmr.absentDependencyFiles.push_back(sysfilename);
         // find in include paths
         for (const CString& incDir: asmr.includeDirs)
         {
             std::string incDirPath(incDir.c_str());
             filesystemPath(incDirPath);
-            ifs.open(joinPaths(incDirPath.c_str(), sysfilename).c_str(), std::ios::binary);
+            openedPath = joinPaths(incDirPath.c_str(), sysfilename);
+            ifs.open(openedPath.c_str(), std::ios::binary);
             if (ifs)
                 break;
+            if (!isFileExists(openedPath.c_str()))
+                asmr.absentDependencyFiles.push_back(openedPath);
         }
     }
     if (!ifs)
         ASM_RETURN_BY_ERROR(namePlace, (std::string("Binary file '") + filename +
                     "' not found or unavailable in any directory").c_str())
+    asmr.dependencyFiles.push_back(openedPath);
     // exception for checking file seeking
     bool seekingIsWorking = true;
     ifs.exceptions(std::ios::badbit | std::ios::failbit); // exceptions
@@ -429,6 +445,20 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
     {
         /* for regular files */
         const uint64_t size = ifs.tellg();
+        if ((asmr.flags & ASM_FILEHASHES) != 0)
+        {
+            // read whole file to get hash of its content
+            Array<char> content(size);
+            ifs.seekg(0, std::ios::beg);
+            ifs.read(content.data(), size);
+            if (ifs.gcount() != std::streamsize(size))
+                ASM_RETURN_BY_ERROR(namePlace, "Can't read whole needed file content")
+            asmr.dependencyFileHashes.push_back(calculateHash128(size, content.data()));
+            if (size > offset)
+                asmr.putData(std::min(size-offset, count),
+                             (const cxbyte*)content.data() + offset);
+            return;
+        }
         if (size < offset)
             return; // do nothing
         // skip offset bytes
@@ -443,6 +473,8 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
     else
     {
         /* for sequential files, likes fifo */
+        // hash of read part (content of file can not be read again)
+        std::vector<char> readContent;
         char tempBuf[256];
         /// first we skipping bytes given in offset
         for (uint64_t pos = 0; pos < offset; )
@@ -461,10 +493,15 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
             ifs.read(tempBuf, toRead);
             const uint64_t readed = ifs.gcount();
             asmr.putData(readed, (cxbyte*)tempBuf);
+            if ((asmr.flags & ASM_FILEHASHES) != 0)
+                readContent.insert(readContent.end(), tempBuf, tempBuf+readed);
             bytes += readed;
             if (readed < toRead)
                 break;
         }
+        if ((asmr.flags & ASM_FILEHASHES) != 0)
+            asmr.dependencyFileHashes.push_back(calculateHash128(readContent.size(),
+                        readContent.data()));
     }
 }
 
@@ -1530,6 +1567,8 @@ void AsmPseudoOps::doRepeat(Assembler& asmr, const char* pseudoOpPlace,
         asmr.asmInputFilters.push(newInputFilter.release());
         asmr.currentInputFilter = asmr.asmInputFilters.top();
         asmr.repetitionLevel++;
+        ASM_STATS_COUNT(asmr, repetitionsNum)
+        ASM_STATS_COUNT(asmr, inputFilterAllocsNum)
     }
 }
 
@@ -1654,6 +1693,8 @@ void AsmPseudoOps::doMacro(Assembler& asmr, const char* pseudoOpPlace, const cha
         asmr.pushClause(pseudoOpPlace, AsmClauseType::MACRO);
         if (!asmr.putMacroContent(macro.constCast<AsmMacro>()))
             return;
+        // find substitutions once, to speed up macro expansions
+        macro.constCast<AsmMacro>()->compile();
         asmr.macroMap.insert(std::make_pair(std::move(macroName), std::move(macro)));
     }
 }
@@ -1754,6 +1795,8 @@ void AsmPseudoOps::doIRP(Assembler& asmr, const char* pseudoOpPlace, const char*
             asmr.asmInputFilters.push(newInputFilter.release());
             asmr.currentInputFilter = asmr.asmInputFilters.top();
             asmr.repetitionLevel++;
+            ASM_STATS_COUNT(asmr, repetitionsNum)
+            ASM_STATS_COUNT(asmr, inputFilterAllocsNum)
         }
     }
 }
@@ -1833,6 +1876,8 @@ void AsmPseudoOps::doFor(Assembler& asmr, const char* pseudoOpPlace, const char*
         asmr.asmInputFilters.push(newInputFilter.release());
         asmr.currentInputFilter = asmr.asmInputFilters.top();
         asmr.repetitionLevel++;
+        ASM_STATS_COUNT(asmr, repetitionsNum)
+        ASM_STATS_COUNT(asmr, inputFilterAllocsNum)
     }
 }
 
@@ -1862,6 +1907,8 @@ void AsmPseudoOps::doWhile(Assembler& asmr, const char* pseudoOpPlace, const cha
         asmr.asmInputFilters.push(newInputFilter.release());
         asmr.currentInputFilter = asmr.asmInputFilters.top();
         asmr.repetitionLevel++;
+        ASM_STATS_COUNT(asmr, repetitionsNum)
+        ASM_STATS_COUNT(asmr, inputFilterAllocsNum)
     }
 }
 
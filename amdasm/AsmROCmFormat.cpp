@@ -33,84 +33,12 @@
 
 using namespace CLRX;
 
-// all ROCm pseudo-op names (sorted)
-static const char* rocmPseudoOpNamesTbl[] =
-{
-    "arch_minor", "arch_stepping", "arg",
-    "call_convention", "codeversion", "config",
-    "control_directive", "cws", "debug_private_segment_buffer_sgpr",
-    "debug_wavefront_private_segment_offset_sgpr",
-    "debugmode", "default_hsa_features", "dims", "dx10clamp",
-    "eflags", "exceptions", "fixed_work_group_size",
-    "fkernel", "floatmode", "gds_segment_size",
-    "globaldata", "gotsym", "group_segment_align", "ieeemode", "kcode",
-    "kcodeend", "kernarg_segment_align",
-    "kernarg_segment_size", "kernel_code_entry_offset",
-    "kernel_code_prefetch_offset", "kernel_code_prefetch_size",
-    "localsize", "machine",
-    "max_flat_work_group_size", "max_scratch_backing_memory",
-    "md_group_segment_fixed_size", "md_kernarg_segment_align",
-    "md_kernarg_segment_size", "md_language","md_private_segment_fixed_size",
-    "md_sgprsnum", "md_symname", "md_version",
-    "md_vgprsnum", "md_wavefront_size",
-    "metadata", "newbinfmt", "nosectdiffs",
-    "pgmrsrc1", "pgmrsrc2", "printf", "priority",
-    "private_elem_size", "private_segment_align",
-    "privmode", "reqd_work_group_size",
-    "reserved_sgprs", "reserved_vgprs",
-    "runtime_handle", "runtime_loader_kernel_symbol",
-    "scratchbuffer", "sgprsnum",
-    "spilledsgprs", "spilledvgprs", "target", "tgsize", "tripple",
-    "use_debug_enabled", "use_dispatch_id",
-    "use_dispatch_ptr", "use_dynamic_call_stack",
-    "use_flat_scratch_init", "use_grid_workgroup_count",
-    "use_kernarg_segment_ptr", "use_ordered_append_gds",
-    "use_private_segment_buffer", "use_private_segment_size",
-    "use_ptr64", "use_queue_ptr", "use_xnack_enabled",
-    "userdatanum", "vectypehint", "vgprsnum", "wavefront_sgpr_count",
-    "wavefront_size", "work_group_size_hint", "workgroup_fbarrier_count",
-    "workgroup_group_segment_size", "workitem_private_segment_size",
-    "workitem_vgpr_count"
-};
-
-// all enums for ROCm pseudo-ops
+// all enums for ROCm pseudo-ops (list in AsmROCmPseudoOps.inc)
 enum
 {
-    ROCMOP_ARCH_MINOR, ROCMOP_ARCH_STEPPING, ROCMOP_ARG,
-    ROCMOP_CALL_CONVENTION, ROCMOP_CODEVERSION, ROCMOP_CONFIG,
-    ROCMOP_CONTROL_DIRECTIVE, ROCMOP_CWS, ROCMOP_DEBUG_PRIVATE_SEGMENT_BUFFER_SGPR,
-    ROCMOP_DEBUG_WAVEFRONT_PRIVATE_SEGMENT_OFFSET_SGPR,
-    ROCMOP_DEBUGMODE, ROCMOP_DEFAULT_HSA_FEATURES, ROCMOP_DIMS, ROCMOP_DX10CLAMP,
-    ROCMOP_EFLAGS, ROCMOP_EXCEPTIONS, ROCMOP_FIXED_WORK_GROUP_SIZE, ROCMOP_FKERNEL,
-    ROCMOP_FLOATMODE, ROCMOP_GDS_SEGMENT_SIZE, ROCMOP_GLOBALDATA, ROCMOP_GOTSYM,
-    ROCMOP_GROUP_SEGMENT_ALIGN, ROCMOP_IEEEMODE, ROCMOP_KCODE,
-    ROCMOP_KCODEEND, ROCMOP_KERNARG_SEGMENT_ALIGN,
-    ROCMOP_KERNARG_SEGMENT_SIZE, ROCMOP_KERNEL_CODE_ENTRY_OFFSET,
-    ROCMOP_KERNEL_CODE_PREFETCH_OFFSET, ROCMOP_KERNEL_CODE_PREFETCH_SIZE,
-    ROCMOP_LOCALSIZE, ROCMOP_MACHINE,
-    ROCMOP_MAX_FLAT_WORK_GROUP_SIZE, ROCMOP_MAX_SCRATCH_BACKING_MEMORY,
-    ROCMOP_MD_GROUP_SEGMENT_FIXED_SIZE, ROCMOP_MD_KERNARG_SEGMENT_ALIGN,
-    ROCMOP_MD_KERNARG_SEGMENT_SIZE, ROCMOP_MD_LANGUAGE,
-    ROCMOP_MD_PRIVATE_SEGMENT_FIXED_SIZE, ROCMOP_MD_SGPRSNUM,
-    ROCMOP_MD_SYMNAME, ROCMOP_MD_VERSION, ROCMOP_MD_VGPRSNUM, ROCMOP_MD_WAVEFRONT_SIZE,
-    ROCMOP_METADATA, ROCMOP_NEWBINFMT, ROCMOP_NOSECTDIFFS,
-    ROCMOP_PGMRSRC1, ROCMOP_PGMRSRC2, ROCMOP_PRINTF,
-    ROCMOP_PRIORITY, ROCMOP_PRIVATE_ELEM_SIZE, ROCMOP_PRIVATE_SEGMENT_ALIGN,
-    ROCMOP_PRIVMODE, ROCMOP_REQD_WORK_GROUP_SIZE,
-    ROCMOP_RESERVED_SGPRS, ROCMOP_RESERVED_VGPRS,
-    ROCMOP_RUNTIME_HANDLE, ROCMOP_RUNTIME_LOADER_KERNEL_SYMBOL,
-    ROCMOP_SCRATCHBUFFER, ROCMOP_SGPRSNUM, ROCMOP_SPILLEDSGPRS, ROCMOP_SPILLEDVGPRS,
-    ROCMOP_TARGET, ROCMOP_TGSIZE, ROCMOP_TRIPPLE,
-    ROCMOP_USE_DEBUG_ENABLED, ROCMOP_USE_DISPATCH_ID,
-    ROCMOP_USE_DISPATCH_PTR, ROCMOP_USE_DYNAMIC_CALL_STACK,
-    ROCMOP_USE_FLAT_SCRATCH_INIT, ROCMOP_USE_GRID_WORKGROUP_COUNT,
-    ROCMOP_USE_KERNARG_SEGMENT_PTR, ROCMOP_USE_ORDERED_APPEND_GDS,
-    ROCMOP_USE_PRIVATE_SEGMENT_BUFFER, ROCMOP_USE_PRIVATE_SEGMENT_SIZE,
-    ROCMOP_USE_PTR64, ROCMOP_USE_QUEUE_PTR, ROCMOP_USE_XNACK_ENABLED,
-    ROCMOP_USERDATANUM, ROCMOP_VECTYPEHINT, ROCMOP_VGPRSNUM, ROCMOP_WAVEFRONT_SGPR_COUNT,
-    ROCMOP_WAVEFRONT_SIZE, ROCM_WORK_GROUP_SIZE_HINT, ROCMOP_WORKGROUP_FBARRIER_COUNT,
-    ROCMOP_WORKGROUP_GROUP_SEGMENT_SIZE, ROCMOP_WORKITEM_PRIVATE_SEGMENT_SIZE,
-    ROCMOP_WORKITEM_VGPR_COUNT
+#define ASM_PSEUDO_OP(enumName, name) enumName,
+#include "AsmROCmPseudoOps.inc"
+#undef ASM_PSEUDO_OP
 };
 
 /*
@@ -327,12 +255,8 @@ namespace CLRX
 
 bool AsmROCmPseudoOps::checkPseudoOpName(const CString& string)
 {
-    if (string.empty() || string[0] != '.')
-        return false;
-    const size_t pseudoOp = binaryFind(rocmPseudoOpNamesTbl, rocmPseudoOpNamesTbl +
-                sizeof(rocmPseudoOpNamesTbl)/sizeof(char*), string.c_str()+1,
-               CStringLess()) - rocmPseudoOpNamesTbl;
-    return pseudoOp < sizeof(rocmPseudoOpNamesTbl)/sizeof(char*);
+    const AsmPseudoOpHashEntry* entry = findAsmPseudoOp(string);
+    return entry != nullptr && entry->indices[ASMPOTBL_ROCM] != UINT16_MAX;
 }
 
 void AsmROCmPseudoOps::setArchMinor(AsmROCmHandler& handler, const char* linePtr)
@@ -1845,9 +1769,7 @@ void AsmROCmPseudoOps::addGotSymbol(AsmROCmHandler& handler,
 bool AsmROCmHandler::parsePseudoOp(const CString& firstName, const char* stmtPlace,
                const char* linePtr)
 {
-    const size_t pseudoOp = binaryFind(rocmPseudoOpNamesTbl, rocmPseudoOpNamesTbl +
-                    sizeof(rocmPseudoOpNamesTbl)/sizeof(char*), firstName.c_str()+1,
-                   CStringLess()) - rocmPseudoOpNamesTbl;
+    const size_t pseudoOp = getAsmPseudoOpIndex(firstName, ASMPOTBL_ROCM);
     
     switch(pseudoOp)
     {
@@ -21,8 +21,10 @@
 #include <assert.h>
 #include <iostream>
 #include <cstddef>
+#include <cstdint>
 #include <stack>
 #include <deque>
+#include <queue>
 #include <vector>
 #include <utility>
 #include <unordered_set>
@@ -60,7 +62,8 @@ std::ostream& operator<<(std::ostream& os, const CLRX::BlockIndex& v)
 
 ISAUsageHandler::ISAUsageHandler(const std::vector<cxbyte>& _content) :
             content(_content), lastOffset(0), readOffset(0), instrStructPos(0),
-            regVarUsagesPos(0), pushedArgs(0), argPos(0), argFlags(0),
+            regVarUsagesPos(0), usagesNum(0), instrsNum(0), pushedArgs(0),
+            argPos(0), argFlags(0),
             isNext(false), useRegMode(false)
 { }
 
@@ -123,10 +126,13 @@ static inline void appendToByteVec(std::vector<cxbyte>& out, const T& obj)
 
 void ISAUsageHandler::pushUsage(const AsmRegVarUsage& rvu)
 {
+    const bool newInstr = (usagesNum == 0 || lastOffset != rvu.offset);
     if (lastOffset == rvu.offset && useRegMode)
         flush(); // only flush if useRegMode and no change in offset
     else // otherwise
         putSpace(rvu.offset);
+    instrsNum += newInstr;
+    usagesNum++;
     useRegMode = false;
     if (rvu.regVar != nullptr)
     {
@@ -142,10 +148,13 @@ void ISAUsageHandler::pushUsage(const AsmRegVarUsage& rvu)
 
 void ISAUsageHandler::pushUseRegUsage(const AsmRegVarUsage& rvu)
 {
+    const bool newInstr = (usagesNum == 0 || lastOffset != rvu.offset);
     if (lastOffset == rvu.offset && !useRegMode)
         flush(); // only flush if useRegMode and no change in offset
     else // otherwise
         putSpace(rvu.offset);
+    instrsNum += newInstr;
+    usagesNum++;
     useRegMode = true;
     if (pushedArgs == 0 || pushedArgs == 256)
     {
@@ -323,16 +332,88 @@ ISALinearDepHandler* ISALinearDepHandler::copy() const
     return new ISALinearDepHandler(*this);
 }
 
+/*
+ * ISAUsageArrays
+ */
+
+void ISAUsageArrays::clear()
+{
+    instrOffsets.clear();
+    instrUsageStarts.clear();
+    regVars.clear();
+    rstarts.clear();
+    rends.clear();
+    regFields.clear();
+    rwFlags.clear();
+    aligns.clear();
+}
+
+void ISAUsageArrays::assign(ISAUsageHandler& usageHandler)
+{
+    clear();
+    const size_t usagesNum = usageHandler.getUsagesNum();
+    if (usagesNum > UINT32_MAX)
+        throw AsmException("Too many register usages");
+    // reserve arrays for numbers counted while pushing usages
+    instrOffsets.reserve(usageHandler.getInstrsNum());
+    instrUsageStarts.reserve(usageHandler.getInstrsNum()+1);
+    regVars.resize(usagesNum);
+    rstarts.resize(usagesNum);
+    rends.resize(usagesNum);
+    regFields.resize(usagesNum);
+    rwFlags.resize(usagesNum);
+    aligns.resize(usagesNum);
+    
+    size_t i = 0;
+    usageHandler.rewind();
+    for (; i < usagesNum && usageHandler.hasNext(); i++)
+    {
+        const AsmRegVarUsage rvu = usageHandler.nextUsage();
+        if (instrOffsets.empty() || instrOffsets.back() != rvu.offset)
+        {
+            // new instruction
+            instrOffsets.push_back(rvu.offset);
+            instrUsageStarts.push_back(i);
+        }
+        regVars[i] = rvu.regVar;
+        rstarts[i] = rvu.rstart;
+        rends[i] = rvu.rend;
+        regFields[i] = rvu.regField;
+        rwFlags[i] = rvu.rwFlags | (rvu.useRegMode ? 0x80 : 0);
+        aligns[i] = rvu.align;
+    }
+    instrUsageStarts.push_back(i);
+}
+
+size_t ISAUsageArrays::lowerBound(size_t offset) const
+{
+    return std::lower_bound(instrOffsets.begin(), instrOffsets.end(), offset) -
+            instrOffsets.begin();
+}
+
+size_t ISAUsageArrays::getMemorySize() const
+{
+    return instrOffsets.capacity()*sizeof(size_t) +
+        instrUsageStarts.capacity()*sizeof(uint32_t) +
+        regVars.capacity()*sizeof(const AsmRegVar*) +
+        (rstarts.capacity() + rends.capacity())*sizeof(uint16_t) +
+        regFields.capacity()*sizeof(AsmRegField) +
+        rwFlags.capacity() + aligns.capacity();
+}
+
 /*
  * Asm register allocator stuff
  */
 
-AsmRegAllocator::AsmRegAllocator(Assembler& _assembler) : assembler(_assembler)
+AsmRegAllocator::AsmRegAllocator(Assembler& _assembler) : assembler(_assembler),
+        regTypesNum(0), allocMode(AsmRegAllocMode::GRAPH_COLORING)
 { }
 
 AsmRegAllocator::AsmRegAllocator(Assembler& _assembler,
         const std::vector<CodeBlock>& _codeBlocks, const SSAReplacesMap& _ssaReplacesMap)
-        : assembler(_assembler), codeBlocks(_codeBlocks), ssaReplacesMap(_ssaReplacesMap)
+        : assembler(_assembler), codeBlocks(_codeBlocks),
+          ssaReplacesMap(_ssaReplacesMap), regTypesNum(0),
+          allocMode(AsmRegAllocMode::GRAPH_COLORING)
 { }
 
 static inline bool codeBlockStartLess(const AsmRegAllocator::CodeBlock& c1,
@@ -343,12 +424,41 @@ static inline bool codeBlockEndLess(const AsmRegAllocator::CodeBlock& c1,
                   const AsmRegAllocator::CodeBlock& c2)
 { return c1.end < c2.end; }
 
+void CLRX::getCodeBlockNexts(const std::vector<CodeBlock>& codeBlocks,
+            std::vector<std::vector<size_t> >& nextBlocks)
+{
+    const size_t blocksNum = codeBlocks.size();
+    nextBlocks.assign(blocksNum, std::vector<size_t>());
+    std::vector<size_t> returnPoints;
+    for (size_t i = 0; i + 1 < blocksNum; i++)
+        if (codeBlocks[i].haveCalls)
+            returnPoints.push_back(i+1);
+    for (size_t i = 0; i < blocksNum; i++)
+    {
+        const CodeBlock& block = codeBlocks[i];
+        bool haveJumps = false;
+        for (const NextBlock& next: block.nexts)
+        {
+            nextBlocks[i].push_back(next.block);
+            haveJumps |= !next.isCall;
+        }
+        if (!block.haveEnd && !haveJumps && i + 1 < blocksNum)
+            nextBlocks[i].push_back(i+1);
+        if (block.haveReturn)
+            nextBlocks[i].insert(nextBlocks[i].end(), returnPoints.begin(),
+                        returnPoints.end());
+    }
+}
+
 void AsmRegAllocator::createCodeStructure(const std::vector<AsmCodeFlowEntry>& codeFlow,
              size_t codeSize, const cxbyte* code)
 {
     ISAAssembler* isaAsm = assembler.isaAssembler;
     if (codeSize == 0)
         return;
+    // get register types number (needed by later stages)
+    cxuint maxRegs[MAX_REGTYPES_NUM];
+    isaAsm->getMaxRegistersNum(regTypesNum, maxRegs);
     std::vector<size_t> splits;
     std::vector<size_t> codeStarts;
     std::vector<size_t> codeEnds;
@@ -752,6 +862,100 @@ void AsmRegAllocator::applySSAReplaces()
     ssaReplacesMap.clear();
 }
 
+/*
+ * interference graph
+ */
+
+void AsmRegAllocator::InterGraph::resize(size_t _nodesNum)
+{
+    nodesNum = _nodesNum;
+    matrix.clear();
+    nodeEdges.clear();
+    adjStarts.clear();
+    adjNodes.clear();
+    if (nodesNum <= maxMatrixNodesNum)
+    {
+        rowWords = (nodesNum + 63) >> 6;
+        matrix.resize(nodesNum * rowWords);
+    }
+    else
+    {
+        rowWords = 0;
+        nodeEdges.resize(nodesNum);
+    }
+    adjStarts.resize(nodesNum+1);
+    std::fill(adjStarts.begin(), adjStarts.end(), size_t(0));
+}
+
+void AsmRegAllocator::InterGraph::addEdges(size_t node, const std::vector<size_t>& nodes)
+{
+    if (rowWords != 0)
+    {
+        uint64_t* row = matrix.data() + node*rowWords;
+        for (size_t node2: nodes)
+        {
+            row[node2>>6] |= 1ULL<<(node2&63);
+            matrix[node2*rowWords + (node>>6)] |= 1ULL<<(node&63);
+        }
+    }
+    else
+        for (size_t node2: nodes)
+        {
+            nodeEdges[node].push_back(node2);
+            nodeEdges[node2].push_back(node);
+        }
+}
+
+void AsmRegAllocator::InterGraph::finalize()
+{
+    // count neighbors
+    adjStarts[0] = 0;
+    for (size_t node = 0; node < nodesNum; node++)
+    {
+        size_t count = 0;
+        if (rowWords != 0)
+        {
+            const uint64_t* row = matrix.data() + node*rowWords;
+            for (size_t w = 0; w < rowWords; w++)
+                for (uint64_t word = row[w]; word != 0; word &= word-1)
+                    count++;
+        }
+        else
+        {
+            std::vector<size_t>& edges = nodeEdges[node];
+            std::sort(edges.begin(), edges.end());
+            edges.resize(std::unique(edges.begin(), edges.end()) - edges.begin());
+            count = edges.size();
+        }
+        adjStarts[node+1] = adjStarts[node] + count;
+    }
+    // fill adjacency lists
+    adjNodes.resize(adjStarts[nodesNum]);
+    for (size_t node = 0; node < nodesNum; node++)
+    {
+        size_t* out = adjNodes.data() + adjStarts[node];
+        if (rowWords != 0)
+        {
+            const uint64_t* row = matrix.data() + node*rowWords;
+            for (size_t w = 0; w < rowWords; w++)
+                for (uint64_t word = row[w]; word != 0; word &= word-1)
+                    *out++ = (w<<6) + CTZ64(word);
+        }
+        else
+        {
+            std::copy(nodeEdges[node].begin(), nodeEdges[node].end(), out);
+            std::vector<size_t>().swap(nodeEdges[node]);
+        }
+    }
+}
+
+bool AsmRegAllocator::InterGraph::hasEdge(size_t node1, size_t node2) const
+{
+    if (rowWords != 0)
+        return (matrix[node1*rowWords + (node2>>6)] & (1ULL<<(node2&63))) != 0;
+    return std::binary_search(adjBegin(node1), adjEnd(node1), node2);
+}
+
 void AsmRegAllocator::createInterferenceGraph()
 {
     /// construct liveBlockMaps
@@ -771,42 +975,29 @@ void AsmRegAllocator::createInterferenceGraph()
         liveness.clear();
     }
     
-    // create interference graphs
+    // create interference graphs (edge between every overlapping live blocks)
+    std::vector<std::pair<size_t, size_t> > activeBlocks; // end and vidx
+    std::vector<size_t> activeVidxes;
     for (size_t regType = 0; regType < regTypesNum; regType++)
     {
         InterGraph& interGraph = interGraphs[regType];
         interGraph.resize(graphVregsCounts[regType]);
-        std::set<LiveBlock>& liveBlockMap = liveBlockMaps[regType];
-        
-        auto lit = liveBlockMap.begin();
-        size_t rangeStart = 0;
-        if (lit != liveBlockMap.end())
-            rangeStart = lit->start;
-        while (lit != liveBlockMap.end())
+        activeBlocks.clear();
+        // live blocks are sorted by start
+        for (const LiveBlock& block: liveBlockMaps[regType])
         {
-            const size_t blkStart = lit->start;
-            const size_t blkEnd = lit->end;
-            size_t rangeEnd = blkEnd;
-            auto liStart = liveBlockMap.lower_bound({ rangeStart, 0, 0 });
-            auto liEnd = liveBlockMap.lower_bound({ rangeEnd, 0, 0 });
-            // collect from this range, variable indices
-            std::set<size_t> varIndices;
-            for (auto lit2 = liStart; lit2 != liEnd; ++lit2)
-                varIndices.insert(lit2->vidx);
-            // push to intergraph as full subgGraph
-            for (auto vit = varIndices.begin(); vit != varIndices.end(); ++vit)
-                for (auto vit2 = varIndices.begin(); vit2 != varIndices.end(); ++vit2)
-                    if (vit != vit2)
-                        interGraph[*vit].insert(*vit2);
-            // go to next live blocks
-            rangeStart = rangeEnd;
-            for (; lit != liveBlockMap.end(); ++lit)
-                if (lit->start != blkStart && lit->end != blkEnd)
-                    break;
-            if (lit == liveBlockMap.end())
-                break; // 
-            rangeStart = std::max(rangeStart, lit->start);
+            // remove live blocks that ends before this block
+            activeBlocks.erase(std::remove_if(activeBlocks.begin(), activeBlocks.end(),
+                    [&block](const std::pair<size_t, size_t>& active)
+                    { return active.first <= block.start; }), activeBlocks.end());
+            activeVidxes.clear();
+            for (const std::pair<size_t, size_t>& active: activeBlocks)
+                if (active.second != block.vidx)
+                    activeVidxes.push_back(active.second);
+            interGraph.addEdges(block.vidx, activeVidxes);
+            activeBlocks.push_back({ block.end, block.vidx });
         }
+        interGraph.finalize();
     }
 }
 
@@ -819,6 +1010,76 @@ void AsmRegAllocator::createInterferenceGraph()
  *               try to link free ends of two distinct regranges
  */
 
+namespace CLRX
+{
+
+/* bucket queue for DSATUR: nodes are grouped by saturation degree and inside
+ * bucket are ordered by rank (nodes with greater degree have smaller rank).
+ * every bucket is two-level bitset (summary bit for every 64-bit word) */
+class CLRX_INTERNAL DSaturQueue
+{
+private:
+    size_t wordsNum;
+    size_t summaryWordsNum;
+    size_t maxSat;
+    size_t nodesCount;
+    std::vector<std::vector<uint64_t> > buckets;
+    std::vector<std::vector<uint64_t> > summaries;
+    std::vector<size_t> bucketCounts;
+public:
+    explicit DSaturQueue(size_t nodesNum) : wordsNum((nodesNum+63)>>6),
+            summaryWordsNum((wordsNum+63)>>6), maxSat(0), nodesCount(0)
+    { }
+    
+    bool empty() const
+    { return nodesCount == 0; }
+    
+    void insert(size_t sat, size_t rank)
+    {
+        if (sat >= buckets.size())
+        {
+            buckets.resize(sat+1);
+            summaries.resize(sat+1);
+            bucketCounts.resize(sat+1, 0);
+        }
+        if (buckets[sat].empty())
+        {
+            buckets[sat].resize(wordsNum, 0);
+            summaries[sat].resize(summaryWordsNum, 0);
+        }
+        buckets[sat][rank>>6] |= 1ULL<<(rank&63);
+        summaries[sat][rank>>12] |= 1ULL<<((rank>>6)&63);
+        bucketCounts[sat]++;
+        nodesCount++;
+        maxSat = std::max(maxSat, sat);
+    }
+    
+    void erase(size_t sat, size_t rank)
+    {
+        uint64_t& word = buckets[sat][rank>>6];
+        word &= ~(1ULL<<(rank&63));
+        if (word == 0)
+            summaries[sat][rank>>12] &= ~(1ULL<<((rank>>6)&63));
+        bucketCounts[sat]--;
+        nodesCount--;
+    }
+    
+    // get node rank with greatest saturation and smallest rank (queue must not be empty)
+    size_t top()
+    {
+        while (bucketCounts[maxSat] == 0)
+            maxSat--;
+        const std::vector<uint64_t>& summary = summaries[maxSat];
+        size_t sw = 0;
+        while (summary[sw] == 0)
+            sw++;
+        const size_t w = (sw<<6) + CTZ64(summary[sw]);
+        return (w<<6) + CTZ64(buckets[maxSat][w]);
+    }
+};
+
+};
+
 void AsmRegAllocator::colorInterferenceGraph()
 {
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
@@ -827,94 +1088,178 @@ void AsmRegAllocator::colorInterferenceGraph()
     for (size_t regType = 0; regType < regTypesNum; regType++)
     {
         const size_t maxColorsNum = getGPUMaxRegistersNum(arch, regType);
-        InterGraph& interGraph = interGraphs[regType];
+        const InterGraph& interGraph = interGraphs[regType];
         const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
         Array<cxuint>& gcMap = graphColorMaps[regType];
         
         const size_t nodesNum = interGraph.size();
         gcMap.resize(nodesNum);
         std::fill(gcMap.begin(), gcMap.end(), cxuint(UINT_MAX));
-        Array<size_t> sdoCounts(nodesNum);
-        std::fill(sdoCounts.begin(), sdoCounts.end(), 0);
+        if (nodesNum == 0)
+            continue;
         
-        SDOLDOCompare compare(interGraph, sdoCounts);
-        std::set<size_t, SDOLDOCompare> nodeSet(compare);
+        // rank nodes by degree (greatest degree first)
+        Array<size_t> rankNodes(nodesNum);
+        for (size_t i = 0; i < nodesNum; i++)
+            rankNodes[i] = i;
+        std::stable_sort(rankNodes.begin(), rankNodes.end(),
+                [&interGraph](size_t a, size_t b)
+                { return interGraph.degree(a) > interGraph.degree(b); });
+        Array<size_t> nodeRanks(nodesNum);
         for (size_t i = 0; i < nodesNum; i++)
-            nodeSet.insert(i);
+            nodeRanks[rankNodes[i]] = i;
         
-        cxuint colorsNum = 0;
-        // firstly, allocate real registers
+        size_t realRegsNum = 0;
         for (const auto& entry: vregIndexMap)
             if (entry.first.regVar == nullptr)
-                gcMap[entry.second[0]] = colorsNum++;
+                realRegsNum++;
+        // bitsets of colors of neighbors (with extra bit for new color)
+        const size_t colorWords = (std::max(maxColorsNum, realRegsNum) + 64) >> 6;
+        Array<uint64_t> nbColors(nodesNum * colorWords);
+        std::fill(nbColors.begin(), nbColors.end(), uint64_t(0));
+        Array<size_t> satDegrees(nodesNum);
+        std::fill(satDegrees.begin(), satDegrees.end(), size_t(0));
+        
+        DSaturQueue queue(nodesNum);
+        for (size_t i = 0; i < nodesNum; i++)
+            queue.insert(0, i);
         
-        for (size_t colored = 0; colored < nodesNum; colored++)
+        auto setColor = [&](size_t node, cxuint color)
         {
-            size_t node = *nodeSet.begin();
-            if (gcMap[node] != UINT_MAX)
-                continue; // already colored
-            size_t color = 0;
-            
-            for (color = 0; color <= colorsNum; color++)
+            gcMap[node] = color;
+            queue.erase(satDegrees[node], nodeRanks[node]);
+            // update saturation degree of neighbors
+            for (const size_t* nbIt = interGraph.adjBegin(node);
+                        nbIt != interGraph.adjEnd(node); ++nbIt)
             {
-                // find first usable color
-                bool thisSame = false;
-                for (size_t nb: interGraph[node])
-                    if (gcMap[nb] == color)
-                    {
-                        thisSame = true;
-                        break;
-                    }
-                if (!thisSame)
-                    break;
+                const size_t nb = *nbIt;
+                uint64_t& word = nbColors[nb*colorWords + (color>>6)];
+                const uint64_t bit = 1ULL<<(color&63);
+                if (gcMap[nb] != UINT_MAX || (word & bit) != 0)
+                    continue;
+                word |= bit;
+                queue.erase(satDegrees[nb], nodeRanks[nb]);
+                queue.insert(++satDegrees[nb], nodeRanks[nb]);
             }
-            if (color==colorsNum) // add new color if needed
+        };
+        
+        cxuint colorsNum = 0;
+        // firstly, allocate real registers
+        for (const auto& entry: vregIndexMap)
+            if (entry.first.regVar == nullptr)
+                setColor(entry.second[0], colorsNum++);
+        
+        while (!queue.empty())
+        {
+            const size_t node = rankNodes[queue.top()];
+            // find first usable color
+            const uint64_t* colors = nbColors.data() + node*colorWords;
+            size_t w = 0;
+            while (colors[w] == UINT64_MAX)
+                w++;
+            const cxuint color = (w<<6) + CTZ64(~colors[w]);
+            if (color >= colorsNum) // add new color if needed
             {
                 if (colorsNum >= maxColorsNum)
                     throw AsmException("Too many register is needed");
                 colorsNum++;
             }
-            
-            gcMap[node] = color;
-            // update SDO for node
-            bool colorExists = false;
-            for (size_t nb: interGraph[node])
-                if (gcMap[nb] == color)
-                {
-                    colorExists = true;
-                    break;
-                }
-            if (!colorExists)
-                sdoCounts[node]++;
-            // update SDO for neighbors
-            for (size_t nb: interGraph[node])
-            {
-                colorExists = false;
-                for (size_t nb2: interGraph[nb])
-                    if (gcMap[nb2] == color)
+            setColor(node, color);
+        }
+    }
+}
+
+/* linear scan: every variable gets single live interval (from first start to
+ * last end of its live blocks). Intervals are visited by start, and expired
+ * intervals return their colors to free colors. Colors of real registers
+ * are reserved for whole code, hence they are not shared with variables */
+void AsmRegAllocator::linearScanRegisters()
+{
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
+                    assembler.deviceType);
+    
+    for (size_t regType = 0; regType < regTypesNum; regType++)
+    {
+        const size_t maxColorsNum = getGPUMaxRegistersNum(arch, regType);
+        const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
+        const Array<OutLiveness>& liveness = outLivenesses[regType];
+        Array<cxuint>& gcMap = graphColorMaps[regType];
+        
+        const size_t nodesNum = graphVregsCounts[regType];
+        gcMap.resize(nodesNum);
+        std::fill(gcMap.begin(), gcMap.end(), cxuint(UINT_MAX));
+        if (nodesNum == 0)
+            continue;
+        
+        cxuint colorsNum = 0;
+        // firstly, allocate real registers
+        for (const auto& entry: vregIndexMap)
+            if (entry.first.regVar == nullptr)
+                gcMap[entry.second[0]] = colorsNum++;
+        
+        // collect live intervals of variables (start, end, vidx)
+        std::vector<LiveBlock> intervals;
+        for (size_t vidx = 0; vidx < nodesNum; vidx++)
+        {
+            if (gcMap[vidx] != UINT_MAX)
+                continue;
+            size_t start = SIZE_MAX, end = 0;
+            if (vidx < liveness.size())
+                for (const std::pair<size_t, size_t>& blk: liveness[vidx])
+                    if (blk.first != blk.second)
                     {
-                        colorExists = true;
-                        break;
+                        start = std::min(start, blk.first);
+                        end = std::max(end, blk.second);
                     }
-                if (!colorExists)
-                {
-                    if (gcMap[nb] == UINT_MAX)
-                        nodeSet.erase(nb);  // before update we erase from nodeSet
-                    sdoCounts[nb]++;
-                    if (gcMap[nb] == UINT_MAX)
-                        nodeSet.insert(nb); // after update, insert again
-                }
+            if (start >= end)
+            {
+                // variable without live blocks still needs register (point interval)
+                start = (vidx < liveness.size() && !liveness[vidx].empty()) ?
+                        liveness[vidx][0].first : 0;
+                end = start+1;
             }
-            
-            gcMap[node] = color;
+            intervals.push_back({ start, end, vidx });
+        }
+        std::sort(intervals.begin(), intervals.end());
+        
+        // active intervals (end and color) and free colors (min heaps)
+        typedef std::pair<size_t, cxuint> ActiveEntry;
+        std::priority_queue<ActiveEntry, std::vector<ActiveEntry>,
+                std::greater<ActiveEntry> > actives;
+        std::priority_queue<cxuint, std::vector<cxuint>, std::greater<cxuint> > freeColors;
+        for (const LiveBlock& interval: intervals)
+        {
+            // expire intervals that ends before this interval
+            while (!actives.empty() && actives.top().first <= interval.start)
+            {
+                freeColors.push(actives.top().second);
+                actives.pop();
+            }
+            cxuint color;
+            if (!freeColors.empty())
+            {
+                color = freeColors.top();
+                freeColors.pop();
+            }
+            else
+            {
+                // add new color if needed
+                if (colorsNum >= maxColorsNum)
+                    throw AsmException("Too many register is needed");
+                color = colorsNum++;
+            }
+            gcMap[interval.vidx] = color;
+            actives.push({ interval.end, color });
         }
     }
 }
 
 void AsmRegAllocator::allocateRegisters(AsmSectionId sectionId)
 {
+    ASM_STATS_PHASE(assembler, AsmPhase::REG_ALLOC)
     // before any operation, clear all
     codeBlocks.clear();
+    usageArrays.clear();
     for (size_t i = 0; i < MAX_REGTYPES_NUM; i++)
     {
         graphVregsCounts[i] = 0;
@@ -933,6 +1278,13 @@ void AsmRegAllocator::allocateRegisters(AsmSectionId sectionId)
     createSSAData(*section.usageHandler, *section.linearDepHandler);
     applySSAReplaces();
     createLivenesses(*section.usageHandler, *section.linearDepHandler);
-    createInterferenceGraph();
-    colorInterferenceGraph();
+    if (section.waitHandler != nullptr)
+        extendDelayedOpLivenesses(*section.waitHandler);
+    if (allocMode == AsmRegAllocMode::LINEAR_SCAN)
+        linearScanRegisters();
+    else
+    {
+        createInterferenceGraph();
+        colorInterferenceGraph();
+    }
 }
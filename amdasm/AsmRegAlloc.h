@@ -452,22 +452,58 @@ typedef std::unordered_map<size_t, LinearDep> LinearDepMap;
 
 typedef AsmRegAllocator::InterGraph InterGraph;
 
-struct CLRX_INTERNAL SDOLDOCompare
+// get indices of next blocks for every code block (for dataflow passes).
+// routine returns goes to all blocks after calls
+extern CLRX_INTERNAL void getCodeBlockNexts(const std::vector<CodeBlock>& codeBlocks,
+            std::vector<std::vector<size_t> >& nextBlocks);
+
+/* pending delayed operations stuff (used by wait scheduler and register allocator).
+ * laterCount is number of counter units of later delayed operations with same type */
+
+// get number of counter units of delayed operation for its type
+static inline uint16_t getDelayedOpUnits(const AsmWaitConfig& waitConfig,
+            const AsmDelayedOp& delOp, cxbyte type)
 {
-    const InterGraph& interGraph;
-    const Array<size_t>& sdoCounts;
-    
-    SDOLDOCompare(const InterGraph& _interGraph, const Array<size_t>&_sdoCounts)
-        : interGraph(_interGraph), sdoCounts(_sdoCounts)
-    { }
-    
-    bool operator()(size_t a, size_t b) const
+    const cxbyte counting = waitConfig.delayInstrTypes[type].counting;
+    return (counting == 255) ? 1 : std::max(1, (delOp.count + counting-1) / counting);
+}
+
+// merge sorted pending operations (compared without laterCount) to destination,
+// for same operations choose smaller laterCount. return true if destination changed
+template<typename T>
+bool mergePendingOps(std::vector<T>& dest, const std::vector<T>& src)
+{
+    std::vector<T> merged;
+    merged.reserve(dest.size() + src.size());
+    bool changed = false;
+    auto dit = dest.begin();
+    auto sit = src.begin();
+    while (dit != dest.end() || sit != src.end())
     {
-        if (sdoCounts[a] > sdoCounts[b])
-            return true;
-        return interGraph[a].size() > interGraph[b].size();
+        if (sit == src.end() || (dit != dest.end() && *dit < *sit))
+            merged.push_back(*dit++);
+        else if (dit == dest.end() || *sit < *dit)
+        {
+            merged.push_back(*sit++);
+            changed = true;
+        }
+        else
+        {
+            // same operation, choose smaller laterCount
+            merged.push_back(*dit);
+            if (sit->laterCount < dit->laterCount)
+            {
+                merged.back().laterCount = sit->laterCount;
+                changed = true;
+            }
+            ++dit;
+            ++sit;
+        }
     }
-};
+    if (changed)
+        dest.swap(merged);
+    return changed;
+}
 
 };
 
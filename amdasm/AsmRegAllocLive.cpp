@@ -1202,6 +1202,8 @@ void AsmRegAllocator::createLivenesses(ISAUsageHandler& usageHandler,
                 ISALinearDepHandler& linDepHandler)
 {
     ARDOut << "----- createLivenesses ------\n";
+    // usages are decoded by createSSAData
+    const size_t instrsNum = usageArrays.getInstrsNum();
     // construct var index maps
     cxuint regRanges[MAX_REGTYPES_NUM*2];
     std::fill(graphVregsCounts, graphVregsCounts+MAX_REGTYPES_NUM, size_t(0));
@@ -1328,11 +1330,14 @@ void AsmRegAllocator::createLivenesses(ISAUsageHandler& usageHandler,
                 SVRegMap ssaIdIdxMap;
                 std::vector<AsmRegVarUsage> instrRVUs;
                 
-                size_t oldOffset = cblock.usagePos.readOffset;
+                size_t instrIndex = cblock.usagePos;
+                size_t usageIndex = (instrIndex < instrsNum) ?
+                        usageArrays.instrUsageStarts[instrIndex] : 0;
+                size_t oldOffset = (instrIndex < instrsNum) ?
+                        usageArrays.instrOffsets[instrIndex] : cblock.end;
                 std::vector<AsmSingleVReg> readSVRegs;
                 std::vector<AsmSingleVReg> writtenSVRegs;
                 
-                usageHandler.setReadPos(cblock.usagePos);
                 linDepHandler.setReadPos(cblock.linearDepPos);
                 
                 // register in liveness
@@ -1340,10 +1345,13 @@ void AsmRegAllocator::createLivenesses(ISAUsageHandler& usageHandler,
                 {
                     AsmRegVarUsage rvu = { 0U, nullptr, 0U, 0U };
                     bool hasNext = false;
-                    if (usageHandler.hasNext() && oldOffset < cblock.end)
+                    if (instrIndex < instrsNum && oldOffset < cblock.end)
                     {
                         hasNext = true;
-                        rvu = usageHandler.nextUsage();
+                        rvu = usageArrays.getUsage(instrIndex, usageIndex++);
+                        // go to next instruction after its last usage
+                        if (usageIndex == usageArrays.instrUsageStarts[instrIndex+1])
+                            instrIndex++;
                     }
                     const size_t liveTime = oldOffset;
                     if ((!hasNext || rvu.offset > oldOffset) && oldOffset < cblock.end)
@@ -1671,3 +1679,276 @@ void AsmRegAllocator::createLivenesses(ISAUsageHandler& usageHandler,
         livenesses2.clear();
     }
 }
+
+/*********
+ * delayed operations livenesses
+ *********/
+
+/* register of delayed operation (load, store, export) can not be assigned to other
+ * variable until operation finishes (until wait for its results). If result is
+ * not read later (or is written by other instruction), liveness of variable
+ * would be too short, hence it is extended to wait instruction that finishes
+ * operation (pending operations are followed by flow like in wait scheduler) */
+
+namespace CLRX
+{
+
+// pending delayed operation that access to register of variable
+struct CLRX_INTERNAL DelayedOpVar
+{
+    cxuint regType;
+    size_t vidx;
+    cxbyte waitType;
+    cxbyte delayedOpType;
+    uint16_t laterCount;
+    size_t start;   // start of region to extend in current block
+    
+    // compare without laterCount and start
+    bool operator<(const DelayedOpVar& v2) const
+    {
+        if (regType != v2.regType)
+            return regType < v2.regType;
+        if (vidx != v2.vidx)
+            return vidx < v2.vidx;
+        if (waitType != v2.waitType)
+            return waitType < v2.waitType;
+        return delayedOpType < v2.delayedOpType;
+    }
+};
+
+typedef std::vector<DelayedOpVar> DelayedOpState;
+
+struct CLRX_INTERNAL DelayedOpLvContext
+{
+    const AsmWaitConfig& waitConfig;
+    const VarIndexMap* vregIndexMaps;
+    const Array<AsmRegAllocator::OutLiveness>* outLivenesses;
+    size_t regTypesNum;
+    cxuint regRanges[MAX_REGTYPES_NUM*2];
+    std::vector<AsmDelayedOp> delayedOps;
+    std::vector<AsmWaitInstr> waitInstrs;
+};
+
+struct CLRX_INTERNAL DelayedOpLvRegion
+{
+    cxuint regType;
+    size_t vidx;
+    size_t start;
+    size_t end;
+    
+    bool operator<(const DelayedOpLvRegion& r2) const
+    {
+        return regType < r2.regType || (regType == r2.regType &&
+            (vidx < r2.vidx || (vidx == r2.vidx && start < r2.start)));
+    }
+};
+
+};
+
+// find variable (vidx) of svreg that is live at specified position
+static size_t findLiveVIdx(const DelayedOpLvContext& ctx, cxuint regType,
+            const AsmSingleVReg& svreg, size_t pos)
+{
+    auto it = ctx.vregIndexMaps[regType].find(svreg);
+    if (it == ctx.vregIndexMaps[regType].end())
+        return SIZE_MAX;
+    for (size_t vidx: it->second)
+    {
+        if (vidx == SIZE_MAX)
+            continue;
+        const AsmRegAllocator::OutLiveness& lv = ctx.outLivenesses[regType][vidx];
+        auto lvit = std::upper_bound(lv.begin(), lv.end(), std::make_pair(pos, SIZE_MAX));
+        if (lvit != lv.begin() && (lvit-1)->second > pos)
+            return vidx;
+    }
+    return SIZE_MAX;
+}
+
+// remove finished pending operations and put their regions (if not null)
+template<typename F>
+static void finishDelayedOps(DelayedOpState& state, F isFinished, size_t end,
+            std::vector<DelayedOpLvRegion>* regions)
+{
+    auto newEnd = std::remove_if(state.begin(), state.end(),
+        [&isFinished, regions, end](const DelayedOpVar& op)
+        {
+            if (!isFinished(op))
+                return false;
+            if (regions != nullptr)
+                regions->push_back({ op.regType, op.vidx, op.start, end });
+            return true;
+        });
+    state.erase(newEnd, state.end());
+}
+
+// process code block, update pending operations, put regions to extend (if not null)
+static void processDelayedOpLvBlock(const DelayedOpLvContext& ctx,
+            const CodeBlock& block, DelayedOpState& state,
+            std::vector<DelayedOpLvRegion>* regions)
+{
+    const AsmWaitConfig& waitConfig = ctx.waitConfig;
+    auto delOpIt = std::lower_bound(ctx.delayedOps.begin(), ctx.delayedOps.end(),
+            block.start, [](const AsmDelayedOp& op, size_t offset)
+            { return op.offset < offset; });
+    auto waitIt = std::lower_bound(ctx.waitInstrs.begin(), ctx.waitInstrs.end(),
+            block.start, [](const AsmWaitInstr& wi, size_t offset)
+            { return wi.offset < offset; });
+    
+    for (DelayedOpVar& op: state)
+        op.start = block.start;
+    DelayedOpState newOps;
+    while (true)
+    {
+        size_t offset = block.end;
+        if (delOpIt != ctx.delayedOps.end())
+            offset = std::min(offset, delOpIt->offset);
+        if (waitIt != ctx.waitInstrs.end())
+            offset = std::min(offset, waitIt->offset);
+        if (offset >= block.end)
+            break;
+        
+        // apply wait instruction from code
+        for (; waitIt != ctx.waitInstrs.end() && waitIt->offset == offset; ++waitIt)
+        {
+            const uint16_t* waits = waitIt->waits;
+            finishDelayedOps(state, [waits](const DelayedOpVar& op)
+                    { return op.laterCount >= waits[op.waitType]; }, offset+1, regions);
+        }
+        if (delOpIt == ctx.delayedOps.end() || delOpIt->offset != offset)
+            continue;
+        
+        // count units of delayed operations of this instruction (for every type)
+        uint16_t typeUnits[ASM_DELAY_INSTR_MAX_TYPES_NUM] = { };
+        auto delOpEnd = delOpIt;
+        for (; delOpEnd != ctx.delayedOps.end() && delOpEnd->offset == offset;
+                    ++delOpEnd)
+            for (cxbyte type: { delOpEnd->delayedOpType, delOpEnd->delayedOpType2 })
+                if (type < waitConfig.delayInstrTypesNum)
+                    typeUnits[type] = std::max(typeUnits[type],
+                            getDelayedOpUnits(waitConfig, *delOpEnd, type));
+        // update laterCount for pending operations and remove finished
+        // (registers are still used by this instruction)
+        for (DelayedOpVar& op: state)
+            if (waitConfig.delayInstrTypes[op.delayedOpType].ordered)
+                op.laterCount = std::min(op.laterCount + typeUnits[op.delayedOpType],
+                        waitConfig.waitQueueSizes[op.waitType]-1);
+        finishDelayedOps(state, [&waitConfig](const DelayedOpVar& op)
+                { return op.laterCount >= waitConfig.waitQueueSizes[op.waitType]-1; },
+                offset+2, regions);
+        
+        // add new pending operations
+        newOps.clear();
+        for (; delOpIt != delOpEnd; ++delOpIt)
+            for (cxbyte type: { delOpIt->delayedOpType, delOpIt->delayedOpType2 })
+            {
+                if (type >= waitConfig.delayInstrTypesNum)
+                    continue;
+                const AsmDelayInstrTypeEntry& entry = waitConfig.delayInstrTypes[type];
+                const bool readOut = entry.finishOnRegReadOut;
+                if ((delOpIt->rwFlags & (readOut ? ASMRVU_READ : ASMRVU_WRITE)) == 0)
+                    continue;
+                // read register is live at instruction, written after instruction
+                const size_t pos = readOut ? offset : offset+1;
+                for (uint16_t r = delOpIt->rstart; r < delOpIt->rend; r++)
+                {
+                    const AsmSingleVReg svreg{ delOpIt->regVar, r };
+                    const cxuint regType = getRegType(ctx.regTypesNum, ctx.regRanges,
+                                svreg);
+                    if (regType >= ctx.regTypesNum)
+                        continue;
+                    const size_t vidx = findLiveVIdx(ctx, regType, svreg, pos);
+                    if (vidx != SIZE_MAX)
+                        newOps.push_back({ regType, vidx, entry.waitType, type, 0, pos });
+                }
+            }
+        std::sort(newOps.begin(), newOps.end());
+        newOps.erase(std::unique(newOps.begin(), newOps.end(),
+                [](const DelayedOpVar& op1, const DelayedOpVar& op2)
+                { return !(op1 < op2) && !(op2 < op1); }), newOps.end());
+        mergePendingOps(state, newOps);
+    }
+    // not finished operations are pending to end of block
+    if (regions != nullptr)
+        for (const DelayedOpVar& op: state)
+            regions->push_back({ op.regType, op.vidx, op.start, block.end });
+}
+
+void AsmRegAllocator::extendDelayedOpLivenesses(ISAWaitHandler& waitHandler)
+{
+    if (codeBlocks.empty())
+        return;
+    DelayedOpLvContext ctx{ assembler.isaAssembler->getWaitConfig(),
+                vregIndexMaps, outLivenesses };
+    assembler.isaAssembler->getRegisterRanges(ctx.regTypesNum, ctx.regRanges);
+    waitHandler.rewind();
+    while (waitHandler.hasNext())
+    {
+        AsmDelayedOp delOp;
+        AsmWaitInstr waitInstr;
+        if (waitHandler.nextInstr(delOp, waitInstr))
+            ctx.waitInstrs.push_back(waitInstr);
+        else
+            ctx.delayedOps.push_back(delOp);
+    }
+    if (ctx.delayedOps.empty())
+        return;
+    
+    const size_t blocksNum = codeBlocks.size();
+    std::vector<std::vector<size_t> > nextBlocks;
+    getCodeBlockNexts(codeBlocks, nextBlocks);
+    
+    // find pending operations at block starts (until fixpoint)
+    std::vector<DelayedOpState> inStates(blocksNum);
+    std::vector<bool> inWorkList(blocksNum, true);
+    std::deque<size_t> workList;
+    for (size_t i = 0; i < blocksNum; i++)
+        workList.push_back(i);
+    while (!workList.empty())
+    {
+        const size_t i = workList.front();
+        workList.pop_front();
+        inWorkList[i] = false;
+        DelayedOpState state = inStates[i];
+        processDelayedOpLvBlock(ctx, codeBlocks[i], state, nullptr);
+        for (size_t next: nextBlocks[i])
+            if (mergePendingOps(inStates[next], state) && !inWorkList[next])
+            {
+                inWorkList[next] = true;
+                workList.push_back(next);
+            }
+    }
+    
+    // collect regions where registers are used by pending operations
+    std::vector<DelayedOpLvRegion> regions;
+    for (size_t i = 0; i < blocksNum; i++)
+    {
+        DelayedOpState state = inStates[i];
+        processDelayedOpLvBlock(ctx, codeBlocks[i], state, &regions);
+    }
+    std::sort(regions.begin(), regions.end());
+    
+    // extend livenesses by these regions
+    std::vector<std::pair<size_t, size_t> > newLv;
+    for (auto rit = regions.begin(); rit != regions.end(); )
+    {
+        OutLiveness& lv = outLivenesses[rit->regType][rit->vidx];
+        newLv.assign(lv.begin(), lv.end());
+        auto rit2 = rit;
+        for (; rit2 != regions.end() && rit2->regType == rit->regType &&
+                    rit2->vidx == rit->vidx; ++rit2)
+            if (rit2->start < rit2->end)
+                newLv.push_back({ rit2->start, rit2->end });
+        rit = rit2;
+        // sort and join overlapping regions
+        std::sort(newLv.begin(), newLv.end());
+        size_t j = 0;
+        for (size_t k = 1; k < newLv.size(); k++)
+            if (newLv[k].first <= newLv[j].second)
+                newLv[j].second = std::max(newLv[j].second, newLv[k].second);
+            else
+                newLv[++j] = newLv[k];
+        newLv.resize(newLv.empty() ? 0 : j+1);
+        lv.resize(newLv.size());
+        std::copy(newLv.begin(), newLv.end(), lv.begin());
+    }
+}
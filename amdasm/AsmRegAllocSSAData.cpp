@@ -1386,20 +1386,30 @@ static void createRoutineData(const std::vector<CodeBlock>& codeBlocks,
     ARDOut << "--------- createRoutineData end ------------\n";
 }
 
+void AsmRegAllocator::createUsageArrays(ISAUsageHandler& usageHandler)
+{
+    usageArrays.assign(usageHandler);
+    // set first instruction of code blocks (code blocks are sorted)
+    const size_t instrsNum = usageArrays.getInstrsNum();
+    size_t instrIndex = 0;
+    for (CodeBlock& cblock: codeBlocks)
+    {
+        while (instrIndex < instrsNum &&
+                usageArrays.instrOffsets[instrIndex] < cblock.start)
+            instrIndex++;
+        cblock.usagePos = instrIndex;
+    }
+}
+
 void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler,
                 ISALinearDepHandler& linDepHandler)
 {
     if (codeBlocks.empty())
         return;
-    usageHandler.rewind();
-    auto cbit = codeBlocks.begin();
-    AsmRegVarUsage rvu;
-    
-    if (!usageHandler.hasNext())
+    createUsageArrays(usageHandler);
+    const size_t instrsNum = usageArrays.getInstrsNum();
+    if (instrsNum == 0)
         return; // do nothing if no regusages
-    ISAUsageHandler::ReadPos oldReadPos = usageHandler.getReadPos();
-    // old linear deps position
-    rvu = usageHandler.nextUsage();
     
     cxuint regRanges[MAX_REGTYPES_NUM*2];
     cxuint realRegsCount[MAX_REGTYPES_NUM];
@@ -1407,71 +1417,53 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler,
     size_t regTypesNum;
     assembler.isaAssembler->getRegisterRanges(regTypesNum, regRanges);
     
-    while (true)
+    for (CodeBlock& cblock: codeBlocks)
     {
-        while (cbit != codeBlocks.end() && cbit->end <= rvu.offset)
-        {
-            cbit->usagePos = oldReadPos;
-            ++cbit;
-        }
-        if (cbit == codeBlocks.end())
-            break;
-        // skip rvu's before codeblock
-        while (rvu.offset < cbit->start && usageHandler.hasNext())
-        {
-            oldReadPos = usageHandler.getReadPos();
-            rvu = usageHandler.nextUsage();
-        }
-        if (rvu.offset < cbit->start)
-            break;
+        size_t instrIndex = cblock.usagePos;
+        if (instrIndex == instrsNum)
+            break; // no usages after this codeblock
         
-        cbit->usagePos = oldReadPos;
         std::unordered_map<AsmSingleVReg, SSAInfo> ssaInfoMap;
-        while (rvu.offset < cbit->end)
-        {
-            // process rvu
-            // only if regVar
-            for (uint16_t rindex = rvu.rstart; rindex < rvu.rend; rindex++)
+        for (; instrIndex < instrsNum &&
+                usageArrays.instrOffsets[instrIndex] < cblock.end; instrIndex++)
+            for (size_t ui = usageArrays.instrUsageStarts[instrIndex];
+                    ui < usageArrays.instrUsageStarts[instrIndex+1]; ui++)
             {
-                auto res = ssaInfoMap.insert(
-                        { AsmSingleVReg{ rvu.regVar, rindex }, SSAInfo() });
-                
-                SSAInfo& sinfo = res.first->second;
-                if (res.second)
-                    sinfo.firstPos = rvu.offset;
-                sinfo.lastPos = rvu.offset;
-                
-                const bool writeWithSSA = checkWriteWithSSA(rvu);
-                if (!writeWithSSA && (sinfo.ssaIdChange == 0 ||
-                    // if first write RVU instead read RVU
-                    (sinfo.ssaIdChange == 1 && sinfo.firstPos==rvu.offset)))
-                    sinfo.readBeforeWrite = true;
-                /* change SSA id only for write-only regvars -
-                 *   read-write place can not have two different variables */
-                if (writeWithSSA)
-                    sinfo.ssaIdChange++;
-                if (rvu.regVar==nullptr)
-                    sinfo.ssaIdBefore = sinfo.ssaIdFirst =
-                            sinfo.ssaId = sinfo.ssaIdLast = 0;
+                // process rvu
+                const AsmRegVarUsage rvu = usageArrays.getUsage(instrIndex, ui);
+                for (uint16_t rindex = rvu.rstart; rindex < rvu.rend; rindex++)
+                {
+                    auto res = ssaInfoMap.insert(
+                            { AsmSingleVReg{ rvu.regVar, rindex }, SSAInfo() });
+                    
+                    SSAInfo& sinfo = res.first->second;
+                    if (res.second)
+                        sinfo.firstPos = rvu.offset;
+                    sinfo.lastPos = rvu.offset;
+                    
+                    const bool writeWithSSA = checkWriteWithSSA(rvu);
+                    if (!writeWithSSA && (sinfo.ssaIdChange == 0 ||
+                        // if first write RVU instead read RVU
+                        (sinfo.ssaIdChange == 1 && sinfo.firstPos==rvu.offset)))
+                        sinfo.readBeforeWrite = true;
+                    /* change SSA id only for write-only regvars -
+                     *   read-write place can not have two different variables */
+                    if (writeWithSSA)
+                        sinfo.ssaIdChange++;
+                    if (rvu.regVar==nullptr)
+                        sinfo.ssaIdBefore = sinfo.ssaIdFirst =
+                                sinfo.ssaId = sinfo.ssaIdLast = 0;
+                }
             }
-            
-            // get next rvusage
-            if (!usageHandler.hasNext())
-                break;
-            oldReadPos = usageHandler.getReadPos();
-            rvu = usageHandler.nextUsage();
-        }
         // prepping ssaInfoMap array in cblock (put and sorting)
-        cbit->ssaInfoMap.resize(ssaInfoMap.size());
-        std::copy(ssaInfoMap.begin(), ssaInfoMap.end(), cbit->ssaInfoMap.begin());
-        mapSort(cbit->ssaInfoMap.begin(), cbit->ssaInfoMap.end());
-        
-        ++cbit;
+        cblock.ssaInfoMap.resize(ssaInfoMap.size());
+        std::copy(ssaInfoMap.begin(), ssaInfoMap.end(), cblock.ssaInfoMap.begin());
+        mapSort(cblock.ssaInfoMap.begin(), cblock.ssaInfoMap.end());
     }
     
     // fillup linear dep position in code blocks
     linDepHandler.rewind();
-    cbit = codeBlocks.begin();
+    auto cbit = codeBlocks.begin();
     
     if (linDepHandler.hasNext())
     {
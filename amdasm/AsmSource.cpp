@@ -24,6 +24,13 @@
 #include <utility>
 #include <algorithm>
 #include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <cstdlib>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdasm/Assembler.h>
 #include "AsmInternals.h"
@@ -68,13 +75,74 @@ AsmMacroSubst::AsmMacroSubst(RefPtr<const AsmMacroSubst> _parent,
 
 /* Asm Macro */
 AsmMacro::AsmMacro(const AsmSourcePos& _pos, const Array<AsmMacroArg>& _args)
-        : contentLineNo(0), sourcePos(_pos), args(_args)
+        : contentLineNo(0), sourcePos(_pos), args(_args), compiled(false)
 { }
 
 AsmMacro::AsmMacro(const AsmSourcePos& _pos, Array<AsmMacroArg>&& _args)
-        : contentLineNo(0), sourcePos(_pos), args(std::move(_args))
+        : contentLineNo(0), sourcePos(_pos), args(std::move(_args)), compiled(false)
 { }
 
+void AsmMacro::compile()
+{
+    /* find substitutions in the same way as AsmMacroInputFilter::readLine
+     * in non-altmacro mode. argument index is index in sorted arguments
+     * (macro input filter holds sorted argument map) */
+    Array<CString> sortedArgNames(args.size());
+    for (size_t i = 0; i < args.size(); i++)
+        sortedArgNames[i] = args[i].name;
+    std::sort(sortedArgNames.begin(), sortedArgNames.end());
+    
+    substitutions.clear();
+    const size_t contentSize = content.size();
+    const char* contentPtr = content.data();
+    size_t pos = 0;
+    while (pos < contentSize)
+    {
+        if (contentPtr[pos] != '\\')
+        {
+            pos++;
+            continue;
+        }
+        // backslash at end of content is just removed
+        Substitution subst{ pos, 0, 0, SUBST_SEPARATOR };
+        pos++;
+        if (pos < contentSize)
+        {
+            if (contentPtr[pos] == '(' && pos+1 < contentSize && contentPtr[pos+1]==')')
+            {
+                subst.length = 2;
+                pos += 2;
+            }
+            else
+            {
+                const char* thisPos = contentPtr + pos;
+                const CString symName = extractSymName(thisPos,
+                            contentPtr+contentSize, false);
+                const CString* it = sortedArgNames.end();
+                if (!symName.empty())
+                    it = binaryFind(sortedArgNames.begin(), sortedArgNames.end(), symName);
+                if (it != sortedArgNames.end())
+                {
+                    subst.type = SUBST_ARG;
+                    subst.argIndex = it - sortedArgNames.begin();
+                    subst.length = symName.size();
+                    pos = thisPos - contentPtr;
+                }
+                else if (contentPtr[pos] == '@')
+                {
+                    subst.type = SUBST_COUNTER;
+                    subst.length = 1;
+                    pos++;
+                }
+                else
+                    subst.type = SUBST_NONE;
+            }
+        }
+        substitutions.push_back(subst);
+    }
+    compiled = true;
+}
+
 void AsmMacro::addLine(RefPtr<const AsmMacroSubst> macro, RefPtr<const AsmSource> source,
            const std::vector<LineTrans>& colTrans, size_t lineSize, const char* line)
 {
@@ -183,6 +251,74 @@ LineCol AsmInputFilter::translatePos(size_t position) const
 
 static const size_t AsmParserLineMaxSize = 200;
 
+static inline bool isSpecialLineChar(unsigned char c)
+{
+    // spaces (except ' '), newline, strings, comments, backslash, statement separator
+    return (cxbyte(c-9) < 5) || c=='"' || c=='\'' || c=='#' || c=='/' ||
+            c=='\\' || c==';';
+}
+
+/* skip characters which are not changed by stream filter in normal mode.
+ * returns pointer to first character which must be handled by the filter */
+static const char* skipPlainLineChars(const char* p, const char* end)
+{
+#ifdef __AVX2__
+    const __m256i v9 = _mm256_set1_epi8(9);
+    const __m256i v4 = _mm256_set1_epi8(4);
+    for (; p+32 <= end; p += 32)
+    {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        // unsigned (v-9) <= 4 - whitespaces without ' '
+        const __m256i t = _mm256_sub_epi8(v, v9);
+        __m256i m = _mm256_cmpeq_epi8(_mm256_min_epu8(t, v4), t);
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\'')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('#')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(';')));
+        const uint32_t mask = _mm256_movemask_epi8(m);
+        if (mask != 0)
+            return p + CTZ32(mask);
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i v9 = _mm_set1_epi8(9);
+    const __m128i v4 = _mm_set1_epi8(4);
+    for (; p+16 <= end; p += 16)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)p);
+        // unsigned (v-9) <= 4 - whitespaces without ' '
+        const __m128i t = _mm_sub_epi8(v, v9);
+        __m128i m = _mm_cmpeq_epi8(_mm_min_epu8(t, v4), t);
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\'')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('#')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('/')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(';')));
+        const uint32_t mask = _mm_movemask_epi8(m);
+        if (mask != 0)
+            return p + CTZ32(mask);
+    }
+#endif
+    for (; p != end && !isSpecialLineChar(*p); p++);
+    return p;
+}
+
+void AsmStreamInputFilter::mapSourceFile(const CString& filename)
+{
+    /* whole file is mapped (or loaded if it is not regular file) and
+     * lines are filtered directly in the mapped (private) memory */
+    try
+    { mappedFile.open(filename.c_str()); }
+    catch(const Exception&)
+    {
+        throw AsmException(std::string("Can't open source file '")+
+                    filename.c_str()+"'");
+    }
+}
+
 AsmStreamInputFilter::AsmStreamInputFilter(const CString& filename)
     : AsmInputFilter(AsmInputFilterType::STREAM), managed(true),
         stream(nullptr), mode(LineMode::NORMAL), stmtPos(0)
@@ -190,12 +326,7 @@ AsmStreamInputFilter::AsmStreamInputFilter(const CString& filename)
     try
     {
         source = RefPtr<const AsmSource>(new AsmFile(filename));
-        stream = new std::ifstream(filename.c_str(), std::ios::binary);
-        if (!*stream)
-            throw AsmException(std::string("Can't open source file '")+
-                    filename.c_str()+"'");
-        stream->exceptions(std::ios::badbit);
-        buffer.reserve(AsmParserLineMaxSize);
+        mapSourceFile(filename);
     }
     catch(...)
     {
@@ -228,13 +359,7 @@ AsmStreamInputFilter::AsmStreamInputFilter(const AsmSourcePos& pos,
                 RefPtr<const AsmSource>(new AsmMacroSource(pos.macro, pos.source)),
                      pos.lineNo, pos.colNo, filename));
         
-        // open file
-        stream = new std::ifstream(filename.c_str(), std::ios::binary);
-        if (!*stream)
-            throw AsmException(std::string("Can't open source file '")+
-                        filename.c_str()+"'");
-        stream->exceptions(std::ios::badbit);
-        buffer.reserve(AsmParserLineMaxSize);
+        mapSourceFile(filename);
     }
     catch(...)
     {
@@ -264,9 +389,29 @@ AsmStreamInputFilter::~AsmStreamInputFilter()
         delete stream;
 }
 
-const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSize)
+const char* AsmStreamInputFilter::filterLine(Assembler& assembler, size_t& lineSize)
 {
     colTranslations.clear();
+    // mapped file content or buffer filled from stream
+    char* data = (stream == nullptr) ? (char*)mappedFile.data() : buffer.data();
+    size_t dataSize = (stream == nullptr) ? mappedFile.size() : buffer.size();
+    if (mode == LineMode::NORMAL && pos < dataSize)
+    {
+        /* fast path: if line does not have any comment, string, backslash,
+         * statement separator and space other than ' ', then it can be returned
+         * without any change */
+        const char* lineEnd = skipPlainLineChars(data+pos, data+dataSize);
+        if (lineEnd != data+dataSize && *lineEnd == '\n')
+        {
+            colTranslations.push_back({ssize_t(-stmtPos), lineNo});
+            const size_t lineStart = pos;
+            lineSize = lineEnd - (data+pos);
+            pos += lineSize+1; // skip newline
+            stmtPos = 0;
+            lineNo++;
+            return data+lineStart;
+        }
+    }
     bool endOfLine = false;
     size_t lineStart = pos;
     size_t joinStart = pos; // join Start - physical line start
@@ -281,34 +426,34 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
         {
             case LineMode::NORMAL:
             {
-                if (pos < buffer.size() && !isSpace(buffer[pos]) && buffer[pos] != ';')
+                if (pos < dataSize && !isSpace(data[pos]) && data[pos] != ';')
                 {
                     // putting regular string (no spaces)
                     do {
-                        backslash = (buffer[pos] == '\\');
-                        if (buffer[pos] == '*' &&
-                            destPos > 0 && buffer[destPos-1] == '/')
+                        backslash = (data[pos] == '\\');
+                        if (data[pos] == '*' &&
+                            destPos > 0 && data[destPos-1] == '/')
                         {
                             // if long comment
                             prevAsterisk = false;
                             asterisk = false;
-                            buffer[destPos-1] = ' ';
-                            buffer[destPos++] = ' ';
+                            data[destPos-1] = ' ';
+                            data[destPos++] = ' ';
                             mode = LineMode::LONG_COMMENT;
                             pos++;
                             break;
                         }
-                        if (buffer[pos] == '#')
+                        if (data[pos] == '#')
                         {
                             // if line comment
-                            buffer[destPos++] = ' ';
+                            data[destPos++] = ' ';
                             mode = LineMode::LINE_COMMENT;
                             pos++;
                             break;
                         }
                         
-                        const char old = buffer[pos];
-                        buffer[destPos++] = buffer[pos++];
+                        const char old = data[pos];
+                        data[destPos++] = data[pos++];
                         
                         if (old == '"')
                         {
@@ -323,14 +468,14 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
                             break;
                         }
                         
-                    } while (pos < buffer.size() && !isSpace(buffer[pos]) &&
-                                buffer[pos] != ';');
+                    } while (pos < dataSize && !isSpace(data[pos]) &&
+                                data[pos] != ';');
                 }
-                if (pos < buffer.size() && mode!=LineMode::LINE_COMMENT)
+                if (pos < dataSize && mode!=LineMode::LINE_COMMENT)
                 {
                     // ignore for single line comment - because empty single comment
                     // will be moved to next line!
-                    if (buffer[pos] == '\n')
+                    if (data[pos] == '\n')
                     {
                         lineNo++;
                         endOfLine = (!backslash);
@@ -351,7 +496,7 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
                         backslash = false;
                         break;
                     }
-                    else if (buffer[pos] == ';' && mode == LineMode::NORMAL)
+                    else if (data[pos] == ';' && mode == LineMode::NORMAL)
                     {
                         /* treat statement as separate line */
                         endOfLine = true;
@@ -366,24 +511,24 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
                         /* replace space character by 0x20 (space) */
                         backslash = false;
                         do {
-                            buffer[destPos++] = ' ';
+                            data[destPos++] = ' ';
                             pos++;
-                        } while (pos < buffer.size() && buffer[pos] != '\n' &&
-                            isSpace(buffer[pos]));
+                        } while (pos < dataSize && data[pos] != '\n' &&
+                            isSpace(data[pos]));
                     }
                 }
                 break;
             }
             case LineMode::LINE_COMMENT:
             {
-                while (pos < buffer.size() && buffer[pos] != '\n')
+                while (pos < dataSize && data[pos] != '\n')
                 {
                     // skipping bytes until newline or buffer end
-                    backslash = (buffer[pos] == '\\');
+                    backslash = (data[pos] == '\\');
                     pos++;
-                    buffer[destPos++] = ' ';
+                    data[destPos++] = ' ';
                 }
-                if (pos < buffer.size())
+                if (pos < dataSize)
                 {
                     lineNo++;
                     endOfLine = (!backslash);
@@ -407,22 +552,22 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
             case LineMode::LONG_COMMENT:
             {
                 // go to end of long comment '*/' or to end of line
-                while (pos < buffer.size() && buffer[pos] != '\n' &&
-                    (!asterisk || buffer[pos] != '/'))
+                while (pos < dataSize && data[pos] != '\n' &&
+                    (!asterisk || data[pos] != '/'))
                 {
-                    backslash = (buffer[pos] == '\\');
+                    backslash = (data[pos] == '\\');
                     prevAsterisk = asterisk;
-                    asterisk = (buffer[pos] == '*');
+                    asterisk = (data[pos] == '*');
                     pos++;
-                    buffer[destPos++] = ' ';
+                    data[destPos++] = ' ';
                 }
-                if (pos < buffer.size())
+                if (pos < dataSize)
                 {
-                    if ((asterisk && buffer[pos] == '/'))
+                    if ((asterisk && data[pos] == '/'))
                     {
                         // end of multi line comment, set normal mode
                         pos++;
-                        buffer[destPos++] = ' ';
+                        data[destPos++] = ' ';
                         mode = LineMode::NORMAL;
                     }
                     else
@@ -456,24 +601,24 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
             {
                 const char quoteChar = (mode == LineMode::STRING)?'"':'\'';
                 // go to end of string '"' or "'" or to new line
-                while (pos < buffer.size() && buffer[pos] != '\n' &&
-                    ((backslash&1) || buffer[pos] != quoteChar))
+                while (pos < dataSize && data[pos] != '\n' &&
+                    ((backslash&1) || data[pos] != quoteChar))
                 {
-                    if (buffer[pos] == '\\')
+                    if (data[pos] == '\\')
                         backslash++;
                     else
                         backslash = 0;
-                    buffer[destPos++] = buffer[pos];
+                    data[destPos++] = data[pos];
                     pos++;
                 }
-                if (pos < buffer.size())
+                if (pos < dataSize)
                 {
-                    if ((backslash&1)==0 && buffer[pos] == quoteChar)
+                    if ((backslash&1)==0 && data[pos] == quoteChar)
                     {
                         // if qoutation character exists and it not escaped, we ends string
                         pos++;
                         mode = LineMode::NORMAL;
-                        buffer[destPos++] = quoteChar;
+                        data[destPos++] = quoteChar;
                     }
                     else
                     {
@@ -486,8 +631,9 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
                                 {ssize_t(destPos-lineStart), lineNo});
                         }
                         else
-                            assembler.printWarning({lineNo, pos-joinStart+stmtPos+1},
-                                        "Unterminated string: newline inserted");
+                            printFilterWarning(assembler,
+                                    {lineNo, pos-joinStart+stmtPos+1},
+                                    "Unterminated string: newline inserted");
                         pos++;
                         joinStart = pos;
                         stmtPos = 0;
@@ -503,30 +649,37 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
         if (endOfLine)
             break;
         
-        if (pos >= buffer.size())
+        if (pos >= dataSize)
         {
-            /* get from buffer */
-            if (lineStart != 0)
+            size_t readed = 0;
+            if (stream != nullptr)
             {
-                // use backward copying for moving buffer content back to begin
-                std::copy_backward(buffer.begin()+lineStart, buffer.begin()+pos,
-                       buffer.begin() + pos-lineStart);
-                destPos -= lineStart;
-                joinStart -= pos-destPos;
-                pos = destPos;
-                lineStart = 0;
+                /* get from buffer */
+                if (lineStart != 0)
+                {
+                    // use backward copying for moving buffer content back to begin
+                    std::copy_backward(buffer.begin()+lineStart, buffer.begin()+pos,
+                           buffer.begin() + pos-lineStart);
+                    destPos -= lineStart;
+                    joinStart -= pos-destPos;
+                    pos = destPos;
+                    lineStart = 0;
+                }
+                if (pos == buffer.size())
+                    buffer.resize(std::max(AsmParserLineMaxSize, (pos>>1)+pos));
+                
+                stream->read(buffer.data()+pos, buffer.size()-pos);
+                readed = stream->gcount();
+                buffer.resize(pos+readed);
+                data = buffer.data();
+                dataSize = buffer.size();
             }
-            if (pos == buffer.size())
-                buffer.resize(std::max(AsmParserLineMaxSize, (pos>>1)+pos));
-            
-            stream->read(buffer.data()+pos, buffer.size()-pos);
-            const size_t readed = stream->gcount();
-            buffer.resize(pos+readed);
+            // mapped file is whole in memory, hence it is end of file
             if (readed == 0)
             {
                 // end of file. check comments
                 if (mode == LineMode::LONG_COMMENT && lineStart!=pos)
-                    assembler.printError({lineNo, pos-joinStart+stmtPos+1},
+                    printFilterError(assembler, {lineNo, pos-joinStart+stmtPos+1},
                            "Unterminated multi-line comment");
                 if (destPos-lineStart == 0)
                 {
@@ -538,7 +691,213 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
         }
     }
     lineSize = destPos-lineStart;
-    return buffer.data()+lineStart;
+    return data+lineStart;
+}
+
+void AsmStreamInputFilter::printFilterWarning(Assembler& assembler, LineCol lineCol,
+            const char* message)
+{
+    if (filteredFile)
+        filteredFile->diagnostics.push_back({ filteredFile->lines.size(), lineCol,
+                    false, message });
+    assembler.printWarning(lineCol, message);
+}
+
+void AsmStreamInputFilter::printFilterError(Assembler& assembler, LineCol lineCol,
+            const char* message)
+{
+    if (filteredFile)
+        filteredFile->diagnostics.push_back({ filteredFile->lines.size(), lineCol,
+                    true, message });
+    assembler.printError(lineCol, message);
+}
+
+bool AsmStreamInputFilter::calculateContentHash(
+            std::pair<uint64_t, uint64_t>& hash) const
+{
+    if (stream != nullptr)
+        return false;
+    hash = calculateHash128(mappedFile.size(), mappedFile.data());
+    return true;
+}
+
+void AsmStreamInputFilter::recordFilteredLines(RefPtr<AsmFilteredFile> file)
+{
+    // hash content before filtering (lines are filtered in mapped memory)
+    if (!calculateContentHash(file->contentHash))
+        return; // only mapped files can be cached
+    file->fileSize = mappedFile.size();
+    filteredFile = file;
+}
+
+const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSize)
+{
+    const char* line = filterLine(assembler, lineSize);
+    if (filteredFile)
+    {
+        if (line != nullptr)
+        {
+            if (filteredFile->content.size() + lineSize > AsmIncludeCache::maxSize)
+            {
+                // too big to cache, stop recording
+                filteredFile.reset();
+                return line;
+            }
+            // record filtered line
+            AsmFilteredFile& file = *filteredFile.get();
+            file.lines.push_back({ file.content.size(), lineSize,
+                        file.colTranslations.size(), lineNo });
+            file.content.insert(file.content.end(), line, line + lineSize);
+            file.colTranslations.insert(file.colTranslations.end(),
+                        colTranslations.begin(), colTranslations.end());
+        }
+        else
+        {
+            // end of source: all lines are recorded
+            AsmIncludeCache::put(filteredFile);
+            filteredFile.reset();
+        }
+    }
+    return line;
+}
+
+/*
+ * AsmCachedInputFilter
+ */
+
+AsmCachedInputFilter::AsmCachedInputFilter(const CString& filename,
+        RefPtr<const AsmFilteredFile> _filteredFile)
+        : AsmInputFilter(AsmInputFilterType::STREAM), filteredFile(_filteredFile),
+          lineIndex(0), diagIndex(0)
+{
+    source = RefPtr<const AsmSource>(new AsmFile(filename));
+}
+
+AsmCachedInputFilter::AsmCachedInputFilter(const AsmSourcePos& pos,
+        const CString& filename, RefPtr<const AsmFilteredFile> _filteredFile)
+        : AsmInputFilter(AsmInputFilterType::STREAM), filteredFile(_filteredFile),
+          lineIndex(0), diagIndex(0)
+{
+    if (!pos.macro)
+        source = RefPtr<const AsmSource>(new AsmFile(pos.source, pos.lineNo,
+                             pos.colNo, filename));
+    else // if inside macro
+        source = RefPtr<const AsmSource>(new AsmFile(
+            RefPtr<const AsmSource>(new AsmMacroSource(pos.macro, pos.source)),
+                 pos.lineNo, pos.colNo, filename));
+}
+
+const char* AsmCachedInputFilter::readLine(Assembler& assembler, size_t& lineSize)
+{
+    const AsmFilteredFile& file = *filteredFile.get();
+    // print warnings and errors from filtering in original order
+    for (; diagIndex < file.diagnostics.size() &&
+            file.diagnostics[diagIndex].lineIndex == lineIndex; diagIndex++)
+    {
+        const AsmFilteredFile::Diagnostic& diag = file.diagnostics[diagIndex];
+        if (diag.error)
+            assembler.printError(diag.lineCol, diag.message.c_str());
+        else
+            assembler.printWarning(diag.lineCol, diag.message.c_str());
+    }
+    if (lineIndex == file.lines.size())
+    {
+        lineSize = 0;
+        return nullptr;
+    }
+    const AsmFilteredFile::Line& line = file.lines[lineIndex++];
+    const size_t colTransEnd = (lineIndex < file.lines.size()) ?
+            file.lines[lineIndex].colTransIndex : file.colTranslations.size();
+    colTranslations.assign(file.colTranslations.begin() + line.colTransIndex,
+                file.colTranslations.begin() + colTransEnd);
+    lineNo = line.lineNo;
+    lineSize = line.size;
+    return file.content.data() + line.offset;
+}
+
+/*
+ * AsmIncludeCache
+ */
+
+static std::mutex includeCacheMutex;
+static std::unordered_map<CString, RefPtr<const AsmFilteredFile> > includeCacheMap;
+static size_t includeCacheSize = 0;
+
+// get resolved path and size of regular file
+static bool getIncludeFileStatus(const CString& filename, CString& path,
+            uint64_t& fileSize)
+{
+    struct stat st;
+    if (::stat(filename.c_str(), &st) != 0 || (st.st_mode & S_IFMT) != S_IFREG)
+        return false;
+#ifdef HAVE_WINDOWS
+    char* resolved = ::_fullpath(nullptr, filename.c_str(), 0);
+#else
+    char* resolved = ::realpath(filename.c_str(), nullptr);
+#endif
+    if (resolved == nullptr)
+        return false;
+    path = resolved;
+    ::free(resolved);
+    fileSize = st.st_size;
+    return true;
+}
+
+RefPtr<const AsmFilteredFile> AsmIncludeCache::find(const CString& filename,
+            RefPtr<AsmFilteredFile>& newFile)
+{
+    newFile.reset();
+    CString path;
+    uint64_t fileSize;
+    if (!getIncludeFileStatus(filename, path, fileSize))
+        return RefPtr<const AsmFilteredFile>();
+    RefPtr<const AsmFilteredFile> cachedFile;
+    {
+        std::lock_guard<std::mutex> lock(includeCacheMutex);
+        auto it = includeCacheMap.find(path);
+        if (it != includeCacheMap.end())
+            cachedFile = it->second;
+    }
+    /* modification time is not reliable (it can have one second resolution),
+     * hence content of file is compared by its hash */
+    if (cachedFile && cachedFile->fileSize == fileSize)
+    {
+        try
+        {
+            MappedFile file(path.c_str());
+            if (file.size() == fileSize && calculateHash128(file.size(),
+                        file.data()) == cachedFile->contentHash)
+                return cachedFile;
+        }
+        catch(const Exception&)
+        { return RefPtr<const AsmFilteredFile>(); }
+    }
+    // not found or changed, filtered lines will be recorded (and replace old entry)
+    newFile = RefPtr<AsmFilteredFile>(new AsmFilteredFile);
+    newFile->path = path;
+    return RefPtr<const AsmFilteredFile>();
+}
+
+void AsmIncludeCache::put(RefPtr<AsmFilteredFile> file)
+{
+    std::lock_guard<std::mutex> lock(includeCacheMutex);
+    auto it = includeCacheMap.find(file->path);
+    if (it != includeCacheMap.end())
+    {
+        includeCacheSize -= it->second->content.size();
+        includeCacheMap.erase(it);
+    }
+    if (includeCacheSize + file->content.size() > maxSize)
+        return; // cache is full
+    includeCacheSize += file->content.size();
+    includeCacheMap.insert({ file->path, file.constCast<const AsmFilteredFile>() });
+}
+
+void AsmIncludeCache::clear()
+{
+    std::lock_guard<std::mutex> lock(includeCacheMutex);
+    includeCacheMap.clear();
+    includeCacheSize = 0;
 }
 
 AsmMacroInputFilter::AsmMacroInputFilter(RefPtr<const AsmMacro> _macro,
@@ -546,7 +905,7 @@ AsmMacroInputFilter::AsmMacroInputFilter(RefPtr<const AsmMacro> _macro,
          bool _alternateMacro)
         : AsmInputFilter(AsmInputFilterType::MACROSUBST), macro(_macro),
           argMap(_argMap), macroCount(_macroCount), contentLineNo(0), sourceTransIndex(0),
-          realLinePos(0), alternateMacro(_alternateMacro)
+          realLinePos(0), alternateMacro(_alternateMacro), substIndex(0)
 {
     if (macro->getSourceTransSize()!=0)
         source = macro->getSourceTrans(0).source;
@@ -565,7 +924,7 @@ AsmMacroInputFilter::AsmMacroInputFilter(RefPtr<const AsmMacro> _macro,
         : AsmInputFilter(AsmInputFilterType::MACROSUBST), macro(_macro),
           argMap(std::move(_argMap)), macroCount(_macroCount),
           contentLineNo(0), sourceTransIndex(0), realLinePos(0),
-          alternateMacro(_alternateMacro)
+          alternateMacro(_alternateMacro), substIndex(0)
 {
     if (macro->getSourceTransSize()!=0)
         source = macro->getSourceTrans(0).source;
@@ -651,6 +1010,103 @@ const char* AsmMacroInputFilter::readLine(Assembler& assembler, size_t& lineSize
             localStmtStart = nullptr; // this is not local stmt
     }
     
+    if (!alternateMacro && macro->isCompiled())
+    {
+        /* compiled macro: go directly to next substitution, copy content before it
+         * and put column translations in the same way as in loop below */
+        const std::vector<AsmMacro::Substitution>& substs = macro->getSubstitutions();
+        auto putColTrans = [&](size_t transPos)
+        {
+            curColTrans++;
+            colTranslations.push_back({ssize_t(destPos + transPos-toCopyPos),
+                        curColTrans->lineNo});
+            if (curColTrans->position >= 0)
+            {
+                /// real new line, reset real line position
+                realLinePos = 0;
+                destLineStart = destPos + transPos-toCopyPos;
+            }
+            colTransThreshold = (curColTrans+1 != colTransEnd) ?
+                    (curColTrans[1].position>0 ? curColTrans[1].position + linePos :
+                            nextLinePos) : SIZE_MAX;
+        };
+        // first position that is not checked for column translation
+        size_t checkPos = pos;
+        while (true)
+        {
+            const bool haveSubst = substIndex < substs.size() &&
+                        substs[substIndex].position < nextLinePos;
+            const size_t substPos = haveSubst ? substs[substIndex].position : nextLinePos;
+            // column translations in content before substitution
+            while (std::max(checkPos, colTransThreshold) < substPos)
+            {
+                const size_t transPos = std::max(checkPos, colTransThreshold);
+                putColTrans(transPos);
+                checkPos = transPos+1;
+            }
+            if (!haveSubst)
+            {
+                pos = nextLinePos;
+                break;
+            }
+            const AsmMacro::Substitution& subst = substs[substIndex++];
+            pos = substPos;
+            if (pos >= colTransThreshold)
+                putColTrans(pos);
+            // copy content before backslash
+            buffer.insert(buffer.end(), content + toCopyPos, content + pos);
+            destPos += pos-toCopyPos;
+            pos++;
+            bool skipColTransBetweenMacroArg = true;
+            switch (subst.type)
+            {
+                case AsmMacro::SUBST_ARG:
+                {
+                    const CString& argValue = argMap[subst.argIndex].second;
+                    buffer.insert(buffer.end(), argValue.begin(),
+                                  argValue.begin() + argValue.size());
+                    destPos += argValue.size();
+                    break;
+                }
+                case AsmMacro::SUBST_COUNTER:
+                {
+                    char numBuf[32];
+                    const size_t numLen = itocstrCStyle(macroCount, numBuf, 32);
+                    buffer.insert(buffer.end(), numBuf, numBuf+numLen);
+                    destPos += numLen;
+                    break;
+                }
+                case AsmMacro::SUBST_SEPARATOR:
+                    break;
+                default:
+                    buffer.push_back('\\');
+                    destPos++;
+                    // do not skip column translation, because no substitution!
+                    skipColTransBetweenMacroArg = false;
+                    break;
+            }
+            pos += subst.length;
+            toCopyPos = pos;
+            // skip colTrans between macroarg or separator
+            if (skipColTransBetweenMacroArg)
+            {
+                while (pos > colTransThreshold)
+                {
+                    curColTrans++;
+                    if (curColTrans->position >= 0)
+                    {
+                        /// real new line, reset real line position
+                        realLinePos = 0;
+                        destLineStart = destPos + pos-toCopyPos;
+                    }
+                    colTransThreshold = (curColTrans+1 != colTransEnd) ?
+                            curColTrans[1].position : SIZE_MAX;
+                }
+            }
+            checkPos = pos;
+        }
+    }
+    
     // indicate length of name to copy to buffer (skip)
     size_t wordSkip = 0;
     /* loop move position to backslash. if backslash encountered then copy content
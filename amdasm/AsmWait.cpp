@@ -19,12 +19,16 @@
 
 #include <CLRX/Config.h>
 #include <vector>
+#include <deque>
+#include <string>
 #include <cstddef>
 #include <utility>
 #include <algorithm>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/amdasm/Assembler.h>
+#include "AsmInternals.h"
+#include "AsmRegAlloc.h"
 
 using namespace CLRX;
 
@@ -76,15 +80,449 @@ bool ISAWaitHandler::nextInstr(AsmDelayedOp& delOp, AsmWaitInstr& waitInstr)
 
 /* AsmWaitScheduler */
 
+/* wait scheduler tracks pending delayed operations that access to registers.
+ * laterCount is number of counter units of later delayed operations with same type
+ * (issued after this operation). If pending operation is not finished,
+ * then these later operations also are not finished (if type is ordered),
+ * hence waiting for counter <= laterCount guarantees that operation has been finished.
+ * For unordered types laterCount is always zero. Operation with laterCount
+ * greater or equal to maximal counter value are always finished. */
+
+namespace CLRX
+{
+
+// register checked by wait scheduler
+struct CLRX_INTERNAL WaitReg
+{
+    const AsmRegVar* regVar;    // regvar (null if register or color)
+    size_t index;   // index in regvar, register or color
+    cxuint regType; // register type for color, UINT_MAX otherwise
+    
+    bool operator==(const WaitReg& r2) const
+    { return regVar == r2.regVar && index == r2.index && regType == r2.regType; }
+    bool operator<(const WaitReg& r2) const
+    {
+        return regVar < r2.regVar || (regVar == r2.regVar && (index < r2.index ||
+                (index == r2.index && regType < r2.regType)));
+    }
+};
+
+// pending delayed operation that access to register
+struct CLRX_INTERNAL WaitPendingOp
+{
+    WaitReg reg;
+    cxbyte waitType;
+    cxbyte delayedOpType;
+    bool readOut;   // true if operation reads register, false if writes
+    uint16_t laterCount;
+    
+    // compare without laterCount
+    bool operator<(const WaitPendingOp& op2) const
+    {
+        if (!(reg == op2.reg))
+            return reg < op2.reg;
+        if (waitType != op2.waitType)
+            return waitType < op2.waitType;
+        if (delayedOpType != op2.delayedOpType)
+            return delayedOpType < op2.delayedOpType;
+        return int(readOut) < int(op2.readOut);
+    }
+};
+
+// sorted pending operations
+typedef std::vector<WaitPendingOp> WaitState;
+
+struct CLRX_INTERNAL WaitSchedContext
+{
+    const AsmWaitConfig& waitConfig;
+    const AsmRegAllocator::VarIndexMap* vregIndexMaps;
+    const Array<cxuint>* graphColorMaps;
+    size_t regTypesNum;
+    cxuint regRanges[MAX_REGTYPES_NUM*2];
+    const ISAUsageArrays& usages;
+    std::vector<AsmDelayedOp> delayedOps;
+    std::vector<AsmWaitInstr> waitInstrs;
+};
+
+};
+
+// remove operations finished after waiting
+static void applyWaits(WaitState& state, const uint16_t* waits)
+{
+    state.erase(std::remove_if(state.begin(), state.end(),
+            [waits](const WaitPendingOp& op)
+            { return op.laterCount >= waits[op.waitType]; }), state.end());
+}
+
+// get registers checked by scheduler (translate to colors if allocated)
+static void getWaitRegs(const WaitSchedContext& ctx, const AsmRegVar* regVar,
+            uint16_t rstart, uint16_t rend, std::vector<WaitReg>& regs)
+{
+    regs.clear();
+    for (uint16_t r = rstart; r < rend; r++)
+    {
+        if (ctx.vregIndexMaps != nullptr && ctx.graphColorMaps != nullptr)
+        {
+            cxuint regType = 0;
+            if (regVar != nullptr)
+                regType = regVar->type;
+            else
+                for (regType = 0; regType < ctx.regTypesNum; regType++)
+                    if (r >= ctx.regRanges[regType<<1] &&
+                        r < ctx.regRanges[(regType<<1)+1])
+                        break;
+            if (regType < ctx.regTypesNum)
+            {
+                auto it = ctx.vregIndexMaps[regType].find(AsmSingleVReg{ regVar, r });
+                const Array<cxuint>& gcMap = ctx.graphColorMaps[regType];
+                bool colored = false;
+                if (it != ctx.vregIndexMaps[regType].end())
+                    for (size_t vidx: it->second)
+                        if (vidx < gcMap.size() && gcMap[vidx] != UINT_MAX)
+                        {
+                            regs.push_back({ nullptr, gcMap[vidx], regType });
+                            colored = true;
+                        }
+                if (colored)
+                    continue;
+            }
+        }
+        regs.push_back({ regVar, r, UINT_MAX });
+    }
+}
+
+static bool delayedOpOffsetLess(const AsmDelayedOp& op, size_t offset)
+{ return op.offset < offset; }
+
+static bool waitInstrOffsetLess(const AsmWaitInstr& wi, size_t offset)
+{ return wi.offset < offset; }
+
+namespace CLRX
+{
+
+// position of next usage, delayed operation and wait instruction in code
+struct CLRX_INTERNAL WaitCodePos
+{
+    size_t instrIndex;  // instruction index in usage arrays
+    std::vector<AsmDelayedOp>::const_iterator delOpIt;
+    std::vector<AsmWaitInstr>::const_iterator waitIt;
+    
+    WaitCodePos(const WaitSchedContext& ctx, size_t offset, size_t _instrIndex)
+        : instrIndex(_instrIndex),
+          delOpIt(std::lower_bound(ctx.delayedOps.begin(), ctx.delayedOps.end(),
+                    offset, delayedOpOffsetLess)),
+          waitIt(std::lower_bound(ctx.waitInstrs.begin(), ctx.waitInstrs.end(),
+                    offset, waitInstrOffsetLess))
+    { }
+    
+    // get offset of next instruction (or end if no instruction before end)
+    size_t nextOffset(const WaitSchedContext& ctx, size_t end) const
+    {
+        size_t offset = end;
+        if (instrIndex < ctx.usages.getInstrsNum())
+            offset = std::min(offset, ctx.usages.instrOffsets[instrIndex]);
+        if (delOpIt != ctx.delayedOps.end())
+            offset = std::min(offset, delOpIt->offset);
+        if (waitIt != ctx.waitInstrs.end())
+            offset = std::min(offset, waitIt->offset);
+        return offset;
+    }
+};
+
+};
+
+/* process register accesses and delayed operations of instruction at offset
+ * (wait instructions from code must be applied before).
+ * returns true if wait is needed before instruction (waits are set) */
+static bool processWaitInstr(const WaitSchedContext& ctx, size_t offset,
+            WaitCodePos& pos, WaitState& state, uint16_t* waits)
+{
+    const AsmWaitConfig& waitConfig = ctx.waitConfig;
+    std::vector<WaitReg> regs;
+    // count units of delayed operations of this instruction (for every type)
+    uint16_t typeUnits[ASM_DELAY_INSTR_MAX_TYPES_NUM] = { };
+    auto delOpEnd = pos.delOpIt;
+    for (; delOpEnd != ctx.delayedOps.end() && delOpEnd->offset == offset; ++delOpEnd)
+        for (cxbyte type: { delOpEnd->delayedOpType, delOpEnd->delayedOpType2 })
+            if (type < waitConfig.delayInstrTypesNum)
+                typeUnits[type] = std::max(typeUnits[type],
+                        getDelayedOpUnits(waitConfig, *delOpEnd, type));
+    
+    // check whether instruction access to registers of pending operations
+    for (cxuint i = 0; i < ASM_WAIT_MAX_TYPES_NUM; i++)
+        waits[i] = (i < waitConfig.waitQueuesNum) ? waitConfig.waitQueueSizes[i]-1 : 0;
+    bool needWait = false;
+    const ISAUsageArrays& usages = ctx.usages;
+    size_t usageStart = 0, usageEnd = 0;
+    if (pos.instrIndex < usages.getInstrsNum() &&
+        usages.instrOffsets[pos.instrIndex] == offset)
+    {
+        // instruction has register usages
+        usageStart = usages.instrUsageStarts[pos.instrIndex];
+        usageEnd = usages.instrUsageStarts[++pos.instrIndex];
+    }
+    for (size_t ui = usageStart; ui < usageEnd; ui++)
+    {
+        const cxbyte rwFlags = usages.rwFlags[ui] & 0x7f;
+        getWaitRegs(ctx, usages.regVars[ui], usages.rstarts[ui], usages.rends[ui], regs);
+        for (const WaitReg& reg: regs)
+        {
+            auto it = std::lower_bound(state.begin(), state.end(),
+                    WaitPendingOp{ reg, 0, 0, false, 0 });
+            for (; it != state.end() && it->reg == reg; ++it)
+            {
+                if (!it->readOut && rwFlags == ASMRVU_WRITE &&
+                    typeUnits[it->delayedOpType] != 0 &&
+                    waitConfig.delayInstrTypes[it->delayedOpType].ordered)
+                    // results of ordered operations are written in order
+                    continue;
+                // operation writes register or instruction writes register
+                if ((!it->readOut || (rwFlags & ASMRVU_WRITE) != 0) &&
+                    it->laterCount < waits[it->waitType])
+                {
+                    waits[it->waitType] = it->laterCount;
+                    needWait = true;
+                }
+            }
+        }
+    }
+    if (needWait)
+        applyWaits(state, waits);
+    
+    if (pos.delOpIt == delOpEnd)
+        return needWait;
+    // update laterCount for pending operations and remove finished
+    for (WaitPendingOp& op: state)
+        if (waitConfig.delayInstrTypes[op.delayedOpType].ordered)
+            op.laterCount = std::min(op.laterCount + typeUnits[op.delayedOpType],
+                    waitConfig.waitQueueSizes[op.waitType]-1);
+    state.erase(std::remove_if(state.begin(), state.end(),
+            [&waitConfig](const WaitPendingOp& op)
+            { return op.laterCount >= waitConfig.waitQueueSizes[op.waitType]-1; }),
+            state.end());
+    
+    // add new pending operations
+    WaitState newOps;
+    for (; pos.delOpIt != delOpEnd; ++pos.delOpIt)
+    {
+        const AsmDelayedOp& delOp = *pos.delOpIt;
+        getWaitRegs(ctx, delOp.regVar, delOp.rstart, delOp.rend, regs);
+        for (cxbyte type: { delOp.delayedOpType, delOp.delayedOpType2 })
+        {
+            if (type >= waitConfig.delayInstrTypesNum)
+                continue;
+            const AsmDelayInstrTypeEntry& entry = waitConfig.delayInstrTypes[type];
+            /* if operation is not finished on register read out, then
+             * registers are read while issuing instruction */
+            const bool readOut = entry.finishOnRegReadOut;
+            if ((delOp.rwFlags & (readOut ? ASMRVU_READ : ASMRVU_WRITE)) == 0)
+                continue;
+            for (const WaitReg& reg: regs)
+                newOps.push_back({ reg, entry.waitType, type, readOut, 0 });
+        }
+    }
+    std::sort(newOps.begin(), newOps.end());
+    newOps.erase(std::unique(newOps.begin(), newOps.end(),
+            [](const WaitPendingOp& op1, const WaitPendingOp& op2)
+            { return !(op1 < op2) && !(op2 < op1); }), newOps.end());
+    mergePendingOps(state, newOps);
+    return needWait;
+}
+
+/* find waits needed by first instruction after offset that accesses results of
+ * pending operations (state before wait instruction from code).
+ * returns false if no such instruction before next wait instruction or block end */
+static bool findFirstNeededWait(const WaitSchedContext& ctx,
+            const AsmRegAllocator::CodeBlock& block, size_t offset, WaitState state,
+            uint16_t* waits)
+{
+    WaitCodePos pos(ctx, offset, ctx.usages.lowerBound(offset));
+    while (true)
+    {
+        const size_t instrOffset = pos.nextOffset(ctx, block.end);
+        if (instrOffset >= block.end ||
+            (pos.waitIt != ctx.waitInstrs.end() && pos.waitIt->offset == instrOffset))
+            return false;
+        if (processWaitInstr(ctx, instrOffset, pos, state, waits))
+            return true;
+    }
+}
+
+/* process code block, update state and put needed waits (if neededWaits is not null)
+ * and waits from code that are stronger than needed (if tooBroadWaits is not null) */
+static void processWaitBlock(const WaitSchedContext& ctx,
+            const AsmRegAllocator::CodeBlock& block, WaitState& state,
+            std::vector<AsmWaitInstr>* neededWaits,
+            std::vector<AsmWaitInstr>* tooBroadWaits)
+{
+    const AsmWaitConfig& waitConfig = ctx.waitConfig;
+    WaitCodePos pos(ctx, block.start, block.usagePos);
+    
+    while (true)
+    {
+        // find next instruction
+        const size_t offset = pos.nextOffset(ctx, block.end);
+        if (offset >= block.end)
+            break;
+        
+        // apply wait instruction from code
+        for (; pos.waitIt != ctx.waitInstrs.end() && pos.waitIt->offset == offset;
+                    ++pos.waitIt)
+        {
+            uint16_t firstWaits[ASM_WAIT_MAX_TYPES_NUM];
+            if (tooBroadWaits != nullptr &&
+                findFirstNeededWait(ctx, block, offset+1, state, firstWaits))
+            {
+                /* wait is too broad if first instruction that needs wait
+                 * needs weaker wait for same queue */
+                AsmWaitInstr broadWait = *pos.waitIt;
+                bool tooBroad = false;
+                for (cxuint i = 0; i < waitConfig.waitQueuesNum; i++)
+                    if (broadWait.waits[i] < firstWaits[i] &&
+                        firstWaits[i] < waitConfig.waitQueueSizes[i]-1)
+                    {
+                        broadWait.waits[i] = firstWaits[i];
+                        tooBroad = true;
+                    }
+                if (tooBroad)
+                    tooBroadWaits->push_back(broadWait);
+            }
+            applyWaits(state, pos.waitIt->waits);
+        }
+        
+        uint16_t waits[ASM_WAIT_MAX_TYPES_NUM];
+        if (processWaitInstr(ctx, offset, pos, state, waits) && neededWaits != nullptr)
+        {
+            AsmWaitInstr waitInstr{ offset };
+            std::copy(waits, waits + ASM_WAIT_MAX_TYPES_NUM, waitInstr.waits);
+            neededWaits->push_back(waitInstr);
+        }
+    }
+}
+
 AsmWaitScheduler::AsmWaitScheduler(const AsmWaitConfig& _asmWaitConfig,
         Assembler& _assembler, const std::vector<AsmRegAllocator::CodeBlock>& _codeBlocks,
+        const ISAUsageArrays& _usageArrays,
         const AsmRegAllocator::VarIndexMap* _vregIndexMaps,
         const Array<cxuint>* _graphColorMaps, bool _onlyWarnings)
         : waitConfig(_asmWaitConfig), assembler(_assembler), codeBlocks(_codeBlocks),
-          vregIndexMaps(_vregIndexMaps), graphColorMaps(_graphColorMaps),
-          onlyWarnings(_onlyWarnings)
+          usageArrays(_usageArrays), vregIndexMaps(_vregIndexMaps),
+          graphColorMaps(_graphColorMaps), onlyWarnings(_onlyWarnings)
 { }
 
-void AsmWaitScheduler::schedule()
+void AsmWaitScheduler::schedule(AsmSectionId sectionId)
 {
+    ASM_STATS_PHASE(assembler, AsmPhase::WAIT_SCHEDULE)
+    neededWaitInstrs.clear();
+    tooBroadWaitInstrs.clear();
+    AsmSection& section = assembler.sections[sectionId];
+    if (codeBlocks.empty() || section.waitHandler == nullptr)
+        return;
+    
+    WaitSchedContext ctx{ waitConfig, vregIndexMaps, graphColorMaps, 0, { },
+                usageArrays };
+    assembler.isaAssembler->getRegisterRanges(ctx.regTypesNum, ctx.regRanges);
+    ISAWaitHandler& waitHandler = *section.waitHandler;
+    waitHandler.rewind();
+    while (waitHandler.hasNext())
+    {
+        AsmDelayedOp delOp;
+        AsmWaitInstr waitInstr;
+        if (waitHandler.nextInstr(delOp, waitInstr))
+            ctx.waitInstrs.push_back(waitInstr);
+        else
+            ctx.delayedOps.push_back(delOp);
+    }
+    
+    const size_t blocksNum = codeBlocks.size();
+    std::vector<std::vector<size_t> > nextBlocks;
+    getCodeBlockNexts(codeBlocks, nextBlocks);
+    
+    // find pending operations at block starts (until fixpoint)
+    std::vector<WaitState> inStates(blocksNum);
+    std::vector<bool> inWorkList(blocksNum, true);
+    std::deque<size_t> workList;
+    for (size_t i = 0; i < blocksNum; i++)
+        workList.push_back(i);
+    while (!workList.empty())
+    {
+        const size_t i = workList.front();
+        workList.pop_front();
+        inWorkList[i] = false;
+        WaitState state = inStates[i];
+        processWaitBlock(ctx, codeBlocks[i], state, nullptr, nullptr);
+        for (size_t next: nextBlocks[i])
+            if (mergePendingOps(inStates[next], state) && !inWorkList[next])
+            {
+                inWorkList[next] = true;
+                workList.push_back(next);
+            }
+    }
+    
+    // collect needed waits and too broad waits
+    for (size_t i = 0; i < blocksNum; i++)
+    {
+        WaitState state = inStates[i];
+        processWaitBlock(ctx, codeBlocks[i], state, &neededWaitInstrs,
+                    &tooBroadWaitInstrs);
+    }
+    auto waitInstrLess = [](const AsmWaitInstr& wi1, const AsmWaitInstr& wi2)
+            { return wi1.offset < wi2.offset; };
+    std::stable_sort(neededWaitInstrs.begin(), neededWaitInstrs.end(), waitInstrLess);
+    std::stable_sort(tooBroadWaitInstrs.begin(), tooBroadWaitInstrs.end(),
+                waitInstrLess);
+    
+    if (!onlyWarnings || (neededWaitInstrs.empty() && tooBroadWaitInstrs.empty()))
+        return;
+    // print warnings about missing and too broad waits (in code order)
+    std::vector<std::pair<size_t, AsmSourcePos> > sourcePoses;
+    AsmSourcePosHandler& sourcePosHandler = section.sourcePosHandler;
+    sourcePosHandler.rewind();
+    while (sourcePosHandler.hasNext())
+        sourcePoses.push_back(sourcePosHandler.nextSourcePos());
+    auto neededIt = neededWaitInstrs.begin();
+    auto broadIt = tooBroadWaitInstrs.begin();
+    while (neededIt != neededWaitInstrs.end() || broadIt != tooBroadWaitInstrs.end())
+    {
+        const bool tooBroad = broadIt != tooBroadWaitInstrs.end() &&
+                (neededIt == neededWaitInstrs.end() || broadIt->offset <= neededIt->offset);
+        const AsmWaitInstr& waitInstr = tooBroad ? *broadIt++ : *neededIt++;
+        char buf[32];
+        std::string queues;
+        for (cxuint i = 0; i < waitConfig.waitQueuesNum; i++)
+            if (waitInstr.waits[i] < waitConfig.waitQueueSizes[i]-1)
+            {
+                // print counter as in wait instruction (for example 'vmcnt(2)')
+                itocstrCStyle(waitInstr.waits[i], buf, 32);
+                if (!queues.empty())
+                    queues += ", ";
+                if (waitConfig.waitQueueNames[i] != nullptr)
+                    queues += waitConfig.waitQueueNames[i];
+                else
+                {
+                    queues += "queue";
+                    queues += char('0'+i);
+                }
+                queues += '(';
+                queues += buf;
+                queues += ')';
+            }
+        const std::string message = tooBroad ?
+                "Too broad wait (" + queues + " is enough for next instruction)" :
+                "Missing wait for delayed results (" + queues + ")";
+        auto it = std::lower_bound(sourcePoses.begin(), sourcePoses.end(),
+                std::make_pair(waitInstr.offset, AsmSourcePos{}),
+                [](const std::pair<size_t, AsmSourcePos>& p1,
+                   const std::pair<size_t, AsmSourcePos>& p2)
+                { return p1.first < p2.first; });
+        if (it != sourcePoses.end() && it->first == waitInstr.offset)
+            assembler.printWarning(it->second, message.c_str());
+        else if ((assembler.flags & ASM_WARNINGS) != 0)
+        {
+            // no source position, print section name and offset
+            itocstrCStyle(waitInstr.offset, buf, 32, 16);
+            assembler.messageStream << (section.name != nullptr ? section.name : "") <<
+                    ": Warning: " << message << " at offset " << buf << std::endl;
+        }
+    }
 }
@@ -19,13 +19,18 @@
 
 #include <CLRX/Config.h>
 #include <string>
+#include <cstring>
 #include <cassert>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <stack>
 #include <deque>
 #include <utility>
 #include <algorithm>
+#ifdef HAVE_ASM_STATS
+#include <chrono>
+#endif
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/MemAccess.h>
 #include <CLRX/utils/GPUId.h>
@@ -763,7 +768,8 @@ Assembler::Assembler(const CString& filename, std::istream& input, Flags _flags,
           policyVersion(ASM_POLICY_DEFAULT),
           isaAssembler(nullptr),
           // initialize global scope: adds '.' to symbols
-          globalScope({nullptr,{std::make_pair(".", AsmSymbol(0, uint64_t(0)))}}),
+          globalScope(nullptr, { std::make_pair(".", AsmSymbol(0, uint64_t(0))) },
+                      &symbolArena),
           currentScope(&globalScope),
           flags(_flags),
           lineSize(0), line(nullptr),
@@ -786,11 +792,16 @@ Assembler::Assembler(const CString& filename, std::istream& input, Flags _flags,
     resolvingRelocs = false;
     collectSourcePoses = false;
     formatHandler = nullptr;
+    collectStats = false;
+    currentPhase = ASM_PHASES_NUM;
+    phaseStartTime = 0;
+    ::memset(&stats, 0, sizeof(AsmStats));
     input.exceptions(std::ios::badbit);
     std::unique_ptr<AsmInputFilter> thatInputFilter(
                     new AsmStreamInputFilter(input, filename));
     asmInputFilters.push(thatInputFilter.get());
     currentInputFilter = thatInputFilter.release();
+    ASM_STATS_COUNT(*this, inputFilterAllocsNum)
 }
 
 Assembler::Assembler(const Array<CString>& _filenames, Flags _flags,
@@ -803,7 +814,8 @@ Assembler::Assembler(const Array<CString>& _filenames, Flags _flags,
           policyVersion(ASM_POLICY_DEFAULT),
           isaAssembler(nullptr),
           // initialize global scope: adds '.' to symbols
-          globalScope({nullptr,{std::make_pair(".", AsmSymbol(0, uint64_t(0)))}}),
+          globalScope(nullptr, { std::make_pair(".", AsmSymbol(0, uint64_t(0))) },
+                      &symbolArena),
           currentScope(&globalScope),
           flags(_flags),
           lineSize(0), line(nullptr),
@@ -827,10 +839,45 @@ Assembler::Assembler(const Array<CString>& _filenames, Flags _flags,
     resolvingRelocs = false;
     collectSourcePoses = false;
     formatHandler = nullptr;
+    collectStats = false;
+    currentPhase = ASM_PHASES_NUM;
+    phaseStartTime = 0;
+    ::memset(&stats, 0, sizeof(AsmStats));
     std::unique_ptr<AsmInputFilter> thatInputFilter(
-                new AsmStreamInputFilter(filenames[filenameIndex++]));
+                openSourceFile(filenames[filenameIndex++]));
     asmInputFilters.push(thatInputFilter.get());
     currentInputFilter = thatInputFilter.release();
+    ASM_STATS_COUNT(*this, inputFilterAllocsNum)
+}
+
+static const char* asmPhaseNamesTable[ASM_PHASES_NUM] =
+{
+    "other", "input", "macro", "pseudo-op", "expression", "instruction",
+    "resolving", "prepare binary", "write binary", "register allocation",
+    "wait scheduling"
+};
+
+const char* CLRX::getAsmPhaseName(AsmPhase phase)
+{
+    if (cxuint(phase) >= ASM_PHASES_NUM)
+        throw AsmException("Unknown assembler phase");
+    return asmPhaseNamesTable[cxuint(phase)];
+}
+
+cxuint Assembler::switchPhase(cxuint phase) const
+{
+#ifdef HAVE_ASM_STATS
+    const uint64_t curTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (currentPhase < ASM_PHASES_NUM)
+        stats.phaseTimes[currentPhase] += curTime - phaseStartTime;
+#else
+    const uint64_t curTime = 0;
+#endif
+    phaseStartTime = curTime;
+    const cxuint prevPhase = currentPhase;
+    currentPhase = phase;
+    return prevPhase;
 }
 
 Assembler::~Assembler()
@@ -2049,6 +2096,7 @@ bool Assembler::popClause(const char* string, AsmClauseType clauseType)
 
 Assembler::ParseState Assembler::makeMacroSubstitution(const char* linePtr)
 {
+    ASM_STATS_PHASE(*this, AsmPhase::MACRO)
     const char* end = line+lineSize;
     const char* macroStartPlace = linePtr;
     
@@ -2152,6 +2200,8 @@ Assembler::ParseState Assembler::makeMacroSubstitution(const char* linePtr)
             getSourcePos(macroStartPlace), std::move(argMap), macroCount++,
             alternateMacro));
     asmInputFilters.push(macroFilter.release());
+    ASM_STATS_COUNT(*this, macroExpansions)
+    ASM_STATS_COUNT(*this, inputFilterAllocsNum)
     currentInputFilter = asmInputFilters.top();
     macroSubstLevel++;
     return ParseState::PARSED;
@@ -2400,7 +2450,7 @@ bool Assembler::getScope(AsmScope* parent, const CString& scopeName, AsmScope*&
         scope = foundScope;
         return false;
     }
-    std::unique_ptr<AsmScope> newScope(new AsmScope(parent));
+    std::unique_ptr<AsmScope> newScope(new AsmScope(parent, &symbolArena));
     auto res = parent->scopeMap.insert(std::make_pair(scopeName, newScope.get()));
     scope = newScope.release();
     return res.second;
@@ -2411,7 +2461,7 @@ bool Assembler::pushScope(const CString& scopeName)
     if (scopeName.empty())
     {
         // temporary scope
-        std::unique_ptr<AsmScope> newScope(new AsmScope(currentScope, true));
+        std::unique_ptr<AsmScope> newScope(new AsmScope(currentScope, &symbolArena, true));
         currentScope->scopeMap.insert(std::make_pair("", newScope.get()));
         currentScope = newScope.release();
     }
@@ -2442,13 +2492,62 @@ bool Assembler::popScope()
     return true;
 }
 
+void Assembler::clearIncludeCache()
+{
+    AsmIncludeCache::clear();
+}
+
+AsmInputFilter* Assembler::openFileInputFilter(const AsmSourcePos* pos,
+            const CString& filename, std::vector<std::pair<uint64_t, uint64_t> >& fileHashes)
+{
+    RefPtr<AsmFilteredFile> newFilteredFile;
+    if ((flags & ASM_INCLUDECACHE) != 0)
+    {
+        // use filtered lines from include cache if file has not been changed
+        RefPtr<const AsmFilteredFile> cachedFile = AsmIncludeCache::find(
+                    filename, newFilteredFile);
+        if (cachedFile)
+        {
+            // content of cached file has been compared by its hash
+            if ((flags & ASM_FILEHASHES) != 0)
+                fileHashes.push_back(cachedFile->contentHash);
+            if (pos != nullptr)
+                return new AsmCachedInputFilter(*pos, filename, cachedFile);
+            return new AsmCachedInputFilter(filename, cachedFile);
+        }
+    }
+    std::unique_ptr<AsmStreamInputFilter> streamFilter((pos != nullptr) ?
+            new AsmStreamInputFilter(*pos, filename) : new AsmStreamInputFilter(filename));
+    if (newFilteredFile)
+        streamFilter->recordFilteredLines(newFilteredFile);
+    if ((flags & ASM_FILEHASHES) != 0)
+    {
+        // hash content before filtering (while file is read)
+        std::pair<uint64_t, uint64_t> hash(0, 0);
+        if (newFilteredFile)
+            hash = newFilteredFile->contentHash;
+        else
+            streamFilter->calculateContentHash(hash);
+        fileHashes.push_back(hash);
+    }
+    return streamFilter.release();
+}
+
+AsmInputFilter* Assembler::openSourceFile(const CString& filename)
+{
+    return openFileInputFilter(nullptr, filename, sourceFileHashes);
+}
+
 bool Assembler::includeFile(const char* pseudoOpPlace, const std::string& filename)
 {
     if (inclusionLevel == 500)
         THIS_FAIL_BY_ERROR(pseudoOpPlace, "Inclusion level is greater than 500")
-    std::unique_ptr<AsmInputFilter> newInputFilter(new AsmStreamInputFilter(
-                getSourcePos(pseudoOpPlace), filename));
+    const AsmSourcePos pos = getSourcePos(pseudoOpPlace);
+    std::unique_ptr<AsmInputFilter> newInputFilter(openFileInputFilter(&pos,
+                filename.c_str(), dependencyFileHashes));
+    dependencyFiles.push_back(filename);
     asmInputFilters.push(newInputFilter.release());
+    ASM_STATS_COUNT(*this, inputFilterAllocsNum)
     currentInputFilter = asmInputFilters.top();
     inclusionLevel++;
     return true;
@@ -2456,6 +2555,9 @@ bool Assembler::includeFile(const char* pseudoOpPlace, const std::string& filena
 
 bool Assembler::readLine()
 {
+    // substituted lines from macros are charged to macro phase
+    ASM_STATS_PHASE(*this, currentInputFilter->getType() ==
+            AsmInputFilterType::MACROSUBST ? AsmPhase::MACRO : AsmPhase::INPUT)
     line = currentInputFilter->readLine(*this, lineSize);
     while (line == nullptr)
     {
@@ -2480,20 +2582,25 @@ bool Assembler::readLine()
                 delete asmInputFilters.top();
                 asmInputFilters.pop();
                 /// create new input filter
-                std::unique_ptr<AsmStreamInputFilter> thatFilter(
-                    new AsmStreamInputFilter(filenames[filenameIndex++]));
+                std::unique_ptr<AsmInputFilter> thatFilter(
+                    openSourceFile(filenames[filenameIndex++]));
                 asmInputFilters.push(thatFilter.get());
                 currentInputFilter = thatFilter.release();
+                ASM_STATS_COUNT(*this, inputFilterAllocsNum)
                 line = currentInputFilter->readLine(*this, lineSize);
             } while (line==nullptr && filenameIndex<filenames.size());
             
-            return (line!=nullptr);
+            if (line==nullptr)
+                return false;
+            ASM_STATS_COUNT(*this, linesNum)
+            return true;
         }
         else
             return false;
         currentInputFilter = asmInputFilters.top();
         line = currentInputFilter->readLine(*this, lineSize);
     }
+    ASM_STATS_COUNT(*this, linesNum)
     return true;
 }
 
@@ -2851,6 +2958,46 @@ void Assembler::printUnresolvedSymbols(AsmScope* thisScope)
     }
 }
 
+#ifdef HAVE_ASM_STATS
+// count symbols in scope and its nested scopes
+static uint64_t countSymbolsInScope(const AsmScope& scope)
+{
+    uint64_t count = scope.symbolMap.size();
+    for (const auto& entry: scope.scopeMap)
+        count += countSymbolsInScope(*entry.second);
+    return count;
+}
+#endif
+
+void Assembler::checkWaits()
+{
+    for (AsmSectionId i = 0; i < sections.size(); i++)
+    {
+        const AsmSection& section = sections[i];
+        if (section.waitHandler == nullptr)
+            continue; // no instructions in section
+        try
+        {
+            AsmRegAllocator regAlloc(*this);
+            regAlloc.createCodeStructure(section.codeFlow, section.content.size(),
+                        section.content.data());
+            if (section.usageHandler != nullptr)
+                regAlloc.createUsageArrays(*section.usageHandler);
+            AsmWaitScheduler waitScheduler(isaAssembler->getWaitConfig(), *this,
+                        regAlloc.getCodeBlocks(), regAlloc.getUsageArrays(),
+                        nullptr, nullptr, true);
+            waitScheduler.schedule(i);
+        }
+        catch(const AsmException& ex)
+        {
+            // code structure can not be determined (for example data between code)
+            if ((flags & ASM_WARNINGS) != 0)
+                messageStream << (section.name != nullptr ? section.name : "") <<
+                        ": Warning: Waits are not checked: " << ex.what() << std::endl;
+        }
+    }
+}
+
 bool Assembler::assemble()
 {
     resolvingRelocs = false;
@@ -2865,6 +3012,12 @@ bool Assembler::assemble()
                     "was ignored" << std::endl;
     
     good = true;
+    // wait checking needs source positions of instructions
+    if ((flags & ASM_CHECKWAITS) != 0)
+        collectSourcePoses = true;
+    collectStats = (flags & ASM_STATS) != 0;
+    if (collectStats)
+        switchPhase(cxuint(AsmPhase::OTHER));
     while (!endOfAssembly)
     {
         if (!lineAlreadyRead)
@@ -2918,13 +3071,22 @@ bool Assembler::assemble()
                     break;
                 }
                 /* prevLRes - iterator to previous instance of local label (with 'b)
-                 * nextLRes - iterator to next instance of local label (with 'f) */
-                AsmSymbolEntry& prevLRes =
-                        *globalScope.symbolMap.insert(std::make_pair(
-                            std::string(firstName.c_str())+"b", AsmSymbol())).first;
-                AsmSymbolEntry& nextLRes =
-                        *globalScope.symbolMap.insert(std::make_pair(
-                            std::string(firstName.c_str())+"f", AsmSymbol())).first;
+                 * nextLRes - iterator to next instance of local label (with 'f)
+                 * symbols are remembered to avoid building their names again */
+                auto lit = localLabelEntries.find(firstName);
+                if (lit == localLabelEntries.end())
+                {
+                    AsmSymbolEntry* prevEntry = &*globalScope.symbolMap.insert(
+                        std::make_pair(std::string(firstName.c_str())+"b",
+                                       AsmSymbol())).first;
+                    AsmSymbolEntry* nextEntry = &*globalScope.symbolMap.insert(
+                        std::make_pair(std::string(firstName.c_str())+"f",
+                                       AsmSymbol())).first;
+                    lit = localLabelEntries.insert(std::make_pair(firstName,
+                                std::make_pair(prevEntry, nextEntry))).first;
+                }
+                AsmSymbolEntry& prevLRes = *lit->second.first;
+                AsmSymbolEntry& nextLRes = *lit->second.second;
                 /* resolve forward symbol of label now */
                 assert(setSymbol(nextLRes, currentOutPos, currentSection));
                 // move symbol value from next local label into previous local label
@@ -3016,7 +3178,10 @@ bool Assembler::assemble()
             sourcePos = getSourcePos(stmtPlace);
         
         if (firstName.size() >= 2 && firstName[0] == '.') // check for pseudo-op
+        {
+            ASM_STATS_PHASE(*this, AsmPhase::PSEUDO_OP)
             parsePseudoOps(firstName, stmtPlace, linePtr);
+        }
         else if (firstName.size() >= 1 && isDigit(firstName[0]))
             printError(stmtPlace, "Illegal number at statement begin");
         else
@@ -3051,10 +3216,13 @@ bool Assembler::assemble()
                 if (sections[currentSection].waitHandler == nullptr)
                     sections[currentSection].waitHandler.reset(new ISAWaitHandler());
                 
-                isaAssembler->assemble(firstName, stmtPlace, linePtr, end,
+                {
+                    ASM_STATS_PHASE(*this, AsmPhase::INSTRUCTION)
+                    isaAssembler->assemble(firstName, stmtPlace, linePtr, end,
                            sections[currentSection].content,
                            sections[currentSection].usageHandler.get(),
                            sections[currentSection].waitHandler.get());
+                }
                 currentOutPos = sections[currentSection].getSize();
             }
         }
@@ -3093,6 +3261,8 @@ bool Assembler::assemble()
         clauses.pop();
     }
     
+    if (collectStats)
+        switchPhase(cxuint(AsmPhase::RESOLVING));
     if (withSectionDiffs())
     {
         formatHandler->prepareSectionDiffsResolving();
@@ -3131,6 +3301,9 @@ bool Assembler::assemble()
             if (section.usageHandler!=nullptr)
                 section.usageHandler->flush();
         
+        if ((flags & ASM_CHECKWAITS) != 0)
+            checkWaits();
+        
         // code opened regions for kernels
         for (AsmKernelId i = 0; i < kernels.size(); i++)
         {
@@ -3146,8 +3319,15 @@ bool Assembler::assemble()
             kernels[i].closeCodeRegion(contentSize);
         }
         // prepare binary
+        ASM_STATS_PHASE(*this, AsmPhase::PREPARE_BINARY)
         formatHandler->prepareBinary();
     }
+#ifdef HAVE_ASM_STATS
+    stats.symbolsNum = countSymbolsInScope(globalScope);
+    stats.relocationsNum = relocations.size();
+#endif
+    if (collectStats)
+        switchPhase(ASM_PHASES_NUM);
     return good;
 }
 
@@ -3159,6 +3339,7 @@ void Assembler::writeBinary(const char* filename) const
         if (formatHandler!=nullptr)
         {
             std::ofstream ofs(filename, std::ios::binary);
+            ASM_STATS_PHASE(*this, AsmPhase::WRITE_BINARY)
             if (ofs)
                 formatHandler->writeBinary(ofs);
             else
@@ -3177,7 +3358,10 @@ void Assembler::writeBinary(std::ostream& outStream) const
     {
         const AsmFormatHandler* formatHandler = getFormatHandler();
         if (formatHandler!=nullptr)
+        {
+            ASM_STATS_PHASE(*this, AsmPhase::WRITE_BINARY)
             formatHandler->writeBinary(outStream);
+        }
         else
             throw AsmException("No output binary");
     }
@@ -3191,10 +3375,126 @@ void Assembler::writeBinary(Array<cxbyte>& array) const
     {
         const AsmFormatHandler* formatHandler = getFormatHandler();
         if (formatHandler!=nullptr)
+        {
+            ASM_STATS_PHASE(*this, AsmPhase::WRITE_BINARY)
             formatHandler->writeBinary(array);
+        }
         else
             throw AsmException("No output binary");
     }
     else // failed
         throw AsmException("Assembler failed!");
 }
+
+/*
+ * cached assembling session
+ */
+
+// calculate hash of file content
+static bool hashSourceFile(const char* filename, std::pair<uint64_t, uint64_t>& hash)
+{
+    try
+    {
+        MappedFile file(filename);
+        hash = calculateHash128(file.size(), file.data());
+        return true;
+    }
+    catch(const Exception&)
+    { return false; }
+}
+
+AsmCachedSession::AsmCachedSession(const AssemblerFactory& _factory,
+            std::ostream& msgStream) : factory(_factory), messageStream(msgStream),
+            binaryWritten(false), good(false), reused(false)
+{ }
+
+bool AsmCachedSession::sourcesUnchanged() const
+{
+    if (assembler == nullptr || !good || sourceFiles.empty())
+        return false;
+    // include resolution is changed if file appeared before resolved file
+    for (const CString& absentFile: absentFiles)
+        if (isFileExists(absentFile.c_str()))
+            return false;
+    for (const SourceFile& sourceFile: sourceFiles)
+    {
+        std::pair<uint64_t, uint64_t> hash;
+        if (!hashSourceFile(sourceFile.filename.c_str(), hash) || hash != sourceFile.hash)
+            return false;
+    }
+    return true;
+}
+
+void AsmCachedSession::collectSourceFiles()
+{
+    sourceFiles.clear();
+    absentFiles.clear();
+    /* hashes are calculated by assembler from content that has been read,
+     * hence file changed while assembling will not be taken as unchanged */
+    const std::vector<std::pair<uint64_t, uint64_t> >& sourceHashes =
+                assembler->sourceFileHashes;
+    const std::vector<std::pair<uint64_t, uint64_t> >& depHashes =
+                assembler->dependencyFileHashes;
+    if (assembler->filenames.empty() ||  // source from stream can not be checked
+        sourceHashes.size() != assembler->filenames.size() ||
+        depHashes.size() != assembler->dependencyFiles.size())
+        return;
+    std::unordered_set<CString> visited;
+    for (size_t i = 0; i < sourceHashes.size() + depHashes.size(); i++)
+    {
+        const bool isSource = i < sourceHashes.size();
+        const size_t depIndex = i - sourceHashes.size();
+        const CString& filename = isSource ? assembler->filenames[i] :
+                assembler->dependencyFiles[depIndex];
+        if (!visited.insert(filename).second)
+            continue;
+        sourceFiles.push_back({ filename, isSource ? sourceHashes[i] :
+                    depHashes[depIndex] });
+    }
+    absentFiles = assembler->absentDependencyFiles;
+}
+
+bool AsmCachedSession::assemble()
+{
+    if (sourcesUnchanged())
+    {
+        messageStream << messages;
+        messageStream.flush();
+        reused = true;
+        return good;
+    }
+    reused = false;
+    binaryWritten = false;
+    binary.clear();
+    sourceFiles.clear();
+    absentFiles.clear();
+    assembler.reset(); // free old assembler before creating new
+    
+    assemblerMsgStream.str("");
+    assemblerMsgStream.clear();
+    assembler.reset(factory(assemblerMsgStream));
+    /* hashes of sources are needed to check them later (first source file is
+     * opened by constructor, hence flag can not be set here) */
+    if ((assembler->getFlags() & ASM_FILEHASHES) == 0)
+        throw AsmException("Assembler in session must be created with "
+                    "ASM_FILEHASHES flag");
+    good = assembler->assemble();
+    messages = assemblerMsgStream.str();
+    messageStream << messages;
+    messageStream.flush();
+    if (good)
+        collectSourceFiles();
+    return good;
+}
+
+const Array<cxbyte>& AsmCachedSession::getBinary()
+{
+    if (!binaryWritten)
+    {
+        if (assembler == nullptr)
+            throw AsmException("Nothing has been assembled");
+        assembler->writeBinary(binary);
+        binaryWritten = true;
+    }
+    return binary;
+}
@@ -1544,6 +1544,22 @@ void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
         printDisasmData(amdInput->globalDataSize, amdInput->globalData, output);
     }
     
+    // disassemble codes of kernels concurrently and write them later in order
+    const bool doParallel = doDumpCode && (flags & DISASM_PARALLEL) != 0;
+    std::vector<std::string> kernelCodes;
+    if (doParallel)
+    {
+        std::vector<const AmdDisasmKernelInput*> codeKernels;
+        for (const AmdDisasmKernelInput& kinput: amdInput->kernels)
+            if (kinput.code != nullptr && kinput.codeSize != 0)
+                codeKernels.push_back(&kinput);
+        ISADisassembler::disassembleCodesParallel(isaDisassembler, codeKernels.size(),
+                sectionCount, [&codeKernels](size_t i, ISADisassembler* codeDisasm)
+                { codeDisasm->setInput(codeKernels[i]->codeSize, codeKernels[i]->code); },
+                kernelCodes);
+    }
+    size_t codeIndex = 0;
+    
     for (const AmdDisasmKernelInput& kinput: amdInput->kernels)
     {
         output.write(".kernel ", 8);
@@ -1564,9 +1580,17 @@ void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
         {
             // input kernel code (main disassembly)
             output.write("    .text\n", 10);
-            isaDisassembler->setInput(kinput.codeSize, kinput.code);
-            isaDisassembler->beforeDisassemble();
-            isaDisassembler->disassemble();
+            if (doParallel)
+            {
+                const std::string& kernelCode = kernelCodes[codeIndex++];
+                output.write(kernelCode.c_str(), kernelCode.size());
+            }
+            else
+            {
+                isaDisassembler->setInput(kinput.codeSize, kinput.code);
+                isaDisassembler->beforeDisassemble();
+                isaDisassembler->disassemble();
+            }
             sectionCount++;
         }
     }
@@ -1023,6 +1023,31 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(amdCL2Input->deviceType);
     const cxuint maxSgprsNum = getGPUMaxRegistersNum(arch, REGTYPE_SGPR, 0);
     
+    // disassemble codes of kernels concurrently and write them later in order
+    const bool doParallel = !doHSALayout && doDumpCode &&
+                (flags & DISASM_PARALLEL) != 0;
+    std::vector<std::string> kernelCodes;
+    if (doParallel)
+    {
+        std::vector<const AmdCL2DisasmKernelInput*> codeKernels;
+        for (const AmdCL2DisasmKernelInput& kinput: amdCL2Input->kernels)
+            if (kinput.code != nullptr && kinput.codeSize != 0)
+                codeKernels.push_back(&kinput);
+        ISADisassembler::disassembleCodesParallel(isaDisassembler, codeKernels.size(),
+                sectionCount, [&codeKernels](size_t i, ISADisassembler* codeDisasm)
+                {
+                    const AmdCL2DisasmKernelInput& kinput = *codeKernels[i];
+                    codeDisasm->addRelSymbol(".gdata");
+                    codeDisasm->addRelSymbol(".ddata"); // rw data
+                    codeDisasm->addRelSymbol(".bdata"); // .bss data
+                    for (const AmdCL2RelaEntry& entry: kinput.textRelocs)
+                        codeDisasm->addRelocation(entry.offset, entry.type,
+                                    cxuint(entry.symbol), entry.addend);
+                    codeDisasm->setInput(kinput.codeSize, kinput.code);
+                }, kernelCodes);
+    }
+    size_t codeIndex = 0;
+    
     for (const AmdCL2DisasmKernelInput& kinput: amdCL2Input->kernels)
     {
         output.write(".kernel ", 8);
@@ -1090,7 +1115,16 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
             dumpAmdCL2ArgsAndSamplers(output, config);
         }
         
-        if (!doHSALayout && doDumpCode && kinput.code != nullptr && kinput.codeSize != 0)
+        if (doParallel && kinput.code != nullptr && kinput.codeSize != 0)
+        {
+            // write kernel code disassembled concurrently
+            output.write("    .text\n", 10);
+            const std::string& kernelCode = kernelCodes[codeIndex++];
+            output.write(kernelCode.c_str(), kernelCode.size());
+            sectionCount++;
+        }
+        else if (!doHSALayout && doDumpCode && kinput.code != nullptr &&
+                kinput.codeSize != 0)
         {
             // input kernel code (main disassembly)
             isaDisassembler->clearRelocations();
@@ -21,6 +21,7 @@
 #include <string>
 #include <cstring>
 #include <ostream>
+#include <sstream>
 #include <cstring>
 #include <memory>
 #include <vector>
@@ -40,7 +41,7 @@ DisasmException::DisasmException(const std::string& message) : Exception(message
 
 ISADisassembler::ISADisassembler(Disassembler& _disassembler, cxuint outBufSize)
         : disassembler(_disassembler), startOffset(0), labelStartOffset(0),
-          dontPrintLabelsAfterCode(false), output(outBufSize, _disassembler.getOutput())
+          inputDecoded(false), dontPrintLabelsAfterCode(false), output(outBufSize, _disassembler.getOutput())
 { }
 
 ISADisassembler::~ISADisassembler()
@@ -284,9 +285,34 @@ void ISADisassembler::beforeDisassemble()
     prepareLabelsAndRelocations();
 }
 
+void ISADisassembler::disassembleCodesParallel(ISADisassembler* isaDisassembler,
+            size_t codesNum, size_t firstSection,
+            const std::function<void(size_t, ISADisassembler*)>& setupCode,
+            std::vector<std::string>& outputs)
+{
+    const Disassembler& mainDisasm = isaDisassembler->disassembler;
+    const GPUDeviceType deviceType = mainDisasm.getDeviceType();
+    const Flags flags = mainDisasm.getFlags();
+    outputs.assign(codesNum, std::string());
+    runParallelJobs(codesNum, mainDisasm.threadsNum, [&](size_t i)
+    {
+        std::ostringstream codeOutput;
+        // disassembler for this code only (to set own section and output)
+        Disassembler codeDisasm(deviceType, 0, nullptr, codeOutput, flags);
+        codeDisasm.sectionCount = firstSection + i;
+        ISADisassembler* codeIsaDisasm = codeDisasm.isaDisassembler.get();
+        setupCode(i, codeIsaDisasm);
+        codeIsaDisasm->beforeDisassemble();
+        codeIsaDisasm->disassemble();
+        codeIsaDisasm->flushOutput();
+        outputs[i] = codeOutput.str();
+    });
+}
+
 Disassembler::Disassembler(const AmdMainGPUBinary32& binary, std::ostream& _output,
             Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
-            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdInput = getAmdDisasmInputFromBinary32(binary, flags);
@@ -294,7 +320,8 @@ Disassembler::Disassembler(const AmdMainGPUBinary32& binary, std::ostream& _outp
 
 Disassembler::Disassembler(const AmdMainGPUBinary64& binary, std::ostream& _output,
             Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
-            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdInput = getAmdDisasmInputFromBinary64(binary, flags);
@@ -303,7 +330,8 @@ Disassembler::Disassembler(const AmdMainGPUBinary64& binary, std::ostream& _outp
 Disassembler::Disassembler(const AmdCL2MainGPUBinary32& binary, std::ostream& _output,
            Flags _flags, cxuint driverVersion) : fromBinary(true),
             binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr), output(_output),
-            flags(_flags), sectionCount(0)
+            flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdCL2Input = getAmdCL2DisasmInputFromBinary32(binary, driverVersion,
@@ -313,7 +341,8 @@ Disassembler::Disassembler(const AmdCL2MainGPUBinary32& binary, std::ostream& _o
 Disassembler::Disassembler(const AmdCL2MainGPUBinary64& binary, std::ostream& _output,
            Flags _flags, cxuint driverVersion) : fromBinary(true),
             binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr), output(_output),
-            flags(_flags), sectionCount(0)
+            flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdCL2Input = getAmdCL2DisasmInputFromBinary64(binary, driverVersion,
@@ -322,7 +351,8 @@ Disassembler::Disassembler(const AmdCL2MainGPUBinary64& binary, std::ostream& _o
 
 Disassembler::Disassembler(const ROCmBinary& binary, std::ostream& _output, Flags _flags)
          : fromBinary(true), binaryFormat(BinaryFormat::ROCM),
-           rocmInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+           rocmInput(nullptr), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     rocmInput = getROCmDisasmInputFromBinary(binary);
@@ -330,21 +360,24 @@ Disassembler::Disassembler(const ROCmBinary& binary, std::ostream& _output, Flag
 
 Disassembler::Disassembler(const AmdDisasmInput* disasmInput, std::ostream& _output,
             Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMD),
-            amdInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            amdInput(disasmInput), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
 
 Disassembler::Disassembler(const AmdCL2DisasmInput* disasmInput, std::ostream& _output,
             Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMDCL2),
-            amdCL2Input(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            amdCL2Input(disasmInput), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
 
 Disassembler::Disassembler(const ROCmDisasmInput* disasmInput, std::ostream& _output,
                  Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::ROCM),
-            rocmInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            rocmInput(disasmInput), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
@@ -352,7 +385,8 @@ Disassembler::Disassembler(const ROCmDisasmInput* disasmInput, std::ostream& _ou
 Disassembler::Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary,
            std::ostream& _output, Flags _flags, cxuint llvmVersion) :
            fromBinary(true), binaryFormat(BinaryFormat::GALLIUM),
-           galliumInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+           galliumInput(nullptr), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     galliumInput = getGalliumDisasmInputFromBinary(deviceType, binary, llvmVersion);
@@ -360,7 +394,8 @@ Disassembler::Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary
 
 Disassembler::Disassembler(const GalliumDisasmInput* disasmInput, std::ostream& _output,
              Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::GALLIUM),
-            galliumInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            galliumInput(disasmInput), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
@@ -368,7 +403,8 @@ Disassembler::Disassembler(const GalliumDisasmInput* disasmInput, std::ostream&
 Disassembler::Disassembler(GPUDeviceType deviceType, size_t rawCodeSize,
            const cxbyte* rawCode, std::ostream& _output, Flags _flags)
        : fromBinary(true), binaryFormat(BinaryFormat::RAWCODE),
-         output(_output), flags(_flags), sectionCount(0)
+         output(_output), flags(_flags), sectionCount(0),
+            threadsNum(0)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     rawInput = new RawCodeInput{ deviceType, rawCodeSize, rawCode };
@@ -418,6 +418,13 @@ static inline void updateRegFlags(Flags& regFlags, cxuint reg, GPUArchMask arch)
         regFlags |= GCN_XNACK;
 }
 
+// find mnemonic entry in perfect hash table (returns null if not found)
+CLRX_INTERNAL extern const GCNMnemonicHashEntry* findGCNMnemonicEntry(
+            const char* mnemonic);
+// find first instruction for mnemonic and architecture (returns null if not found)
+CLRX_INTERNAL extern const GCNAsmInstruction* findGCNAsmInstruction(
+            const char* mnemonic, GPUArchitecture arch);
+
 };
 
 #endif
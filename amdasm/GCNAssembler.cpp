@@ -32,91 +32,25 @@
 
 using namespace CLRX;
 
-static OnceFlag clrxGCNAssemblerOnceFlag;
-static Array<GCNAsmInstruction> gcnInstrSortedTable;
+const GCNMnemonicHashEntry* CLRX::findGCNMnemonicEntry(const char* mnemonic)
+{
+    const uint32_t hash = calculateFNV1aHash(mnemonic);
+    const uint32_t disp = gcnMnemonicHashDisps[hash & (gcnMnemonicHashBucketsNum-1)];
+    const GCNMnemonicHashEntry& entry = gcnMnemonicHashTable[
+            getPerfectHashPos(hash, disp) & (gcnMnemonicHashTableSize-1)];
+    if (entry.first == UINT16_MAX || entry.hash != hash ||
+        ::strcmp(gcnInstrSortedTable[entry.first].mnemonic, mnemonic) != 0)
+        return nullptr;
+    return &entry;
+}
 
-static void initializeGCNAssembler()
+const GCNAsmInstruction* CLRX::findGCNAsmInstruction(const char* mnemonic,
+            GPUArchitecture arch)
 {
-    size_t tableSize = 0;
-    while (gcnInstrsTable[tableSize].mnemonic!=nullptr)
-        tableSize++;
-    gcnInstrSortedTable.resize(tableSize);
-    for (cxuint i = 0; i < tableSize; i++)
-    {
-        const GCNInstruction& insn = gcnInstrsTable[i];
-        gcnInstrSortedTable[i] = {insn.mnemonic, insn.encoding, insn.mode,
-                    insn.code, UINT16_MAX, insn.archMask};
-    }
-    
-    // sort GCN instruction table by mnemonic, encoding and architecture
-    std::sort(gcnInstrSortedTable.begin(), gcnInstrSortedTable.end(),
-            [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
-            {
-                // compare mnemonic and if mnemonic
-                int r = ::strcmp(instr1.mnemonic, instr2.mnemonic);
-                return (r < 0) || (r==0 && instr1.encoding < instr2.encoding) ||
-                            (r == 0 && instr1.encoding == instr2.encoding &&
-                             instr1.archMask < instr2.archMask);
-            });
-    
-    cxuint j = 0;
-    std::unique_ptr<uint16_t[]> oldArchMasks(new uint16_t[tableSize]);
-    /* join VOP3A instr with VOP2/VOPC/VOP1 instr together to faster encoding. */
-    for (cxuint i = 0; i < tableSize; i++)
-    {
-        GCNAsmInstruction insn = gcnInstrSortedTable[i];
-        if (insn.encoding == GCNENC_VOP3A || insn.encoding == GCNENC_VOP3B)
-        {
-            // check duplicates
-            cxuint k = j-1;
-            while (::strcmp(gcnInstrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
-                    (oldArchMasks[k] & insn.archMask)!=insn.archMask) k--;
-            
-            if (::strcmp(gcnInstrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
-                (oldArchMasks[k] & insn.archMask)==insn.archMask)
-            {
-                // we found duplicate, we apply
-                if (gcnInstrSortedTable[k].code2==UINT16_MAX)
-                {
-                    // if second slot for opcode is not filled
-                    gcnInstrSortedTable[k].code2 = insn.code1;
-                    gcnInstrSortedTable[k].archMask = oldArchMasks[k] & insn.archMask;
-                }
-                else
-                {
-                    // if filled we create new entry
-                    oldArchMasks[j] = gcnInstrSortedTable[j].archMask;
-                    gcnInstrSortedTable[j] = gcnInstrSortedTable[k];
-                    gcnInstrSortedTable[j].archMask = oldArchMasks[k] & insn.archMask;
-                    gcnInstrSortedTable[j++].code2 = insn.code1;
-                }
-            }
-            else // not found
-            {
-                oldArchMasks[j] = insn.archMask;
-                gcnInstrSortedTable[j++] = insn;
-            }
-        }
-        else if (insn.encoding == GCNENC_VINTRP)
-        {
-            // check duplicates
-            cxuint k = j-1;
-            oldArchMasks[j] = insn.archMask;
-            gcnInstrSortedTable[j++] = insn;
-            while (::strcmp(gcnInstrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
-                    gcnInstrSortedTable[k].encoding!=GCNENC_VOP3A) k--;
-            if (::strcmp(gcnInstrSortedTable[k].mnemonic, insn.mnemonic)==0 &&
-                gcnInstrSortedTable[k].encoding==GCNENC_VOP3A)
-                // we found VINTRP duplicate, set up second code (VINTRP)
-                gcnInstrSortedTable[k].code2 = insn.code1;
-        }
-        else // normal instruction
-        {
-            oldArchMasks[j] = insn.archMask;
-            gcnInstrSortedTable[j++] = insn;
-        }
-    }
-    gcnInstrSortedTable.resize(j); // final size
+    const GCNMnemonicHashEntry* entry = findGCNMnemonicEntry(mnemonic);
+    if (entry == nullptr || entry->archIndices[cxuint(arch)] == UINT16_MAX)
+        return nullptr;
+    return gcnInstrSortedTable + entry->archIndices[cxuint(arch)];
 }
 
 // GCN Usage handler
@@ -344,9 +278,7 @@ void GCNUsageHandler::getUsageDependencies(cxuint rvusNum, const AsmRegVarUsage*
 GCNAssembler::GCNAssembler(Assembler& assembler): ISAAssembler(assembler),
         regs({0, 0}), curArchMask(1U<<cxuint(
                     getGPUArchitectureFromDeviceType(assembler.getDeviceType())))
-{
-    callOnce(clrxGCNAssemblerOnceFlag, initializeGCNAssembler);
-}
+{ }
 
 GCNAssembler::~GCNAssembler()
 { }
@@ -398,20 +330,10 @@ void GCNAssembler::assemble(const CString& inMnemonic, const char* mnemPlace,
     else
         mnemonic = inMnemonic;
     
-    // find instruction by mnemonic
-    auto it = binaryFind(gcnInstrSortedTable.begin(), gcnInstrSortedTable.end(),
-               GCNAsmInstruction{mnemonic.c_str()},
-               [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
-               { return ::strcmp(instr1.mnemonic, instr2.mnemonic)<0; });
-    
-    // find matched entry
-    if (it != gcnInstrSortedTable.end() && (it->archMask & curArchMask)==0)
-        // if not match current arch mask
-        for (++it ;it != gcnInstrSortedTable.end() &&
-               ::strcmp(it->mnemonic, mnemonic.c_str())==0 &&
-               (it->archMask & curArchMask)==0; ++it);
-
-    if (it == gcnInstrSortedTable.end() || ::strcmp(it->mnemonic, mnemonic.c_str())!=0)
+    // find instruction by mnemonic (first entry that matches current architecture)
+    const GCNAsmInstruction* it = findGCNAsmInstruction(mnemonic.c_str(),
+                GPUArchitecture(CTZ32(curArchMask)));
+    if (it == nullptr)
     {
         // unrecognized mnemonic
         printError(mnemPlace, "Unknown instruction");
@@ -498,8 +420,8 @@ void GCNAssembler::assemble(const CString& inMnemonic, const char* mnemPlace,
         default:
             break;
     }
-    // register RegVarUsage in tests, do not apply normal usage
-    if (good && (assembler.getFlags() & ASM_TESTRUN) != 0)
+    // register RegVarUsage in tests or for wait checking, do not apply normal usage
+    if (good && (assembler.getFlags() & (ASM_TESTRUN|ASM_CHECKWAITS)) != 0)
     {
         flushInstrRVUs(usageHandler);
         flushWaitInstrs(waitHandler);
@@ -659,10 +581,7 @@ bool GCNAssembler::checkMnemonic(const CString& inMnemonic) const
     else
         mnemonic = inMnemonic;
     
-    return std::binary_search(gcnInstrSortedTable.begin(), gcnInstrSortedTable.end(),
-               GCNAsmInstruction{mnemonic.c_str()},
-               [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
-               { return ::strcmp(instr1.mnemonic, instr2.mnemonic)<0; });
+    return findGCNMnemonicEntry(mnemonic.c_str()) != nullptr;
 }
 
 void GCNAssembler::setAllocatedRegisters(const cxuint* inRegs, Flags inRegFlags)
@@ -898,7 +817,8 @@ static const AsmWaitConfig gcnWaitConfig10 =
         { GCNWAIT_EXPCNT, true, true, 255 },  // GCNDELOP_EXPVMWRITE
         { GCNWAIT_EXPCNT, false, false, 255 }  // GCNDELOP_EXPORT
     },
-    { 16, 8, 8 }
+    { 16, 8, 8 },
+    { "vmcnt", "lgkmcnt", "expcnt" }
 };
 
 
@@ -915,7 +835,8 @@ static const AsmWaitConfig gcnWaitConfig =
         { GCNWAIT_EXPCNT, true, true, 255 },  // GCNDELOP_EXPVMWRITE
         { GCNWAIT_EXPCNT, false, true, 255 }  // GCNDELOP_EXPORT
     },
-    { 16, 16, 8 }
+    { 16, 16, 8 },
+    { "vmcnt", "lgkmcnt", "expcnt" }
 };
 
 // for RX VEGA
@@ -932,7 +853,8 @@ static const AsmWaitConfig gcnWaitConfig14 =
         { GCNWAIT_EXPCNT, true, true, 255 },  // GCNDELOP_EXPVMWRITE
         { GCNWAIT_EXPCNT, false, true, 255 }  // GCNDELOP_EXPORT
     },
-    { 64, 16, 8 }
+    { 64, 16, 8 },
+    { "vmcnt", "lgkmcnt", "expcnt" }
 };
 
 const AsmWaitConfig& GCNAssembler::getWaitConfig() const
@@ -32,16 +32,6 @@
 
 using namespace CLRX;
 
-static OnceFlag clrxGCNDisasmOnceFlag;
-static std::unique_ptr<GCNInstruction[]> gcnInstrTableByCode = nullptr;
-
-// GCN encoding space
-struct CLRX_INTERNAL GCNEncodingSpace
-{
-    cxuint offset;  // first position instrunctions list
-    cxuint instrsNum;   // instruction list
-};
-
 // put chars to buffer (helper)
 static inline void putChars(char*& buf, const char* input, size_t size)
 {
@@ -64,128 +54,9 @@ static const char* gcnEncodingNames[GCNENC_MAXVAL+1] =
     "VOP3A", "VOP3B", "VINTRP", "DS", "MUBUF", "MTBUF", "MIMG", "EXP", "FLAT"
 };
 
-// table hold of GNC encoding regions in main instruction list
-// instruciton position is sum of encoding offset and instruction opcode
-static const GCNEncodingSpace gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3+2] =
-{
-    { 0, 0 },
-    { 0, 0x80 }, /* GCNENC_SOPC, opcode = (7bit)<<16 */
-    { 0x0080, 0x80 }, /* GCNENC_SOPP, opcode = (7bit)<<16 */
-    { 0x0100, 0x100 }, /* GCNENC_SOP1, opcode = (8bit)<<8 */
-    { 0x0200, 0x80 }, /* GCNENC_SOP2, opcode = (7bit)<<23 */
-    { 0x0280, 0x20 }, /* GCNENC_SOPK, opcode = (5bit)<<23 */
-    { 0x02a0, 0x40 }, /* GCNENC_SMRD, opcode = (6bit)<<22 */
-    { 0x02e0, 0x100 }, /* GCNENC_VOPC, opcode = (8bit)<<27 */
-    { 0x03e0, 0x100 }, /* GCNENC_VOP1, opcode = (8bit)<<9 */
-    { 0x04e0, 0x40 }, /* GCNENC_VOP2, opcode = (6bit)<<25 */
-    { 0x0520, 0x200 }, /* GCNENC_VOP3A, opcode = (9bit)<<17 */
-    { 0x0520, 0x200 }, /* GCNENC_VOP3B, opcode = (9bit)<<17 */
-    { 0x0720, 0x4 }, /* GCNENC_VINTRP, opcode = (2bit)<<16 */
-    { 0x0724, 0x100 }, /* GCNENC_DS, opcode = (8bit)<<18 */
-    { 0x0824, 0x80 }, /* GCNENC_MUBUF, opcode = (7bit)<<18 */
-    { 0x08a4, 0x8 }, /* GCNENC_MTBUF, opcode = (3bit)<<16 */
-    { 0x08ac, 0x80 }, /* GCNENC_MIMG, opcode = (7bit)<<18 */
-    { 0x092c, 0x1 }, /* GCNENC_EXP, opcode = none */
-    { 0x092d, 0x80 }, /* GCNENC_FLAT, opcode = (8bit)<<18 (???8bit) */
-    { 0x09ad, 0x200 }, /* GCNENC_VOP3A, opcode = (9bit)<<17 (GCN1.1) */
-    { 0x09ad, 0x200 },  /* GCNENC_VOP3B, opcode = (9bit)<<17 (GCN1.1) */
-    { 0x0bad, 0x0 },
-    { 0x0bad, 0x80 }, /* GCNENC_SOPC, opcode = (7bit)<<16 (GCN1.2) */
-    { 0x0c2d, 0x80 }, /* GCNENC_SOPP, opcode = (7bit)<<16 (GCN1.2) */
-    { 0x0cad, 0x100 }, /* GCNENC_SOP1, opcode = (8bit)<<8 (GCN1.2) */
-    { 0x0dad, 0x80 }, /* GCNENC_SOP2, opcode = (7bit)<<23 (GCN1.2) */
-    { 0x0e2d, 0x20 }, /* GCNENC_SOPK, opcode = (5bit)<<23 (GCN1.2) */
-    { 0x0e4d, 0x100 }, /* GCNENC_SMEM, opcode = (8bit)<<18 (GCN1.2) */
-    { 0x0f4d, 0x100 }, /* GCNENC_VOPC, opcode = (8bit)<<27 (GCN1.2) */
-    { 0x104d, 0x100 }, /* GCNENC_VOP1, opcode = (8bit)<<9 (GCN1.2) */
-    { 0x114d, 0x40 }, /* GCNENC_VOP2, opcode = (6bit)<<25 (GCN1.2) */
-    { 0x118d, 0x400 }, /* GCNENC_VOP3A, opcode = (10bit)<<16 (GCN1.2) */
-    { 0x118d, 0x400 }, /* GCNENC_VOP3B, opcode = (10bit)<<16 (GCN1.2) */
-    { 0x158d, 0x4 }, /* GCNENC_VINTRP, opcode = (2bit)<<16 (GCN1.2) */
-    { 0x1591, 0x100 }, /* GCNENC_DS, opcode = (8bit)<<18 (GCN1.2) */
-    { 0x1691, 0x80 }, /* GCNENC_MUBUF, opcode = (7bit)<<18 (GCN1.2) */
-    { 0x1711, 0x10 }, /* GCNENC_MTBUF, opcode = (4bit)<<16 (GCN1.2) */
-    { 0x1721, 0x80 }, /* GCNENC_MIMG, opcode = (7bit)<<18 (GCN1.2) */
-    { 0x17a1, 0x1 }, /* GCNENC_EXP, opcode = none (GCN1.2) */
-    { 0x17a2, 0x80 }, /* GCNENC_FLAT, opcode = (8bit)<<18 (???8bit) */
-    { 0x1822, 0x40 }, /* GCNENC_VOP2, opcode = (6bit)<<25 (RXVEGA) */
-    { 0x1862, 0x400 }, /* GCNENC_VOP3B, opcode = (10bit)<<17  (RXVEGA) */
-    { 0x1c62, 0x100 }, /* GCNENC_VOP1, opcode = (8bit)<<9 (RXVEGA) */
-    { 0x1d62, 0x80 }, /* GCNENC_FLAT_SCRATCH, opcode = (8bit)<<18 (???8bit) RXVEGA */
-    { 0x1de2, 0x80 }  /* GCNENC_FLAT_GLOBAL, opcode = (8bit)<<18 (???8bit) RXVEGA */
-};
-
-// total instruction table length
-static const size_t gcnInstrTableByCodeLength = 0x1e62;
-
-// create main instruction table
-static void initializeGCNDisassembler()
-{
-    gcnInstrTableByCode.reset(new GCNInstruction[gcnInstrTableByCodeLength]);
-    for (cxuint i = 0; i < gcnInstrTableByCodeLength; i++)
-    {
-        gcnInstrTableByCode[i].mnemonic = nullptr;
-        gcnInstrTableByCode[i].mode = GCN_STDMODE;
-        // except VOP3 decoding routines ignores encoding (we can set None for encoding)
-        gcnInstrTableByCode[i].encoding = GCNENC_NONE;
-    }
-    
-    // fill up main instruction table
-    for (cxuint i = 0; gcnInstrsTable[i].mnemonic != nullptr; i++)
-    {
-        const GCNInstruction& instr = gcnInstrsTable[i];
-        const GCNEncodingSpace& encSpace = gcnInstrTableByCodeSpaces[instr.encoding];
-        if ((instr.archMask & ARCH_GCN_1_0_1) != 0)
-        {
-            if (gcnInstrTableByCode[encSpace.offset + instr.code].mnemonic == nullptr)
-                gcnInstrTableByCode[encSpace.offset + instr.code] = instr;
-            else if((instr.archMask & ARCH_RX2X0) != 0)
-            {
-                /* otherwise we for GCN1.1 */
-                const GCNEncodingSpace& encSpace2 =
-                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
-                gcnInstrTableByCode[encSpace2.offset + instr.code] = instr;
-            }
-            // otherwise we ignore this entry
-        }
-        if ((instr.archMask & ARCH_GCN_1_2_4) != 0)
-        {
-            // for GCN 1.2/1.4
-            const GCNEncodingSpace& encSpace3 = gcnInstrTableByCodeSpaces[
-                        GCNENC_MAXVAL+3+instr.encoding];
-            if (gcnInstrTableByCode[encSpace3.offset + instr.code].mnemonic == nullptr)
-                gcnInstrTableByCode[encSpace3.offset + instr.code] = instr;
-            else if((instr.archMask & ARCH_GCN_1_4) != 0 &&
-                (instr.encoding == GCNENC_VOP2 || instr.encoding == GCNENC_VOP1 ||
-                instr.encoding == GCNENC_VOP3A || instr.encoding == GCNENC_VOP3B))
-            {
-                /* otherwise we for GCN1.4 */
-                const bool encNoVOP2 = instr.encoding != GCNENC_VOP2;
-                const bool encVOP1 = instr.encoding == GCNENC_VOP1;
-                // choose FLAT_GLOBAL or FLAT_SCRATCH space
-                const GCNEncodingSpace& encSpace4 =
-                    gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 + encNoVOP2 + encVOP1];
-                gcnInstrTableByCode[encSpace4.offset + instr.code] = instr;
-            }
-            else if((instr.archMask & ARCH_GCN_1_4) != 0 &&
-                instr.encoding == GCNENC_FLAT && (instr.mode & GCN_FLAT_MODEMASK) != 0)
-            {
-                /* FLAT SCRATCH and GLOBAL instructions */
-                const cxuint encFlatMode = (instr.mode & GCN_FLAT_MODEMASK)-1;
-                const GCNEncodingSpace& encSpace4 =
-                    gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 + encFlatMode];
-                gcnInstrTableByCode[encSpace4.offset + instr.code] = instr;
-            }
-            // otherwise we ignore this entry
-        }
-    }
-}
-
 GCNDisassembler::GCNDisassembler(Disassembler& disassembler)
         : ISADisassembler(disassembler), instrOutOfCode(false)
-{
-    callOnce(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
-}
+{ }
 
 GCNDisassembler::~GCNDisassembler()
 { }
@@ -233,122 +104,6 @@ static const bool gcnSize12Table[16] =
     false // GCNENC_NONE   // 1111 - illegal
 };
 
-void GCNDisassembler::analyzeBeforeDisassemble()
-{
-    const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(input);
-    const size_t codeWordsNum = (inputSize>>2);
-
-    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
-                disassembler.getDeviceType());
-    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
-    const bool isGCN12 = (arch >= GPUArchitecture::GCN1_2);
-    const bool isGCN14 = (arch == GPUArchitecture::GCN1_4);
-    size_t pos;
-    for (pos = 0; pos < codeWordsNum; pos++)
-    {
-        /* scan all instructions and get jump addresses */
-        const uint32_t insnCode = ULEV(codeWords[pos]);
-        if ((insnCode & 0x80000000U) != 0)
-        {
-            if ((insnCode & 0x40000000U) == 0)
-            {
-                // SOP???
-                if  ((insnCode & 0x30000000U) == 0x30000000U)
-                {
-                    // SOP1/SOPK/SOPC/SOPP
-                    const uint32_t encPart = (insnCode & 0x0f800000U);
-                    if (encPart == 0x0e800000U)
-                    {
-                        // SOP1
-                        if ((insnCode&0xff) == 0xff) // literal
-                            pos++;
-                    }
-                    else if (encPart == 0x0f000000U)
-                    {
-                        // SOPC
-                        if ((insnCode&0xff) == 0xff ||
-                            (insnCode&0xff00) == 0xff00) // literal
-                            pos++;
-                    }
-                    else if (encPart == 0x0f800000U)
-                    {
-                        // SOPP
-                        const cxuint opcode = (insnCode>>16)&0x7f;
-                        if (opcode == 2 || (opcode >= 4 && opcode <= 9) ||
-                            // GCN1.1 and GCN1.2 opcodes
-                            ((isGCN11 || isGCN12) &&
-                                    (opcode >= 23 && opcode <= 26))) // if jump
-                            labels.push_back(startOffset +
-                                    ((pos+int16_t(insnCode&0xffff)+1)<<2));
-                    }
-                    else
-                    {
-                        // SOPK
-                        const cxuint opcode = (insnCode>>23)&0x1f;
-                        if ((!isGCN12 && opcode == 17) ||
-                            (isGCN12 && opcode == 16) || // if branch fork
-                            (isGCN14 && opcode == 21)) // if s_call_b64
-                            labels.push_back(startOffset +
-                                    ((pos+int16_t(insnCode&0xffff)+1)<<2));
-                        else if ((!isGCN12 && opcode == 21) ||
-                            (isGCN12 && opcode == 20))
-                            pos++; // additional literal
-                    }
-                }
-                else
-                {
-                    // SOP2
-                    if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                        pos++;  // literal
-                }
-            }
-            else
-            {
-                // SMRD and others
-                const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-                if ((!isGCN12 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                    (isGCN12 && gcnSize12Table[encPart]))
-                    pos++;
-            }
-        }
-        else
-        {
-            // some vector instructions
-            if ((insnCode & 0x7e000000U) == 0x7c000000U)
-            {
-                // VOPC
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;
-            }
-            else if ((insnCode & 0x7e000000U) == 0x7e000000U)
-            {
-                // VOP1
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;
-            }
-            else
-            {
-                // VOP2
-                const cxuint opcode = (insnCode >> 25)&0x3f;
-                if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
-                    (isGCN12 && (opcode == 23 || opcode == 24 ||
-                    opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                    pos++;  // inline 32-bit constant
-                else if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;  // literal
-            }
-        }
-    }
-    
-    instrOutOfCode = (pos != codeWordsNum);
-}
-
 static const cxbyte gcnEncoding11Table[16] =
 {
     GCNENC_SMRD, // 0000
@@ -445,70 +200,39 @@ static const GCNEncodingOpcodeBits gcnEncodingOpcode12Table[GCNENC_MAXVAL+1] =
 };
 
 
-/* main routine */
-
-void GCNDisassembler::disassemble()
+bool GCNDisassembler::decodeInstructions()
 {
-    // select current label and reloc to first
-    LabelIter curLabel = std::lower_bound(labels.begin(), labels.end(), labelStartOffset);
-    RelocIter curReloc = std::lower_bound(relocations.begin(), relocations.end(),
-        std::make_pair(startOffset, Relocation()),
-          [](const std::pair<size_t,Relocation>& a, const std::pair<size_t, Relocation>& b)
-          { return a.first < b.first; });
-    NamedLabelIter curNamedLabel = std::lower_bound(namedLabels.begin(), namedLabels.end(),
-        std::make_pair(labelStartOffset, CString()),
-          [](const std::pair<size_t,CString>& a, const std::pair<size_t, CString>& b)
-          { return a.first < b.first; });
-    
     const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(input);
-
+    const size_t codeWordsNum = (inputSize>>2);
+    
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
                 disassembler.getDeviceType());
     // set up GCN indicators
     const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
     const bool isGCN124 = (arch >= GPUArchitecture::GCN1_2);
     const bool isGCN14 = (arch >= GPUArchitecture::GCN1_4);
-    const GPUArchMask curArchMask = 
-            1U<<int(getGPUArchitectureFromDeviceType(disassembler.getDeviceType()));
-    const size_t codeWordsNum = (inputSize>>2);
-    
-    if ((inputSize&3) != 0)
-        output.write(64,
-           "        /* WARNING: Code size is not aligned to 4-byte word! */\n");
-    if (instrOutOfCode)
-        output.write(54, "        /* WARNING: Unfinished instruction at end! */\n");
+    const GPUArchMask curArchMask = 1U<<int(arch);
     
-    bool prevIsTwoWord = false;
+    instrs.clear();
+    inputDecoded = true;
+    bool outOfCode = false;
     
     size_t pos = 0;
-    while (true)
+    while (pos < codeWordsNum)
     {
-        writeLabelsToPosition(pos<<2, curLabel, curNamedLabel);
-        if (pos >= codeWordsNum)
-            break;
-        
-        const size_t oldPos = pos;
-        cxbyte gcnEncoding = GCNENC_NONE;
+        GCNDisasmInstr instr = { pos, 0, 0, 0, 1, 0, GCNENC_NONE, false };
         const uint32_t insnCode = ULEV(codeWords[pos++]);
+        instr.insnCode = insnCode;
         if (insnCode == 0)
         {
             /* fix for GalliumCOmpute disassemblying (assembler doesn't accep 
              * with two scalar operands */
-            size_t count;
-            for (count = 1; pos < codeWordsNum && codeWords[pos]==0; count++, pos++);
-            // put to output
-            char* buf = output.reserve(40);
-            size_t bufPos = 0;
-            memcpy(buf+bufPos, ".fill ", 6);
-            bufPos += 6;
-            bufPos += itocstrCStyle(count, buf+bufPos, 20);
-            memcpy(buf+bufPos, ", 4, 0\n", 7);
-            bufPos += 7;
-            output.forward(bufPos);
+            for (; pos < codeWordsNum && codeWords[pos]==0; instr.wordsNum++, pos++);
+            instrs.push_back(instr);
             continue;
         }
-        uint32_t insnCode2 = 0;
-        
+        bool haveSecondWord = false;
+        cxbyte gcnEncoding = GCNENC_NONE;
         
         /* determine GCN encoding */
         if ((insnCode & 0x80000000U) != 0)
@@ -523,22 +247,14 @@ void GCNDisassembler::disassemble()
                     if (encPart == 0x0e800000U)
                     {
                         // SOP1
-                        if ((insnCode&0xff) == 0xff) // literal
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
+                        haveSecondWord = ((insnCode&0xff) == 0xff); // literal
                         gcnEncoding = GCNENC_SOP1;
                     }
                     else if (encPart == 0x0f000000U)
                     {
                         // SOPC
-                        if ((insnCode&0xff) == 0xff ||
-                            (insnCode&0xff00) == 0xff00) // literal
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
+                        haveSecondWord = ((insnCode&0xff) == 0xff ||
+                            (insnCode&0xff00) == 0xff00); // literal
                         gcnEncoding = GCNENC_SOPC;
                     }
                     else if (encPart == 0x0f800000U) // SOPP
@@ -547,23 +263,15 @@ void GCNDisassembler::disassemble()
                     {
                         gcnEncoding = GCNENC_SOPK;
                         const uint32_t opcode = ((insnCode>>23)&0x1f);
-                        if ((!isGCN124 && opcode == 21) ||
-                            (isGCN124 && opcode == 20))
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
+                        haveSecondWord = ((!isGCN124 && opcode == 21) ||
+                            (isGCN124 && opcode == 20));
                     }
                 }
                 else
                 {
                     // SOP2
-                    if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                    {
-                        // literal
-                        if (pos < codeWordsNum)
-                            insnCode2 = ULEV(codeWords[pos++]);
-                    }
+                    haveSecondWord = ((insnCode&0xff) == 0xff ||
+                            (insnCode&0xff00) == 0xff00); // literal
                     gcnEncoding = GCNENC_SOP2;
                 }
             }
@@ -571,12 +279,9 @@ void GCNDisassembler::disassemble()
             {
                 // SMRD and others
                 const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-                if ((!isGCN124 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                    (isGCN124 && gcnSize12Table[encPart]))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
+                haveSecondWord = ((!isGCN124 && gcnSize11Table[encPart] &&
+                        (encPart != 7 || isGCN11)) ||
+                        (isGCN124 && gcnSize12Table[encPart]));
                 if (isGCN124)
                     gcnEncoding = gcnEncoding12Table[encPart];
                 else
@@ -591,50 +296,213 @@ void GCNDisassembler::disassemble()
             if ((insnCode & 0x7e000000U) == 0x7c000000U)
             {
                 // VOPC
-                if ((insnCode&0x1ff) == 0xff || // literal
+                haveSecondWord = ((insnCode&0x1ff) == 0xff || // literal
                     // SDWA, DDP
-                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
+                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)));
                 gcnEncoding = GCNENC_VOPC;
             }
             else if ((insnCode & 0x7e000000U) == 0x7e000000U)
             {
                 // VOP1
-                if ((insnCode&0x1ff) == 0xff || // literal
+                haveSecondWord = ((insnCode&0x1ff) == 0xff || // literal
                     // SDWA, DDP
-                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
+                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)));
                 gcnEncoding = GCNENC_VOP1;
             }
             else
             {
                 // VOP2
                 const cxuint opcode = (insnCode >> 25)&0x3f;
-                if ((!isGCN124 && (opcode == 32 || opcode == 33)) ||
+                haveSecondWord = ((!isGCN124 && (opcode == 32 || opcode == 33)) ||
                     (isGCN124 && (opcode == 23 || opcode == 24 ||
-                    opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                else if ((insnCode&0x1ff) == 0xff || // literal
+                    opcode == 36 || opcode == 37)) || // V_MADMK and V_MADAK
+                    (insnCode&0x1ff) == 0xff || // literal
                     // SDWA, DDP
-                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
+                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)));
                 gcnEncoding = GCNENC_VOP2;
             }
         }
         
-        prevIsTwoWord = (oldPos+2 == pos);
+        if (haveSecondWord)
+        {
+            if (pos < codeWordsNum)
+            {
+                instr.insnCode2 = ULEV(codeWords[pos++]);
+                instr.wordsNum = 2;
+            }
+            else // unfinished instruction
+                outOfCode = true;
+        }
+        instr.encoding = gcnEncoding;
+        
+        if (gcnEncoding != GCNENC_NONE)
+        {
+            const GCNEncodingOpcodeBits* encodingOpcodeTable = 
+                    (isGCN124) ? gcnEncodingOpcode12Table : gcnEncodingOpcodeTable;
+            const cxuint opcode =
+                    (insnCode>>encodingOpcodeTable[gcnEncoding].bitPos) & 
+                    ((1U<<encodingOpcodeTable[gcnEncoding].bits)-1U);
+            instr.opcode = opcode;
+            
+            /* find instruction in table */
+            const GCNEncodingSpace& encSpace = 
+                (isGCN124) ? gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+3 + gcnEncoding] :
+                  gcnInstrTableByCodeSpaces[gcnEncoding];
+            const GCNInstruction* gcnInsn = gcnInstrTableByCode +
+                    encSpace.offset + opcode;
+            
+            // try to replace by FMA_MIX for VEGA20
+            if ((curArchMask&ARCH_VEGA20) != 0 && gcnInsn->code>=928 && gcnInsn->code<=930)
+            {
+                const GCNEncodingSpace& encSpace4 =
+                    gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 + 1];
+                const GCNInstruction* thisGCNInstr =
+                        gcnInstrTableByCode + encSpace4.offset + opcode;
+                if (thisGCNInstr->mnemonic != nullptr)
+                    // replace
+                    gcnInsn = thisGCNInstr;
+            }
+            
+            bool isIllegal = false;
+            if (!isGCN124 && gcnInsn->mnemonic != nullptr &&
+                (curArchMask & gcnInsn->archMask) == 0 &&
+                gcnEncoding == GCNENC_VOP3A)
+            {    /* new overrides (VOP3A) */
+                const GCNEncodingSpace& encSpace2 =
+                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
+                gcnInsn = gcnInstrTableByCode + encSpace2.offset + opcode;
+                if (gcnInsn->mnemonic == nullptr ||
+                        (curArchMask & gcnInsn->archMask) == 0)
+                    isIllegal = true; // illegal
+            }
+            else if (isGCN14 && gcnInsn->mnemonic != nullptr &&
+                (curArchMask & gcnInsn->archMask) == 0 &&
+                (gcnEncoding == GCNENC_VOP3A || gcnEncoding == GCNENC_VOP2 ||
+                    gcnEncoding == GCNENC_VOP1))
+            {
+                /* new overrides (VOP1/VOP3A/VOP2 for GCN 1.4) */
+                const GCNEncodingSpace& encSpace4 =
+                        gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 +
+                                (gcnEncoding != GCNENC_VOP2) +
+                                (gcnEncoding == GCNENC_VOP1)];
+                gcnInsn = gcnInstrTableByCode + encSpace4.offset + opcode;
+                if (gcnInsn->mnemonic == nullptr ||
+                        (curArchMask & gcnInsn->archMask) == 0)
+                    isIllegal = true; // illegal
+            }
+            else if (isGCN14 && gcnEncoding == GCNENC_FLAT && ((insnCode>>14)&3)!=0)
+            {
+                // GLOBAL_/SCRATCH_* instructions
+                const GCNEncodingSpace& encSpace4 =
+                    gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 +
+                        ((insnCode>>14)&3)-1];
+                gcnInsn = gcnInstrTableByCode + encSpace4.offset + opcode;
+                if (gcnInsn->mnemonic == nullptr ||
+                        (curArchMask & gcnInsn->archMask) == 0)
+                    isIllegal = true; // illegal
+            }
+            else if (gcnInsn->mnemonic == nullptr ||
+                (curArchMask & gcnInsn->archMask) == 0)
+                isIllegal = true;
+            
+            instr.tableIndex = gcnInsn - gcnInstrTableByCode;
+            instr.isIllegal = isIllegal;
+        }
+        instrs.push_back(instr);
+    }
+    return outOfCode;
+}
+
+void GCNDisassembler::analyzeBeforeDisassemble()
+{
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
+                disassembler.getDeviceType());
+    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
+    const bool isGCN12 = (arch >= GPUArchitecture::GCN1_2);
+    const bool isGCN14 = (arch == GPUArchitecture::GCN1_4);
+    
+    instrOutOfCode = decodeInstructions();
+    /* scan all instructions and get jump addresses */
+    for (const GCNDisasmInstr& instr: instrs)
+    {
+        const cxuint opcode = instr.opcode;
+        if (instr.encoding == GCNENC_SOPP)
+        {
+            if (opcode == 2 || (opcode >= 4 && opcode <= 9) ||
+                // GCN1.1 and GCN1.2 opcodes
+                ((isGCN11 || isGCN12) &&
+                        (opcode >= 23 && opcode <= 26))) // if jump
+                labels.push_back(startOffset +
+                        ((instr.pos+int16_t(instr.insnCode&0xffff)+1)<<2));
+        }
+        else if (instr.encoding == GCNENC_SOPK)
+        {
+            if ((!isGCN12 && opcode == 17) ||
+                (isGCN12 && opcode == 16) || // if branch fork
+                (isGCN14 && opcode == 21)) // if s_call_b64
+                labels.push_back(startOffset +
+                        ((instr.pos+int16_t(instr.insnCode&0xffff)+1)<<2));
+        }
+    }
+}
+
+/* main routine */
+
+void GCNDisassembler::disassemble()
+{
+    // select current label and reloc to first
+    LabelIter curLabel = std::lower_bound(labels.begin(), labels.end(), labelStartOffset);
+    RelocIter curReloc = std::lower_bound(relocations.begin(), relocations.end(),
+        std::make_pair(startOffset, Relocation()),
+          [](const std::pair<size_t,Relocation>& a, const std::pair<size_t, Relocation>& b)
+          { return a.first < b.first; });
+    NamedLabelIter curNamedLabel = std::lower_bound(namedLabels.begin(), namedLabels.end(),
+        std::make_pair(labelStartOffset, CString()),
+          [](const std::pair<size_t,CString>& a, const std::pair<size_t, CString>& b)
+          { return a.first < b.first; });
+    
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
+                disassembler.getDeviceType());
+    // set up GCN indicators
+    const bool isGCN124 = (arch >= GPUArchitecture::GCN1_2);
+    const GPUArchMask curArchMask = 
+            1U<<int(getGPUArchitectureFromDeviceType(disassembler.getDeviceType()));
+    const size_t codeWordsNum = (inputSize>>2);
+    
+    if ((inputSize&3) != 0)
+        output.write(64,
+           "        /* WARNING: Code size is not aligned to 4-byte word! */\n");
+    if (instrOutOfCode)
+        output.write(54, "        /* WARNING: Unfinished instruction at end! */\n");
+    
+    // use instructions decoded while analyzing if input has not been changed
+    if (!inputDecoded)
+        decodeInstructions();
+    
+    for (const GCNDisasmInstr& instr: instrs)
+    {
+        writeLabelsToPosition(instr.pos<<2, curLabel, curNamedLabel);
+        
+        const size_t oldPos = instr.pos;
+        const size_t pos = instr.pos + instr.wordsNum;
+        const cxbyte gcnEncoding = instr.encoding;
+        const uint32_t insnCode = instr.insnCode;
+        const uint32_t insnCode2 = instr.insnCode2;
+        if (insnCode == 0)
+        {
+            // put to output
+            char* buf = output.reserve(40);
+            size_t bufPos = 0;
+            memcpy(buf+bufPos, ".fill ", 6);
+            bufPos += 6;
+            bufPos += itocstrCStyle(instr.wordsNum, buf+bufPos, 20);
+            memcpy(buf+bufPos, ", 4, 0\n", 7);
+            bufPos += 7;
+            output.forward(bufPos);
+            continue;
+        }
+        
+        const bool prevIsTwoWord = (instr.wordsNum == 2);
         
         if (disassembler.getFlags() & DISASM_HEXCODE)
         {
@@ -701,78 +569,18 @@ void GCNDisassembler::disassemble()
         }
         else
         {
-            const GCNEncodingOpcodeBits* encodingOpcodeTable = 
-                    (isGCN124) ? gcnEncodingOpcode12Table : gcnEncodingOpcodeTable;
-            const cxuint opcode =
-                    (insnCode>>encodingOpcodeTable[gcnEncoding].bitPos) & 
-                    ((1U<<encodingOpcodeTable[gcnEncoding].bits)-1U);
-            
-            /* decode instruction and put to output */
+            const cxuint opcode = instr.opcode;
+            const GCNInstruction* gcnInsn = gcnInstrTableByCode + instr.tableIndex;
+            // default instruction have encoding from entry before any overrides
             const GCNEncodingSpace& encSpace = 
                 (isGCN124) ? gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+3 + gcnEncoding] :
                   gcnInstrTableByCodeSpaces[gcnEncoding];
-            const GCNInstruction* gcnInsn = gcnInstrTableByCode.get() +
-                    encSpace.offset + opcode;
-            
-            const GCNInstruction defaultInsn = { nullptr, gcnInsn->encoding, GCN_STDMODE,
-                        0, 0 };
-            
-            // try to replace by FMA_MIX for VEGA20
-            if ((curArchMask&ARCH_VEGA20) != 0 && gcnInsn->code>=928 && gcnInsn->code<=930)
-            {
-                const GCNEncodingSpace& encSpace4 =
-                    gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 + 1];
-                const GCNInstruction* thisGCNInstr =
-                        gcnInstrTableByCode.get() + encSpace4.offset + opcode;
-                if (thisGCNInstr->mnemonic != nullptr)
-                    // replace
-                    gcnInsn = thisGCNInstr;
-            }
+            const GCNInstruction defaultInsn = { nullptr,
+                    gcnInstrTableByCode[encSpace.offset + opcode].encoding, GCN_STDMODE,
+                    0, 0 };
             
             cxuint spacesToAdd = 16;
-            bool isIllegal = false;
-            if (!isGCN124 && gcnInsn->mnemonic != nullptr &&
-                (curArchMask & gcnInsn->archMask) == 0 &&
-                gcnEncoding == GCNENC_VOP3A)
-            {    /* new overrides (VOP3A) */
-                const GCNEncodingSpace& encSpace2 =
-                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace2.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (isGCN14 && gcnInsn->mnemonic != nullptr &&
-                (curArchMask & gcnInsn->archMask) == 0 &&
-                (gcnEncoding == GCNENC_VOP3A || gcnEncoding == GCNENC_VOP2 ||
-                    gcnEncoding == GCNENC_VOP1))
-            {
-                /* new overrides (VOP1/VOP3A/VOP2 for GCN 1.4) */
-                const GCNEncodingSpace& encSpace4 =
-                        gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 +
-                                (gcnEncoding != GCNENC_VOP2) +
-                                (gcnEncoding == GCNENC_VOP1)];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace4.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (isGCN14 && gcnEncoding == GCNENC_FLAT && ((insnCode>>14)&3)!=0)
-            {
-                // GLOBAL_/SCRATCH_* instructions
-                const GCNEncodingSpace& encSpace4 =
-                    gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 +
-                        ((insnCode>>14)&3)-1];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace4.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (gcnInsn->mnemonic == nullptr ||
-                (curArchMask & gcnInsn->archMask) == 0)
-                isIllegal = true;
-            
-            if (!isIllegal)
+            if (!instr.isIllegal)
             {
                 // put spaces between mnemonic and operands
                 size_t k = ::strlen(gcnInsn->mnemonic);
@@ -886,6 +694,9 @@ void GCNDisassembler::disassemble()
         }
         output.put('\n');
     }
+    // decoded instructions are used only once (content of input can be changed later)
+    inputDecoded = false;
+    writeLabelsToPosition(codeWordsNum<<2, curLabel, curNamedLabel);
     if (!dontPrintLabelsAfterCode)
         writeLabelsToEnd(codeWordsNum<<2, curLabel, curNamedLabel);
     output.flush();
@@ -222,6 +222,55 @@ struct CLRX_INTERNAL GCNAsmInstruction
 
 CLRX_INTERNAL extern const GCNInstruction gcnInstrsTable[];
 
+// GCN encoding space
+struct CLRX_INTERNAL GCNEncodingSpace
+{
+    cxuint offset;  // first position instrunctions list
+    cxuint instrsNum;   // instruction list
+};
+
+// table hold of GNC encoding regions in main instruction list
+CLRX_INTERNAL extern const GCNEncodingSpace gcnInstrTableByCodeSpaces[];
+
+/* perfect hash (hash and displace) of GCN mnemonics and pseudo-op names.
+ * Bucket of name is given by its hash (FNV-1a), slot in table is given by hash mixed
+ * with displacement of the bucket. Every name has own slot, hence lookup requires
+ * only one probe and one string comparison. Tables are generated by GCNTablesGen. */
+
+// get slot position in perfect hash table from hash and bucket displacement
+inline uint32_t getPerfectHashPos(uint32_t hash, uint32_t displacement)
+{
+    uint32_t h = hash ^ (displacement * 0x9e3779b9U);
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+// entry of GCN mnemonic hash table
+struct CLRX_INTERNAL GCNMnemonicHashEntry
+{
+    uint32_t hash;  // hash of mnemonic
+    uint16_t first; // index of first instruction in sorted table (UINT16_MAX if empty)
+    // index of first instruction for every architecture (UINT16_MAX if not available)
+    uint16_t archIndices[cxuint(GPUArchitecture::GPUARCH_MAX)+1];
+};
+
+/* tables generated at build time by GCNTablesGen from gcnInstrsTable */
+
+// sorted GCN instruction table for assembler (with merged VOP3 codes)
+CLRX_INTERNAL extern const GCNAsmInstruction gcnInstrSortedTable[];
+CLRX_INTERNAL extern const size_t gcnInstrSortedTableSize;
+// mnemonic perfect hash: displacements for buckets and table of mnemonics
+CLRX_INTERNAL extern const uint32_t gcnMnemonicHashBucketsNum;
+CLRX_INTERNAL extern const uint32_t gcnMnemonicHashTableSize;
+CLRX_INTERNAL extern const uint16_t gcnMnemonicHashDisps[];
+CLRX_INTERNAL extern const GCNMnemonicHashEntry gcnMnemonicHashTable[];
+// main instruction table for disassembler (encoding space offset + opcode)
+CLRX_INTERNAL extern const GCNInstruction gcnInstrTableByCode[];
+
 };
 
 #endif
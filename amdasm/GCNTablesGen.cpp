@@ -0,0 +1,477 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* GCNTablesGen - generates GCN instruction tables at build time:
+ * sorted instruction table for assembler (with merged VOP3 codes), perfect hash of
+ * mnemonics, instruction table for disassembler (indexed by opcode) and
+ * perfect hash of pseudo-op names (from all pseudo-op tables).
+ * Tables are written as constant data, hence assembler and disassembler
+ * do not need initialization at startup. */
+
+#include <CLRX/Config.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include "GCNInternals.h"
+#include "AsmInternals.h"
+
+using namespace CLRX;
+
+// total instruction table length
+static const size_t instrTableByCodeLength = 0x1e62;
+
+static std::vector<GCNAsmInstruction> sortedTable;
+static uint32_t hashBucketsNum = 0;
+static uint32_t hashTableSize = 0;
+static std::vector<uint16_t> hashDisps;
+static std::vector<GCNMnemonicHashEntry> hashTable;
+static std::vector<GCNInstruction> instrTableByCode;
+static uint32_t pseudoOpHashBucketsNum = 0;
+static uint32_t pseudoOpHashTableSize = 0;
+static std::vector<uint16_t> pseudoOpHashDisps;
+static std::vector<AsmPseudoOpHashEntry> pseudoOpHashTable;
+
+static void generateGCNAsmSortedTable()
+{
+    size_t tableSize = 0;
+    while (gcnInstrsTable[tableSize].mnemonic!=nullptr)
+        tableSize++;
+    sortedTable.resize(tableSize);
+    for (cxuint i = 0; i < tableSize; i++)
+    {
+        const GCNInstruction& insn = gcnInstrsTable[i];
+        sortedTable[i] = {insn.mnemonic, insn.encoding, insn.mode,
+                    insn.code, UINT16_MAX, insn.archMask};
+    }
+    
+    // sort GCN instruction table by mnemonic, encoding and architecture
+    std::sort(sortedTable.begin(), sortedTable.end(),
+            [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
+            {
+                // compare mnemonic and if mnemonic
+                int r = ::strcmp(instr1.mnemonic, instr2.mnemonic);
+                return (r < 0) || (r==0 && instr1.encoding < instr2.encoding) ||
+                            (r == 0 && instr1.encoding == instr2.encoding &&
+                             instr1.archMask < instr2.archMask);
+            });
+    
+    cxuint j = 0;
+    std::unique_ptr<uint16_t[]> oldArchMasks(new uint16_t[tableSize]);
+    /* join VOP3A instr with VOP2/VOPC/VOP1 instr together to faster encoding. */
+    for (cxuint i = 0; i < tableSize; i++)
+    {
+        GCNAsmInstruction insn = sortedTable[i];
+        if (insn.encoding == GCNENC_VOP3A || insn.encoding == GCNENC_VOP3B)
+        {
+            // check duplicates
+            cxuint k = j-1;
+            while (::strcmp(sortedTable[k].mnemonic, insn.mnemonic)==0 &&
+                    (oldArchMasks[k] & insn.archMask)!=insn.archMask) k--;
+            
+            if (::strcmp(sortedTable[k].mnemonic, insn.mnemonic)==0 &&
+                (oldArchMasks[k] & insn.archMask)==insn.archMask)
+            {
+                // we found duplicate, we apply
+                if (sortedTable[k].code2==UINT16_MAX)
+                {
+                    // if second slot for opcode is not filled
+                    sortedTable[k].code2 = insn.code1;
+                    sortedTable[k].archMask = oldArchMasks[k] & insn.archMask;
+                }
+                else
+                {
+                    // if filled we create new entry
+                    oldArchMasks[j] = sortedTable[j].archMask;
+                    sortedTable[j] = sortedTable[k];
+                    sortedTable[j].archMask = oldArchMasks[k] & insn.archMask;
+                    sortedTable[j++].code2 = insn.code1;
+                }
+            }
+            else // not found
+            {
+                oldArchMasks[j] = insn.archMask;
+                sortedTable[j++] = insn;
+            }
+        }
+        else if (insn.encoding == GCNENC_VINTRP)
+        {
+            // check duplicates
+            cxuint k = j-1;
+            oldArchMasks[j] = insn.archMask;
+            sortedTable[j++] = insn;
+            while (::strcmp(sortedTable[k].mnemonic, insn.mnemonic)==0 &&
+                    sortedTable[k].encoding!=GCNENC_VOP3A) k--;
+            if (::strcmp(sortedTable[k].mnemonic, insn.mnemonic)==0 &&
+                sortedTable[k].encoding==GCNENC_VOP3A)
+                // we found VINTRP duplicate, set up second code (VINTRP)
+                sortedTable[k].code2 = insn.code1;
+        }
+        else // normal instruction
+        {
+            oldArchMasks[j] = insn.archMask;
+            sortedTable[j++] = insn;
+        }
+    }
+    sortedTable.resize(j); // final size
+}
+
+/* build perfect hash (hash and displace) from hashes of names.
+ * returns number of buckets, size of table, displacements of buckets and
+ * index of name for every slot of table (SIZE_MAX if slot is empty) */
+static void buildPerfectHash(const std::vector<uint32_t>& hashes, uint32_t& bucketsNum,
+            uint32_t& tableSize, std::vector<uint16_t>& disps, std::vector<size_t>& slots)
+{
+    bucketsNum = 1;
+    while (bucketsNum < hashes.size()/4)
+        bucketsNum <<= 1;
+    tableSize = 1;
+    while (tableSize < hashes.size()*2)
+        tableSize <<= 1;
+    
+    // sort buckets by size (place largest buckets first)
+    std::vector<std::vector<size_t> > buckets(bucketsNum);
+    for (size_t i = 0; i < hashes.size(); i++)
+        buckets[hashes[i] & (bucketsNum-1)].push_back(i);
+    std::vector<cxuint> bucketOrder(bucketsNum);
+    for (cxuint i = 0; i < bucketsNum; i++)
+        bucketOrder[i] = i;
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(),
+            [&buckets](cxuint b1, cxuint b2)
+            { return buckets[b1].size() > buckets[b2].size(); });
+    
+    while (true)
+    {
+        disps.assign(bucketsNum, 0);
+        slots.assign(tableSize, SIZE_MAX);
+        
+        bool failed = false;
+        std::vector<uint32_t> positions;
+        for (cxuint b: bucketOrder)
+        {
+            const std::vector<size_t>& bucket = buckets[b];
+            if (bucket.empty())
+                break;
+            // find displacement that puts all names of bucket in free slots
+            uint32_t disp = 0;
+            for (; disp < UINT16_MAX; disp++)
+            {
+                positions.clear();
+                bool good = true;
+                for (size_t ni: bucket)
+                {
+                    const uint32_t pos = getPerfectHashPos(hashes[ni], disp) &
+                                (tableSize-1);
+                    if (slots[pos] != SIZE_MAX ||
+                        std::find(positions.begin(), positions.end(), pos) !=
+                                positions.end())
+                    {
+                        good = false;
+                        break;
+                    }
+                    positions.push_back(pos);
+                }
+                if (good)
+                    break;
+            }
+            if (disp == UINT16_MAX)
+            {
+                failed = true;
+                break;
+            }
+            disps[b] = disp;
+            for (size_t k = 0; k < bucket.size(); k++)
+                slots[positions[k]] = bucket[k];
+        }
+        if (!failed)
+            break;
+        tableSize <<= 1; // try again with greater table
+    }
+}
+
+// build perfect hash for mnemonics from sorted instruction table
+static void generateGCNMnemonicHash()
+{
+    const cxuint archsNum = cxuint(GPUArchitecture::GPUARCH_MAX)+1;
+    // collect mnemonics: first instruction index and indices for architectures
+    std::vector<GCNMnemonicHashEntry> mnemonics;
+    for (size_t i = 0; i < sortedTable.size(); i++)
+    {
+        const GCNAsmInstruction& insn = sortedTable[i];
+        if (mnemonics.empty() || ::strcmp(sortedTable[
+                    mnemonics.back().first].mnemonic, insn.mnemonic) != 0)
+        {
+            GCNMnemonicHashEntry entry;
+            entry.hash = calculateFNV1aHash(insn.mnemonic);
+            entry.first = i;
+            std::fill(entry.archIndices, entry.archIndices+archsNum, UINT16_MAX);
+            mnemonics.push_back(entry);
+        }
+        GCNMnemonicHashEntry& entry = mnemonics.back();
+        for (cxuint arch = 0; arch < archsNum; arch++)
+            // first matching instruction for this architecture
+            if (entry.archIndices[arch] == UINT16_MAX &&
+                (insn.archMask & (1U<<arch)) != 0)
+                entry.archIndices[arch] = i;
+    }
+    
+    std::vector<uint32_t> hashes(mnemonics.size());
+    for (size_t i = 0; i < mnemonics.size(); i++)
+        hashes[i] = mnemonics[i].hash;
+    std::vector<size_t> slots;
+    buildPerfectHash(hashes, hashBucketsNum, hashTableSize, hashDisps, slots);
+    
+    hashTable.assign(hashTableSize, GCNMnemonicHashEntry());
+    for (uint32_t i = 0; i < hashTableSize; i++)
+        if (slots[i] != SIZE_MAX)
+            hashTable[i] = mnemonics[slots[i]];
+        else
+            hashTable[i].first = UINT16_MAX;
+}
+
+// build perfect hash for pseudo-op names from all pseudo-op tables
+static void generateAsmPseudoOpHash()
+{
+    // collect distinct names with indices in tables
+    std::vector<AsmPseudoOpHashEntry> pseudoOps;
+    for (cxuint t = 0; t < ASMPOTBL_MAX; t++)
+    {
+        const AsmPseudoOpNamesTable& table = asmPseudoOpNamesTables[t];
+        for (size_t i = 0; i < table.namesNum; i++)
+        {
+            const char* name = table.names[i];
+            size_t k = 0;
+            while (k < pseudoOps.size() && ::strcmp(pseudoOps[k].name, name) != 0)
+                k++;
+            if (k == pseudoOps.size())
+            {
+                AsmPseudoOpHashEntry entry;
+                entry.name = name;
+                entry.hash = calculateFNV1aHash(name);
+                std::fill(entry.indices, entry.indices+ASMPOTBL_MAX, UINT16_MAX);
+                pseudoOps.push_back(entry);
+            }
+            pseudoOps[k].indices[t] = i;
+        }
+    }
+    
+    std::vector<uint32_t> hashes(pseudoOps.size());
+    for (size_t i = 0; i < pseudoOps.size(); i++)
+        hashes[i] = pseudoOps[i].hash;
+    std::vector<size_t> slots;
+    buildPerfectHash(hashes, pseudoOpHashBucketsNum, pseudoOpHashTableSize,
+                pseudoOpHashDisps, slots);
+    
+    AsmPseudoOpHashEntry emptyEntry;
+    emptyEntry.name = nullptr;
+    emptyEntry.hash = 0;
+    std::fill(emptyEntry.indices, emptyEntry.indices+ASMPOTBL_MAX, UINT16_MAX);
+    pseudoOpHashTable.assign(pseudoOpHashTableSize, emptyEntry);
+    for (uint32_t i = 0; i < pseudoOpHashTableSize; i++)
+        if (slots[i] != SIZE_MAX)
+            pseudoOpHashTable[i] = pseudoOps[slots[i]];
+}
+
+// create main instruction table for disassembler
+static void generateGCNInstrTableByCode()
+{
+    // except VOP3 decoding routines ignores encoding (we can set None for encoding)
+    instrTableByCode.assign(instrTableByCodeLength,
+                    GCNInstruction{ nullptr, GCNENC_NONE, GCN_STDMODE, 0, 0 });
+    
+    // fill up main instruction table
+    for (cxuint i = 0; gcnInstrsTable[i].mnemonic != nullptr; i++)
+    {
+        const GCNInstruction& instr = gcnInstrsTable[i];
+        const GCNEncodingSpace& encSpace = gcnInstrTableByCodeSpaces[instr.encoding];
+        if ((instr.archMask & ARCH_GCN_1_0_1) != 0)
+        {
+            if (instrTableByCode[encSpace.offset + instr.code].mnemonic == nullptr)
+                instrTableByCode[encSpace.offset + instr.code] = instr;
+            else if((instr.archMask & ARCH_RX2X0) != 0)
+            {
+                /* otherwise we for GCN1.1 */
+                const GCNEncodingSpace& encSpace2 =
+                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
+                instrTableByCode[encSpace2.offset + instr.code] = instr;
+            }
+            // otherwise we ignore this entry
+        }
+        if ((instr.archMask & ARCH_GCN_1_2_4) != 0)
+        {
+            // for GCN 1.2/1.4
+            const GCNEncodingSpace& encSpace3 = gcnInstrTableByCodeSpaces[
+                        GCNENC_MAXVAL+3+instr.encoding];
+            if (instrTableByCode[encSpace3.offset + instr.code].mnemonic == nullptr)
+                instrTableByCode[encSpace3.offset + instr.code] = instr;
+            else if((instr.archMask & ARCH_GCN_1_4) != 0 &&
+                (instr.encoding == GCNENC_VOP2 || instr.encoding == GCNENC_VOP1 ||
+                instr.encoding == GCNENC_VOP3A || instr.encoding == GCNENC_VOP3B))
+            {
+                /* otherwise we for GCN1.4 */
+                const bool encNoVOP2 = instr.encoding != GCNENC_VOP2;
+                const bool encVOP1 = instr.encoding == GCNENC_VOP1;
+                // choose FLAT_GLOBAL or FLAT_SCRATCH space
+                const GCNEncodingSpace& encSpace4 =
+                    gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 + encNoVOP2 + encVOP1];
+                instrTableByCode[encSpace4.offset + instr.code] = instr;
+            }
+            else if((instr.archMask & ARCH_GCN_1_4) != 0 &&
+                instr.encoding == GCNENC_FLAT && (instr.mode & GCN_FLAT_MODEMASK) != 0)
+            {
+                /* FLAT SCRATCH and GLOBAL instructions */
+                const cxuint encFlatMode = (instr.mode & GCN_FLAT_MODEMASK)-1;
+                const GCNEncodingSpace& encSpace4 =
+                    gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 + encFlatMode];
+                instrTableByCode[encSpace4.offset + instr.code] = instr;
+            }
+            // otherwise we ignore this entry
+        }
+    }
+}
+
+static void printMnemonic(FILE* file, const char* mnemonic)
+{
+    if (mnemonic != nullptr)
+        fprintf(file, "\"%s\"", mnemonic);
+    else
+        fputs("nullptr", file);
+}
+
+static bool writeGCNTables(const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (file == nullptr)
+        return false;
+    fputs("/* generated by GCNTablesGen from gcnInstrsTable - do not edit! */\n\n"
+        "#include <CLRX/Config.h>\n"
+        "#include \"amdasm/GCNInternals.h\"\n\n"
+        "using namespace CLRX;\n\n", file);
+    
+    fputs("const GCNAsmInstruction CLRX::gcnInstrSortedTable[] =\n{\n", file);
+    for (const GCNAsmInstruction& insn: sortedTable)
+    {
+        fputs("    { ", file);
+        printMnemonic(file, insn.mnemonic);
+        fprintf(file, ", %u, 0x%x, 0x%x, 0x%x, 0x%x },\n", cxuint(insn.encoding),
+                cxuint(insn.mode), cxuint(insn.code1), cxuint(insn.code2),
+                cxuint(insn.archMask));
+    }
+    fprintf(file, "};\n\nconst size_t CLRX::gcnInstrSortedTableSize = %u;\n\n",
+                cxuint(sortedTable.size()));
+    
+    fprintf(file, "const uint32_t CLRX::gcnMnemonicHashBucketsNum = %u;\n"
+            "const uint32_t CLRX::gcnMnemonicHashTableSize = %u;\n\n",
+            hashBucketsNum, hashTableSize);
+    fputs("const uint16_t CLRX::gcnMnemonicHashDisps[] =\n{", file);
+    for (size_t i = 0; i < hashDisps.size(); i++)
+        fprintf(file, "%s%u,", (i&15)==0 ? "\n    " : " ",
+                cxuint(hashDisps[i]));
+    fputs("\n};\n\n", file);
+    
+    fputs("const GCNMnemonicHashEntry CLRX::gcnMnemonicHashTable[] =\n{\n", file);
+    for (const GCNMnemonicHashEntry& entry: hashTable)
+    {
+        fprintf(file, "    { 0x%08x, %u, {", entry.hash, cxuint(entry.first));
+        for (cxuint arch = 0; arch <= cxuint(GPUArchitecture::GPUARCH_MAX); arch++)
+            fprintf(file, " %u,", cxuint(entry.archIndices[arch]));
+        fputs(" } },\n", file);
+    }
+    fputs("};\n\n", file);
+    
+    fputs("const GCNInstruction CLRX::gcnInstrTableByCode[] =\n{\n", file);
+    for (const GCNInstruction& insn: instrTableByCode)
+    {
+        fputs("    { ", file);
+        printMnemonic(file, insn.mnemonic);
+        fprintf(file, ", %u, 0x%x, 0x%x, 0x%x },\n", cxuint(insn.encoding),
+                cxuint(insn.mode), cxuint(insn.code), cxuint(insn.archMask));
+    }
+    fputs("};\n", file);
+    
+    const bool good = !ferror(file);
+    return (fclose(file) == 0) && good;
+}
+
+static bool writeAsmPseudoOpTables(const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (file == nullptr)
+        return false;
+    fputs("/* generated by GCNTablesGen from pseudo-op names - do not edit! */\n\n"
+        "#include <CLRX/Config.h>\n"
+        "#include \"amdasm/AsmInternals.h\"\n\n"
+        "using namespace CLRX;\n\n", file);
+    
+    fprintf(file, "const uint32_t CLRX::asmPseudoOpHashBucketsNum = %u;\n"
+            "const uint32_t CLRX::asmPseudoOpHashTableSize = %u;\n\n",
+            pseudoOpHashBucketsNum, pseudoOpHashTableSize);
+    fputs("const uint16_t CLRX::asmPseudoOpHashDisps[] =\n{", file);
+    for (size_t i = 0; i < pseudoOpHashDisps.size(); i++)
+        fprintf(file, "%s%u,", (i&15)==0 ? "\n    " : " ",
+                cxuint(pseudoOpHashDisps[i]));
+    fputs("\n};\n\n", file);
+    
+    fputs("const AsmPseudoOpHashEntry CLRX::asmPseudoOpHashTable[] =\n{\n", file);
+    for (const AsmPseudoOpHashEntry& entry: pseudoOpHashTable)
+    {
+        fputs("    { ", file);
+        printMnemonic(file, entry.name);
+        fprintf(file, ", 0x%08x, {", entry.hash);
+        for (cxuint t = 0; t < ASMPOTBL_MAX; t++)
+            fprintf(file, " %u,", cxuint(entry.indices[t]));
+        fputs(" } },\n", file);
+    }
+    fputs("};\n\n", file);
+    
+    fputs("const size_t CLRX::asmPseudoOpTablesSizes[ASMPOTBL_MAX] =\n{", file);
+    for (cxuint t = 0; t < ASMPOTBL_MAX; t++)
+        fprintf(file, " %u,", cxuint(asmPseudoOpNamesTables[t].namesNum));
+    fputs(" };\n", file);
+    
+    const bool good = !ferror(file);
+    return (fclose(file) == 0) && good;
+}
+
+int main(int argc, const char** argv)
+{
+    if (argc < 3)
+    {
+        fputs("Usage: GCNTablesGen GCNTABLESFILE PSEUDOOPTABLESFILE\n", stderr);
+        return 1;
+    }
+    generateGCNAsmSortedTable();
+    generateGCNMnemonicHash();
+    generateGCNInstrTableByCode();
+    generateAsmPseudoOpHash();
+    if (!writeGCNTables(argv[1]))
+    {
+        fprintf(stderr, "Can't write GCN tables to '%s'\n", argv[1]);
+        return 1;
+    }
+    if (!writeAsmPseudoOpTables(argv[2]))
+    {
+        fprintf(stderr, "Can't write pseudo-op tables to '%s'\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}
@@ -178,17 +178,18 @@ void AmdInput::addEmptyKernel(const char* kernelName)
     kernels.push_back(std::move(kernel));
 }
 
-AmdGPUBinGenerator::AmdGPUBinGenerator() : manageable(false), input(nullptr)
+AmdGPUBinGenerator::AmdGPUBinGenerator() : manageable(false), input(nullptr),
+        threadsNum(1)
 { }
 
 AmdGPUBinGenerator::AmdGPUBinGenerator(const AmdInput* amdInput)
-        : manageable(false), input(amdInput)
+        : manageable(false), input(amdInput), threadsNum(1)
 { }
 
 AmdGPUBinGenerator::AmdGPUBinGenerator(bool _64bitMode, GPUDeviceType deviceType,
        uint32_t driverVersion, size_t globalDataSize, const cxbyte* globalData,
        const std::vector<AmdKernelInput>& kernelInputs)
-        : manageable(true), input(nullptr)
+        : manageable(true), input(nullptr), threadsNum(1)
 {
     std::unique_ptr<AmdInput> _input(new AmdInput{});
     _input->is64Bit = _64bitMode;
@@ -205,7 +206,7 @@ AmdGPUBinGenerator::AmdGPUBinGenerator(bool _64bitMode, GPUDeviceType deviceType
 AmdGPUBinGenerator::AmdGPUBinGenerator(bool _64bitMode, GPUDeviceType deviceType,
        uint32_t driverVersion, size_t globalDataSize, const cxbyte* globalData,
        std::vector<AmdKernelInput>&& kernelInputs)
-        : manageable(true), input(nullptr)
+        : manageable(true), input(nullptr), threadsNum(1)
 {
     std::unique_ptr<AmdInput> _input(new AmdInput{});
     _input->is64Bit = _64bitMode;
@@ -393,7 +394,7 @@ public:
                     LEV(calNote.header.descSize), LEV(calNote.header.type) };
                 ::memcpy(cnHdr.name, &calNote.header.name, 8);
                 fob.writeObject(cnHdr);
-                fob.writeArray(calNote.header.descSize, calNote.data);
+                fob.writeExternalArray(calNote.header.descSize, calNote.data);
             }
     }
 };
@@ -410,7 +411,7 @@ public:
     void operator()(FastOutputBuffer& fob) const
     {
         if (kernel->data!=nullptr)
-            fob.writeArray(kernel->dataSize, kernel->data);
+            fob.writeExternalArray(kernel->dataSize, kernel->data);
         else
             fob.fill(4736, 0);
     }
@@ -419,6 +420,8 @@ public:
 struct CLRX_INTERNAL TempAmdKernelData
 {
     uint32_t innerBinSize;
+    size_t rodataSize;  // metadata and header size
+    GatherOStream innerOutput;  // gathered inner binary (refers to kernel code/data)
     std::string metadata;
     CALNoteGen calNoteGen;
     KernelDataGen kernelDataGen;
@@ -633,10 +636,11 @@ public:
     CL1MainTextGen(Array<TempAmdKernelData>& _tempDatas) : tempDatas(_tempDatas)
     { }
     
+    // inner binaries are already generated (in parallel)
     void operator()(FastOutputBuffer& fob) const
     {
-        for (TempAmdKernelData& kernel: tempDatas)
-            kernel.elfBinGen.generate(fob);
+        for (const TempAmdKernelData& kernel: tempDatas)
+            kernel.innerOutput.writeTo(fob);
     }
 };
 
@@ -1645,9 +1649,21 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
     cxuint uniqueId = 1024;
     std::vector<cxuint> uniqueIds = collectUniqueIdsAndFunctionIds(input);
     
-    uint64_t allInnerBinSize = 0;
-    size_t rodataSize = 0;
+    // unique ids depend on previous kernels, hence they are assigned before
+    Array<cxuint> kernelUniqueIds(kernelsNum);
     for (size_t i = 0; i < kernelsNum; i++)
+        if (input->kernels[i].useConfig)
+        {
+            // get new free uniqueId
+            while (std::binary_search(uniqueIds.begin(), uniqueIds.end(), uniqueId))
+                uniqueId++;
+            kernelUniqueIds[i] = uniqueId++;
+        }
+    
+    /* inner binaries are independent, so they are generated concurrently
+     * into separate gathering outputs. generated parts are held in buffers,
+     * kernel code and data are only referenced and written directly from input */
+    runParallelJobs(kernelsNum, threadsNum, [&](size_t i)
     {
         size_t calNotesSize = 0;
         size_t metadataSize = 0;
@@ -1656,10 +1672,6 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
         tempData.kernelDataGen = KernelDataGen(&kinput);
         if (kinput.useConfig)
         {
-            // get new free uniqueId
-            while (std::binary_search(uniqueIds.begin(), uniqueIds.end(), uniqueId))
-                uniqueId++;
-            
             const AmdKernelConfig& config = kinput.config;
             cxuint readOnlyImages = 0;
             cxuint writeOnlyImages = 0;
@@ -1704,7 +1716,7 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
             tempConfig.uavsNum = uavsNum;
             
             tempAmdKernelDatas[i].metadata = generateMetadata(driverVersion, input, kinput,
-                     tempConfig, argSamplersNum, uniqueId);
+                     tempConfig, argSamplersNum, kernelUniqueIds[i]);
             
             calNotesSize = uint64_t(20*17) /*calNoteHeaders*/ + 16 + 128 + (18+32 +
                 4*((isOlderThan1124)?16:config.userDatas.size()))*8 /* proginfo */ +
@@ -1722,8 +1734,6 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
             tempData.header[5] = LEV(1U);
             tempData.header[6] = 0U;
             tempData.header[7] = 0U;
-            
-            uniqueId++;
         }
         else
         {
@@ -1733,7 +1743,7 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
             metadataSize = kinput.metadataSize + kinput.headerSize;
         }
         
-        rodataSize += metadataSize;
+        tempData.rodataSize = metadataSize;
         /* kernel elf bin generator */
         ElfBinaryGen32& kelfBinGen = tempAmdKernelDatas[i].elfBinGen;
         
@@ -1784,11 +1794,25 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
         const uint64_t innerBinSize = kelfBinGen.countSize();
         if (innerBinSize > UINT32_MAX)
             throw BinGenException("Inner binary size is too big!");
-        allInnerBinSize += tempAmdKernelDatas[i].innerBinSize = innerBinSize;
+        tempAmdKernelDatas[i].innerBinSize = innerBinSize;
         
         tempAmdKernelDatas[i].calEncEntry =
             { LEV(uint32_t(gpuDeviceInnerCodeTable[cxuint(input->deviceType)])), LEV(4U), 
                 LEV(0x1c0U), LEV(uint32_t(tempAmdKernelDatas[i].innerBinSize - 0x1c0U)) };
+        
+        // generate inner binary
+        FastOutputBuffer innerFob(256, tempData.innerOutput);
+        kelfBinGen.generate(innerFob);
+        innerFob.flush();
+        assert(tempData.innerOutput.getSize() == innerBinSize);
+    });
+    
+    uint64_t allInnerBinSize = 0;
+    size_t rodataSize = 0;
+    for (const TempAmdKernelData& tempData: tempAmdKernelDatas)
+    {
+        allInnerBinSize += tempData.innerBinSize;
+        rodataSize += tempData.rodataSize;
     }
     if (input->globalData!=nullptr)
         rodataSize += input->globalDataSize;
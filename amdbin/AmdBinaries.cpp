@@ -616,13 +616,24 @@ AmdMainBinaryBase::AmdMainBinaryBase(AmdMainType _type) : type(_type)
 AmdMainBinaryBase::~AmdMainBinaryBase()
 { }
 
+void AmdMainBinaryBase::parseKernelInfo(size_t index)
+{ }
+
+void AmdMainBinaryBase::loadKernelInfo(size_t index) const
+{
+    // parseKernelInfo modifies kernel info only once, under once flag
+    AmdMainBinaryBase* thisPtr = const_cast<AmdMainBinaryBase*>(this);
+    callOnce(kernelInfoOnceFlags[index], [thisPtr, index]()
+            { thisPtr->parseKernelInfo(index); });
+}
+
 const KernelInfo& AmdMainBinaryBase::getKernelInfo(const char* name) const
 {
     KernelInfoMap::const_iterator it = binaryMapFind(
         kernelInfosMap.begin(), kernelInfosMap.end(), name);
     if (it == kernelInfosMap.end())
         throw BinException("Can't find kernel name");
-    return kernelInfos[it->second];
+    return getKernelInfo(it->second);
 }
 
 static const cxuint vectorIdTable[17] =
@@ -684,7 +695,7 @@ static inline CString stringFromCStringDelim(const char* c1, size_t maxSize, cha
 
 /* metadata string that stored in rodata section in main GPU binary holds needed kernel
  * argument info (arg type and arg name). this function just retrieve that data */
-static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
+static void parseAmdGpuKernelMetadata(size_t metadataSize,
           const char* kernelDesc, KernelInfo& kernelInfo)
 {
     // internal structure to hold kernel arguments info in map
@@ -1025,7 +1036,6 @@ static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
         kptr++; // skip newline
     }
     
-    kernelInfo.kernelName.assign(symName+9, ::strlen(symName)-18);
     kernelInfo.argInfos.resize(argIndex);
     
     for (const auto& e: initKernelArgs)
@@ -1110,9 +1120,28 @@ struct CLRX_INTERNAL AmdGPU64Types: Elf64Types
 };
 
 AmdMainGPUBinaryBase::AmdMainGPUBinaryBase(AmdMainType type)
-        : AmdMainBinaryBase(type), metadatas(nullptr), globalDataSize(0), globalData(0)
+        : AmdMainBinaryBase(type), innerBinaryFlags(0), metadatas(nullptr),
+          globalDataSize(0), globalData(0)
 { }
 
+void AmdMainGPUBinaryBase::parseKernelInfo(size_t index)
+{
+    KernelInfo kernelInfo;
+    parseAmdGpuKernelMetadata(metadatas[index].size, metadatas[index].data, kernelInfo);
+    kernelInfos[index].argInfos = std::move(kernelInfo.argInfos);
+}
+
+void AmdMainGPUBinaryBase::loadInnerBinary(size_t index) const
+{
+    AmdMainGPUBinaryBase* thisPtr = const_cast<AmdMainGPUBinaryBase*>(this);
+    callOnce(innerBinaryOnceFlags[index], [thisPtr, index]()
+    {
+        const AmdGPUInnerBinaryRegion& region = thisPtr->innerBinaryRegions[index];
+        thisPtr->innerBinaries[index] = AmdInnerGPUBinary32(region.kernelName,
+                    region.size, region.data, thisPtr->innerBinaryFlags);
+    });
+}
+
 template<typename Types>
 void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
 {
@@ -1131,6 +1160,7 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     const bool doKernelHeaders = (creationFlags & AMDBIN_CREATE_KERNELHEADERS) != 0;
     const bool doKernelInfo = (creationFlags & AMDBIN_CREATE_KERNELINFO) != 0;
     const bool doInfoStrings = (creationFlags & AMDBIN_CREATE_INFOSTRINGS) != 0;
+    const bool lazy = (creationFlags & AMDBIN_CREATE_LAZY) != 0;
     size_t compileOptionsEnd = 0;
     uint16_t compileOptionShIndex = SHN_UNDEF;
     
@@ -1206,12 +1236,19 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     }
     
     innerBinaries.resize(choosenSyms.size());
+    innerBinaryFlags = (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL;
     
     if (textIndex != SHN_UNDEF) /* if have ".text" */
     {
         const typename Types::Shdr& textHdr = mainElf.getSectionHeader(textIndex);
         cxbyte* textContent = mainElf.getBinaryCode() + ULEV(textHdr.sh_offset);
         
+        if (lazy)
+        {
+            // inner binaries will be parsed while first access
+            innerBinaryRegions.resize(choosenSyms.size());
+            innerBinaryOnceFlags.reset(new OnceFlag[choosenSyms.size()]);
+        }
         /* create table of innerBinaries */
         size_t ki = 0;
         for (auto it: choosenSyms)
@@ -1227,15 +1264,19 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
             if (usumGt(symvalue, symsize, ULEV(textHdr.sh_size)))
                 throw BinException("Inner binary offset+size out of range!");
             
-            innerBinaries[ki++] = AmdInnerGPUBinary32(CString(symName+9, len-16),
-                symsize, textContent+symvalue,
-                (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL);
+            if (lazy)
+                innerBinaryRegions[ki++] = { CString(symName+9, len-16),
+                            symsize, textContent+symvalue };
+            else
+                innerBinaries[ki++] = AmdInnerGPUBinary32(CString(symName+9, len-16),
+                            symsize, textContent+symvalue, innerBinaryFlags);
         }
         if ((creationFlags & AMDBIN_CREATE_INNERBINMAP) != 0)
         {
             innerBinaryMap.resize(innerBinaries.size());
             for (size_t i = 0; i < innerBinaries.size(); i++)
-                innerBinaryMap[i] = std::make_pair(innerBinaries[i].getKernelName(), i);
+                innerBinaryMap[i] = std::make_pair(lazy ? innerBinaryRegions[i].kernelName :
+                            innerBinaries[i].getKernelName(), i);
             mapSort(innerBinaryMap.begin(), innerBinaryMap.end());
         }
     }
@@ -1244,6 +1285,9 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     {
         kernelInfos.resize(choosenSymsMetadata.size());
         metadatas.reset(new AmdGPUKernelMetadata[kernelInfos.size()]);
+        if (lazy)
+            // kernel informations will be parsed while first access
+            kernelInfoOnceFlags.reset(new OnceFlag[kernelInfos.size()]);
         
         typename Types::Size ki = 0;
         for (typename Types::Size it: choosenSymsMetadata)
@@ -1265,10 +1309,13 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
             if (usumGt(symvalue, symsize, ULEV(rodataHdr.sh_size)))
                 throw BinException("Metadata offset+size out of range");
             
+            // kernel name preceded by '__OpenCL_' and precedes '_metadata'
+            kernelInfos[ki].kernelName.assign(symName+9, ::strlen(symName)-18);
             // parse AMDGPU kernel metadata
-            parseAmdGpuKernelMetadata(symName, symsize,
-                  reinterpret_cast<const char*>(secContent + symvalue),
-                  kernelInfos[ki]);
+            if (!lazy)
+                parseAmdGpuKernelMetadata(symsize,
+                      reinterpret_cast<const char*>(secContent + symvalue),
+                      kernelInfos[ki]);
             metadatas[ki].size = symsize;
             metadatas[ki].data = reinterpret_cast<char*>(secContent + symvalue);
             ki++;
@@ -1330,7 +1377,7 @@ const AmdInnerGPUBinary32& AmdMainGPUBinaryBase::getInnerBinary(const char* name
                   innerBinaryMap.end(), name);
     if (it == innerBinaryMap.end())
         throw BinException("Can't find inner binary");
-    return innerBinaries[it->second];
+    return getInnerBinary(it->second);
 }
 
 const AmdGPUKernelHeader& AmdMainGPUBinaryBase::getKernelHeaderEntry(
@@ -197,8 +197,11 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
                 dynamicTableHdr = &shdr;
         }
         // sort section's map (really is array of sections)
-        if ((creationFlags & ELF_CREATE_SECTIONMAP) != 0)
+        if ((creationFlags & (ELF_CREATE_SECTIONMAP|ELF_CREATE_HASHINDEX)) ==
+                    ELF_CREATE_SECTIONMAP)
             mapSort(sectionIndexMap.begin(), sectionIndexMap.end(), CStringLess());
+        else if ((creationFlags & ELF_CREATE_SECTIONMAP) != 0)
+            buildHashIndex(sectionIndexMap, sectionHashIndex);
         
         if (symTableHdr != nullptr)
         {
@@ -238,8 +241,11 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
                     symbolIndexMap[i] = std::make_pair(symname, i);
             }
             // sort symbol's map (really is array of symbols)
-            if ((creationFlags & ELF_CREATE_SYMBOLMAP) != 0)
+            if ((creationFlags & (ELF_CREATE_SYMBOLMAP|ELF_CREATE_HASHINDEX)) ==
+                        ELF_CREATE_SYMBOLMAP)
                 mapSort(symbolIndexMap.begin(), symbolIndexMap.end(), CStringLess());
+            else if ((creationFlags & ELF_CREATE_SYMBOLMAP) != 0)
+                buildHashIndex(symbolIndexMap, symbolHashIndex);
         }
         if (dynSymTableHdr != nullptr)
         {
@@ -281,8 +287,11 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
                     dynSymIndexMap[i] = std::make_pair(symname, i);
             }
             // sort dynamic symbol's map (really is array of dynamic symbols)
-            if ((creationFlags & ELF_CREATE_DYNSYMMAP) != 0)
+            if ((creationFlags & (ELF_CREATE_DYNSYMMAP|ELF_CREATE_HASHINDEX)) ==
+                        ELF_CREATE_DYNSYMMAP)
                 mapSort(dynSymIndexMap.begin(), dynSymIndexMap.end(), CStringLess());
+            else if ((creationFlags & ELF_CREATE_DYNSYMMAP) != 0)
+                buildHashIndex(dynSymIndexMap, dynSymHashIndex);
         }
         if (noteTableHdr != nullptr)
         {
@@ -304,14 +313,55 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
     }
 }
 
+/* hash index is open-addressing table (linear probing) that holds positions in
+ * index map (plus one, zero is empty slot), names are hashed by FNV-1a.
+ * Only first of equal names is indexed.
+ * If hash index is enabled then index maps are not sorted (they are in original order) */
+template<typename Types>
+void ElfBinaryTemplate<Types>::buildHashIndex(const SectionIndexMap& indexMap,
+            Array<size_t>& hashIndex)
+{
+    if (indexMap.empty())
+        return;
+    // load factor is not greater than 0.5
+    size_t hashSize = 2;
+    while (hashSize < (indexMap.size()<<1))
+        hashSize <<= 1;
+    hashIndex.resize(hashSize);
+    std::fill(hashIndex.begin(), hashIndex.end(), size_t(0));
+    for (size_t i = 0; i < indexMap.size(); i++)
+    {
+        size_t slot = calculateFNV1aHash(indexMap[i].first) & (hashSize-1);
+        while (hashIndex[slot] != 0 &&
+            ::strcmp(indexMap[hashIndex[slot]-1].first, indexMap[i].first) != 0)
+            slot = (slot+1) & (hashSize-1);
+        if (hashIndex[slot] == 0)
+            hashIndex[slot] = i+1;
+    }
+}
+
+template<typename Types>
+typename ElfBinaryTemplate<Types>::SectionIndexMap::const_iterator
+ElfBinaryTemplate<Types>::findInHashIndex(const SectionIndexMap& indexMap,
+            const Array<size_t>& hashIndex, const char* name)
+{
+    if (hashIndex.empty())
+        return indexMap.end();
+    const size_t hashMask = hashIndex.size()-1;
+    for (size_t slot = calculateFNV1aHash(name) & hashMask; hashIndex[slot] != 0;
+                slot = (slot+1) & hashMask)
+        if (::strcmp(indexMap[hashIndex[slot]-1].first, name) == 0)
+            return indexMap.begin() + hashIndex[slot]-1;
+    return indexMap.end();
+}
+
 template<typename Types>
 uint16_t ElfBinaryTemplate<Types>::getSectionIndex(const char* name) const
 {
     if (hasSectionMap())
     {
         // find in section map (sorted array)
-        SectionIndexMap::const_iterator it = binaryMapFind(
-                    sectionIndexMap.begin(), sectionIndexMap.end(), name, CStringLess());
+        SectionIndexMap::const_iterator it = findInIndexMap(sectionIndexMap, sectionHashIndex, name);
         if (it == sectionIndexMap.end())
             throw BinException(std::string("Can't find Elf")+Types::bitName+" Section");
         return it->second;
@@ -331,8 +381,7 @@ uint16_t ElfBinaryTemplate<Types>::getSectionIndex(const char* name) const
 template<typename Types>
 typename Types::Size ElfBinaryTemplate<Types>::getSymbolIndex(const char* name) const
 {
-    SymbolIndexMap::const_iterator it = binaryMapFind(
-                    symbolIndexMap.begin(), symbolIndexMap.end(), name, CStringLess());
+    SymbolIndexMap::const_iterator it = findInIndexMap(symbolIndexMap, symbolHashIndex, name);
     if (it == symbolIndexMap.end())
         throw BinException(std::string("Can't find Elf")+Types::bitName+" Symbol");
     return it->second;
@@ -341,8 +390,7 @@ typename Types::Size ElfBinaryTemplate<Types>::getSymbolIndex(const char* name)
 template<typename Types>
 typename Types::Size ElfBinaryTemplate<Types>::getDynSymbolIndex(const char* name) const
 {
-    SymbolIndexMap::const_iterator it = binaryMapFind(
-                    dynSymIndexMap.begin(), dynSymIndexMap.end(), name, CStringLess());
+    SymbolIndexMap::const_iterator it = findInIndexMap(dynSymIndexMap, dynSymHashIndex, name);
     if (it == dynSymIndexMap.end())
         throw BinException(std::string("Can't find Elf")+Types::bitName+" DynSymbol");
     return it->second;
@@ -458,7 +506,8 @@ template<typename Types>
 ElfBinaryGenTemplate<Types>::ElfBinaryGenTemplate()
         : sizeComputed(false), addNullSym(true), addNullDynSym(true), addNullSection(true),
           addrStartRegion(0), shStrTab(0), strTab(0), dynStr(0), shdrTabRegion(0),
-          phdrTabRegion(0), bucketsNum(0), isHashDynSym(false)
+          phdrTabRegion(0), bucketsNum(0), isHashDynSym(false),
+          strTabSize(0), dynStrSize(0), shStrTabSize(0), symLastLocal(0), dynSymLastLocal(0)
 { }
 
 template<typename Types>
@@ -468,7 +517,8 @@ ElfBinaryGenTemplate<Types>::ElfBinaryGenTemplate(const ElfHeaderTemplate<Types>
         : sizeComputed(false), addNullSym(_addNullSym), addNullDynSym(_addNullDynSym),
           addNullSection(_addNullSection),  addrStartRegion(addrCountingFromRegion),
           shStrTab(0), strTab(0), dynStr(0), shdrTabRegion(0), phdrTabRegion(0),
-          header(_header), bucketsNum(0), isHashDynSym(false)
+          header(_header), bucketsNum(0), isHashDynSym(false),
+          strTabSize(0), dynStrSize(0), shStrTabSize(0), symLastLocal(0), dynSymLastLocal(0)
 { }
 
 template<typename Types>
@@ -500,6 +550,48 @@ static inline typename Types::Word resolveSectionAddress(
         return 0;
 }
 
+// compute sizes of symbol names (with null character), size of string table
+// and number of symbols to last local symbol
+template<typename Types>
+static std::unique_ptr<uint32_t[]> computeSymNameSizes(
+            const std::vector<ElfSymbolTemplate<Types> >& symbols,
+            bool addNullSym, uint64_t& tableSize, cxuint& lastLocal)
+{
+    std::unique_ptr<uint32_t[]> nameSizes(new uint32_t[symbols.size()]);
+    tableSize = addNullSym;
+    lastLocal = 0;
+    for (size_t i = 0; i < symbols.size(); i++)
+    {
+        const ElfSymbolTemplate<Types>& sym = symbols[i];
+        nameSizes[i] = (sym.name != nullptr && sym.name[0] != 0) ?
+                    ::strlen(sym.name)+1 : 0;
+        tableSize += nameSizes[i];
+        if (ELF32_ST_BIND(sym.info)==STB_LOCAL)
+            lastLocal = i+1;
+    }
+    if (addNullSym)
+        lastLocal++;
+    return nameSizes;
+}
+
+template<typename Types>
+void ElfBinaryGenTemplate<Types>::computeStrTabLayout()
+{
+    symNameSizes = computeSymNameSizes(symbols, addNullSym, strTabSize, symLastLocal);
+    dynSymNameSizes = computeSymNameSizes(dynSymbols, addNullDynSym, dynStrSize,
+                dynSymLastLocal);
+    sectionNameSizes.reset(new uint32_t[regions.size()]);
+    shStrTabSize = addNullSection;
+    for (size_t i = 0; i < regions.size(); i++)
+    {
+        const ElfRegionTemplate<Types>& region = regions[i];
+        sectionNameSizes[i] = (region.type == ElfRegionType::SECTION &&
+                region.section.name != nullptr && region.section.name[0] != 0) ?
+                ::strlen(region.section.name)+1 : 0;
+        shStrTabSize += sectionNameSizes[i];
+    }
+}
+
 template<typename Types>
 void ElfBinaryGenTemplate<Types>::computeSize()
 {
@@ -511,6 +603,7 @@ void ElfBinaryGenTemplate<Types>::computeSize()
     
     regionOffsets.reset(new typename Types::Word[regions.size()]);
     regionAddresses.reset(new typename Types::Word[regions.size()]);
+    computeStrTabLayout();
     size = sizeof(typename Types::Ehdr);
     sectionsNum = addNullSection; // if add null section
     cxuint hashSymSectionIdx = UINT_MAX;
@@ -714,30 +807,11 @@ void ElfBinaryGenTemplate<Types>::computeSize()
                 else if (region.section.type == SHT_STRTAB)
                 {
                     if (::strcmp(region.section.name, ".strtab") == 0)
-                    {
-                        size += (addNullSym);
-                        for (const auto& sym: symbols)
-                            if (sym.name != nullptr && sym.name[0] != 0)
-                                size += ::strlen(sym.name)+1;
-                    }
+                        size += strTabSize;
                     else if (::strcmp(region.section.name, ".dynstr") == 0)
-                    {
-                        size += (addNullDynSym);
-                        for (const auto& sym: dynSymbols)
-                            if (sym.name != nullptr && sym.name[0] != 0)
-                                size += ::strlen(sym.name)+1;
-                    }
+                        size += dynStrSize;
                     else if (::strcmp(region.section.name, ".shstrtab") == 0)
-                    {
-                        size += (addNullSection);
-                        for (const auto& region2: regions)
-                        {
-                            if (region2.type == ElfRegionType::SECTION &&
-                                region2.section.name != nullptr &&
-                                region2.section.name[0] != 0)
-                                size += ::strlen(region2.section.name)+1;
-                        }
-                    }
+                        size += shStrTabSize;
                 }
                 if (region.section.type != SHT_NOBITS)
                     region.size = size-regionOffsets[i];
@@ -1021,7 +1095,7 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
                 if (region2.type == ElfRegionType::SECTION)
                 {
                     typename Types::Shdr shdr;
-                    if (region2.section.name!=nullptr && region2.section.name[0]!=0)
+                    if (sectionNameSizes[j] != 0)
                         SLEV(shdr.sh_name, nameOffset);
                     else // set empty name offset
                         SLEV(shdr.sh_name, nullSectionNameOffset);
@@ -1044,19 +1118,9 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
                         // put set info
                         SLEV(shdr.sh_info, region2.section.info);
                     else // if symbtabs
-                    {
                         // otherwise if default for symtabs, put count of last local
-                        const auto& symbolsList = (region2.section.type == SHT_SYMTAB) ?
-                            symbols : dynSymbols;
-                        cxuint lastLocal = 0;
-                        for (size_t l = 0; l < symbolsList.size(); l++)
-                            if (ELF32_ST_BIND(symbolsList[l].info)==STB_LOCAL)
-                                lastLocal = l+1;
-                        if ((region2.section.type==SHT_SYMTAB && addNullSym) ||
-                            (region2.section.type==SHT_DYNSYM && addNullDynSym))
-                            lastLocal++;
-                        SLEV(shdr.sh_info, lastLocal);
-                    }
+                        SLEV(shdr.sh_info, (region2.section.type == SHT_SYMTAB) ?
+                                symLastLocal : dynSymLastLocal);
                     
                     SLEV(shdr.sh_addralign, (region2.section.align==0) ?
                             region2.align : region2.section.align);
@@ -1081,8 +1145,7 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
                         SLEV(shdr.sh_entsize, sizeof(typename Types::Dyn));
                     else // if not default
                         SLEV(shdr.sh_entsize, region2.section.entSize);
-                    if (region2.section.name!=nullptr && region2.section.name[0]!=0)
-                        nameOffset += ::strlen(region2.section.name)+1;
+                    nameOffset += sectionNameSizes[j];
                     fob.writeObject(shdr);
                 }
             }
@@ -1090,7 +1153,7 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
         else if (region.type == ElfRegionType::USER)
         {
             if (region.dataFromPointer)
-                fob.writeArray(region.size, region.data);
+                fob.writeExternalArray(region.size, region.data);
             else
                 (*region.dataGen)(fob);
         }
@@ -1114,10 +1177,13 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
                     }
                     const auto& symbolsList = (region.section.type == SHT_SYMTAB) ?
                             symbols : dynSymbols;
-                    for (const auto& inSym: symbolsList)
+                    const uint32_t* nameSizes = (region.section.type == SHT_SYMTAB) ?
+                            symNameSizes.get() : dynSymNameSizes.get();
+                    for (size_t k = 0; k < symbolsList.size(); k++)
                     {
+                        const auto& inSym = symbolsList[k];
                         typename Types::Sym sym;
-                        if (inSym.name != nullptr && inSym.name[0] != 0)
+                        if (nameSizes[k] != 0)
                             SLEV(sym.st_name, nameOffset);
                         else  // set empty name offset (symbol or dynamic symbol)
                             SLEV(sym.st_name, (region.section.type == SHT_SYMTAB) ?
@@ -1147,8 +1213,7 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
                                 (header.vaddrBase!=Types::nobase ? header.vaddrBase : 0));
                         sym.st_other = inSym.other;
                         sym.st_info = inSym.info;
-                        if (inSym.name != nullptr && inSym.name[0] != 0)
-                            nameOffset += ::strlen(inSym.name)+1;
+                        nameOffset += nameSizes[k];
                         fob.writeObject(sym);
                     }
                 }
@@ -1205,35 +1270,32 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
                     {
                         if (addNullSym)
                             fob.put(0);
-                        for (const auto& sym: symbols)
-                            if (sym.name != nullptr && sym.name[0] != 0)
-                                fob.write(::strlen(sym.name)+1, sym.name);
+                        for (size_t k = 0; k < symbols.size(); k++)
+                            if (symNameSizes[k] != 0)
+                                fob.write(symNameSizes[k], symbols[k].name);
                     }
                     else if (::strcmp(region.section.name, ".dynstr") == 0)
                     {
                         if (addNullDynSym)
                             fob.put(0);
-                        for (const auto& sym: dynSymbols)
-                            if (sym.name != nullptr && sym.name[0] != 0)
-                                fob.write(::strlen(sym.name)+1, sym.name);
+                        for (size_t k = 0; k < dynSymbols.size(); k++)
+                            if (dynSymNameSizes[k] != 0)
+                                fob.write(dynSymNameSizes[k], dynSymbols[k].name);
                     }
                     else if (::strcmp(region.section.name, ".shstrtab") == 0)
                     {
                         if (addNullSection)
                             fob.put(0);
-                        for (const auto& region2: regions)
-                            if (region2.type == ElfRegionType::SECTION &&
-                                region2.section.name != nullptr &&
-                                region2.section.name[0] != 0)
-                                fob.write(::strlen(region2.section.name)+1,
-                                          region2.section.name);
+                        for (size_t k = 0; k < regions.size(); k++)
+                            if (sectionNameSizes[k] != 0)
+                                fob.write(sectionNameSizes[k], regions[k].section.name);
                     }
                 }
             }
             else if (region.section.type != SHT_NOBITS)
             {
                 if (region.dataFromPointer)
-                    fob.writeArray(region.size, region.data);
+                    fob.writeExternalArray(region.size, region.data);
                 else
                     (*region.dataGen)(fob);
             }
@@ -0,0 +1,423 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#ifdef HAVE_LINUX
+#include <unistd.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/amdasm/Assembler.h>
+
+using namespace CLRX;
+
+/* benchmark: measures throughput of the assembler (assemble and writeBinary) for
+ * synthetic GCN sources: long straight-line kernel, macro-heavy code,
+ * '.rept'/'.irp'-heavy code, many small kernels and directive-dense kernels
+ * (big configurations and data directives). For every binary format and
+ * GPU architecture prints source lines per second, emitted bytes per second
+ * and peak memory (increase of resident memory while assembling) */
+
+enum class Workload
+{
+    STRAIGHT = 0,
+    MACRO,
+    REPT,
+    KERNELS,
+    DIRECTIVES
+};
+
+static const cxuint workloadsNum = 5;
+
+static const char* workloadNames[workloadsNum] =
+{ "straight", "macro", "rept", "kernels", "directives" };
+
+static const BinaryFormat benchFormats[5] =
+{
+    BinaryFormat::RAWCODE, BinaryFormat::AMD, BinaryFormat::AMDCL2,
+    BinaryFormat::GALLIUM, BinaryFormat::ROCM
+};
+
+static const char* formatNames[5] = { "AMD", "Gallium", "RawCode", "AMDCL2", "ROCm" };
+
+// one device for every GPU architecture
+static const GPUDeviceType benchDevices[5] =
+{
+    GPUDeviceType::CAPE_VERDE, GPUDeviceType::BONAIRE, GPUDeviceType::TONGA,
+    GPUDeviceType::GFX900, GPUDeviceType::GFX906
+};
+
+// instructions in kernel for many-kernel workload
+static const size_t kernelInstrsNum = 1024;
+// source lines per kernel for directive-dense workload
+static const size_t directiveKernelLines = 256;
+
+// kernel configuration directives (common for all formats)
+static const char* configDirectives =
+        "        .dims xy\n"
+        "        .sgprsnum 16\n"
+        "        .vgprsnum 24\n"
+        "        .localsize 1024\n"
+        "        .floatmode 0xc0\n"
+        "        .ieeemode\n"
+        "        .exceptions 0\n"
+        "        .tgsize\n";
+// data directives for directive-dense kernel code
+static const char* dataDirectives =
+        "    .int 1, 2, 3, 4\n"
+        "    .byte 5, 6\n"
+        "    .short 7\n"
+        "    .p2align 2\n"
+        "    .fill 2, 4, 0\n"
+        "    .long 8\n"
+        "    .quad 9\n"
+        "    .hword 10, 11\n";
+
+// get resident memory size in kilobytes (0 if not available)
+static size_t getResidentMemory()
+{
+#ifdef HAVE_LINUX
+    FILE* file = fopen("/proc/self/statm", "rb");
+    if (file == nullptr)
+        return 0;
+    unsigned long totalPages = 0, residentPages = 0;
+    if (fscanf(file, "%lu %lu", &totalPages, &residentPages) != 2)
+        residentPages = 0;
+    fclose(file);
+    return residentPages * (sysconf(_SC_PAGESIZE) >> 10);
+#else
+    return 0;
+#endif
+}
+
+// reset peak resident memory (VmHWM), returns false if not possible
+static bool resetPeakMemory()
+{
+#ifdef __GLIBC__
+    // release freed memory to system, otherwise next run reuses it
+    malloc_trim(0);
+#endif
+#ifdef HAVE_LINUX
+    FILE* file = fopen("/proc/self/clear_refs", "wb");
+    if (file == nullptr)
+        return false;
+    const bool done = fputs("5", file) >= 0;
+    fclose(file);
+    return done;
+#else
+    return false;
+#endif
+}
+
+// get peak resident memory (VmHWM) in kilobytes (0 if not available)
+static size_t getPeakMemory()
+{
+#ifdef HAVE_LINUX
+    FILE* file = fopen("/proc/self/status", "rb");
+    if (file == nullptr)
+        return 0;
+    char line[128];
+    unsigned long peak = 0;
+    while (fgets(line, 128, file) != nullptr)
+        if (::strncmp(line, "VmHWM:", 6) == 0)
+        {
+            peak = strtoul(line+6, nullptr, 10);
+            break;
+        }
+    fclose(file);
+    return peak;
+#else
+    return 0;
+#endif
+}
+
+// put instruction from mix (every instruction is valid for all GCN architectures)
+static void putInstr(std::string& out, size_t i)
+{
+    char buf[80];
+    const cxuint s0 = (i*7)%48, s1 = (i*11+3)%48;
+    const cxuint v0 = (i*5)%64, v1 = (i*13+1)%64, v2 = (i*3+7)%64;
+    switch (i&7)
+    {
+        case 0:
+            snprintf(buf, 80, "    s_mov_b32 s%u, s%u\n", s0, s1);
+            break;
+        case 1:
+            snprintf(buf, 80, "    s_add_u32 s%u, s%u, 0x%x\n", s0, s1,
+                     cxuint(i*0x9e3779b1U));
+            break;
+        case 2:
+            snprintf(buf, 80, "    v_mov_b32 v%u, v%u\n", v0, v1);
+            break;
+        case 3:
+            snprintf(buf, 80, "    v_add_f32 v%u, v%u, v%u\n", v0, v1, v2);
+            break;
+        case 4:
+            snprintf(buf, 80, "    v_mul_f32 v%u, 1.0, v%u\n", v0, v1);
+            break;
+        case 5:
+            snprintf(buf, 80, "    s_and_b32 s%u, s%u, s7\n", s0, s1);
+            break;
+        case 6:
+            snprintf(buf, 80, "    v_xor_b32 v%u, v%u, v%u\n", v0, v1, v2);
+            break;
+        default:
+            snprintf(buf, 80, "    s_waitcnt lgkmcnt(0)\n");
+            break;
+    }
+    out += buf;
+}
+
+// put kernel configuration (configRepeats - how many times put config directives)
+static void putKernelConfig(std::string& out, cxuint configRepeats)
+{
+    out += "    .config\n";
+    if (configRepeats == 0)
+        out += "        .dims x\n";
+    for (cxuint i = 0; i < configRepeats; i++)
+        out += configDirectives;
+}
+
+// put kernel declarations (Gallium and ROCm keeps kernel configurations before code)
+static void putKernelsHeader(std::string& out, BinaryFormat format, size_t kernelsNum,
+            cxuint configRepeats = 0)
+{
+    if (format != BinaryFormat::GALLIUM && format != BinaryFormat::ROCM)
+        return;
+    char buf[40];
+    for (size_t k = 0; k < kernelsNum; k++)
+    {
+        snprintf(buf, 40, ".kernel k%u\n", cxuint(k));
+        out += buf;
+        putKernelConfig(out, configRepeats);
+    }
+    out += ".text\n";
+}
+
+// put start of kernel code
+static void putKernelStart(std::string& out, BinaryFormat format, size_t kernelId,
+            cxuint configRepeats = 0)
+{
+    char buf[40];
+    switch (format)
+    {
+        case BinaryFormat::AMD:
+        case BinaryFormat::AMDCL2:
+            snprintf(buf, 40, ".kernel k%u\n", cxuint(kernelId));
+            out += buf;
+            putKernelConfig(out, configRepeats);
+            out += "    .text\n";
+            break;
+        case BinaryFormat::GALLIUM:
+        case BinaryFormat::ROCM:
+            // kernel label and space for kernel configuration
+            snprintf(buf, 40, "k%u:\n    .skip 256\n", cxuint(kernelId));
+            out += buf;
+            break;
+        default:
+            break;
+    }
+}
+
+// generate source for workload (returns empty string if workload is not applicable)
+static std::string generateSource(Workload workload, BinaryFormat format,
+                size_t instrsNum)
+{
+    std::string out;
+    if (format == BinaryFormat::AMDCL2)
+        out += ".driver_version 234000\n";
+    switch (workload)
+    {
+        case Workload::STRAIGHT:
+            putKernelsHeader(out, format, 1);
+            putKernelStart(out, format, 0);
+            for (size_t i = 0; i < instrsNum; i++)
+                putInstr(out, i);
+            out += "    s_endpgm\n";
+            break;
+        case Workload::MACRO:
+        {
+            // macro with 8 instructions, called for every 8 instructions
+            out += ".macro op8 sa, sb, va, vb\n"
+                "    s_mov_b32 s\\sa, s\\sb\n"
+                "    s_add_u32 s\\sa, s\\sb, 0x1234\n"
+                "    v_mov_b32 v\\va, v\\vb\n"
+                "    v_add_f32 v\\va, v\\vb, v\\va\n"
+                "    v_mul_f32 v\\va, 1.0, v\\vb\n"
+                "    s_and_b32 s\\sa, s\\sb, s7\n"
+                "    v_xor_b32 v\\va, v\\vb, v\\va\n"
+                "    s_waitcnt lgkmcnt(0)\n"
+                ".endm\n";
+            putKernelsHeader(out, format, 1);
+            putKernelStart(out, format, 0);
+            char buf[60];
+            for (size_t i = 0; i < instrsNum; i += 8)
+            {
+                snprintf(buf, 60, "    op8 %u, %u, %u, %u\n", cxuint((i*7)%48),
+                        cxuint((i*11+3)%48), cxuint((i*5)%64), cxuint((i*13+1)%64));
+                out += buf;
+            }
+            out += "    s_endpgm\n";
+            break;
+        }
+        case Workload::REPT:
+        {
+            // every block: '.rept' with 512 instructions and '.irp' with 8 instructions
+            putKernelsHeader(out, format, 1);
+            putKernelStart(out, format, 0);
+            for (size_t i = 0; i < instrsNum; i += 520)
+            {
+                out += "    .rept 64\n";
+                for (size_t j = 0; j < 8; j++)
+                    putInstr(out, i+j);
+                out += "    .endr\n"
+                    "    .irp r, 1, 2, 3, 4, 5, 6, 7, 8\n"
+                    "    v_add_f32 v\\r, v\\r, v0\n"
+                    "    .endr\n";
+            }
+            out += "    s_endpgm\n";
+            break;
+        }
+        case Workload::KERNELS:
+        {
+            if (format == BinaryFormat::RAWCODE)
+                return "";
+            const size_t kernelsNum = (instrsNum + kernelInstrsNum-1) / kernelInstrsNum;
+            putKernelsHeader(out, format, kernelsNum);
+            for (size_t k = 0; k < kernelsNum; k++)
+            {
+                putKernelStart(out, format, k);
+                for (size_t i = 0; i < kernelInstrsNum; i++)
+                    putInstr(out, k*kernelInstrsNum + i);
+                out += "    s_endpgm\n";
+            }
+            break;
+        }
+        case Workload::DIRECTIVES:
+        {
+            if (format == BinaryFormat::RAWCODE)
+                return "";
+            // every kernel: 128 configuration directives and 128 data directives
+            const size_t kernelsNum = (instrsNum + directiveKernelLines-1) /
+                        directiveKernelLines;
+            putKernelsHeader(out, format, kernelsNum, 16);
+            for (size_t k = 0; k < kernelsNum; k++)
+            {
+                putKernelStart(out, format, k, 16);
+                out += "    s_endpgm\n";
+                for (size_t i = 0; i < 16; i++)
+                    out += dataDirectives;
+            }
+            break;
+        }
+    }
+    return out;
+}
+
+static void runBenchmark(Workload workload, BinaryFormat format,
+            GPUDeviceType deviceType, size_t instrsNum)
+{
+    const std::string source = generateSource(workload, format, instrsNum);
+    if (source.empty())
+        return;
+    size_t linesNum = 0;
+    for (char c: source)
+        if (c == '\n')
+            linesNum++;
+
+    printf("%-8s %-7s %-8s ", workloadNames[cxuint(workload)],
+            formatNames[cxuint(format)],
+            getGPUArchitectureName(getGPUArchitectureFromDeviceType(deviceType)));
+    fflush(stdout);
+
+    std::istringstream input(source);
+    std::ostringstream msgStream;
+    Array<cxbyte> output;
+    const bool havePeak = resetPeakMemory();
+    const size_t rssBefore = getResidentMemory();
+    auto t0 = std::chrono::steady_clock::now();
+    bool good = false;
+    try
+    {
+        Assembler assembler("", input, 0, format, deviceType, msgStream, msgStream);
+        good = assembler.assemble();
+        if (good)
+            assembler.writeBinary(output);
+    }
+    catch(const std::exception& ex)
+    {
+        msgStream << ex.what() << "\n";
+        good = false;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    const size_t peakMem = havePeak ? getPeakMemory() : 0;
+    if (!good)
+    {
+        // print first line of error messages
+        std::string msg = msgStream.str();
+        msg = msg.substr(0, msg.find('\n'));
+        printf("skipped: %s\n", msg.c_str());
+        return;
+    }
+    const double time = std::chrono::duration<double>(t1-t0).count();
+    printf("%9.3f ms %10.0f lines/s %8.3f MB/s %8u kB\n", time*1000.0,
+            linesNum / time, output.size() / time / 1048576.0,
+            cxuint(peakMem > rssBefore ? peakMem - rssBefore : 0));
+}
+
+int main(int argc, const char** argv)
+{
+    size_t instrsNum = 1000000;
+    if (argc >= 2)
+        instrsNum = strtoul(argv[1], nullptr, 10);
+    if (instrsNum == 0)
+        instrsNum = 1;
+    // optional workload name
+    cxuint workloadsMask = (1U<<workloadsNum)-1;
+    if (argc >= 3)
+    {
+        workloadsMask = 0;
+        for (cxuint w = 0; w < workloadsNum; w++)
+            if (::strcmp(argv[2], workloadNames[w]) == 0)
+                workloadsMask = 1U<<w;
+        if (workloadsMask == 0)
+        {
+            std::cerr << "Unknown workload: " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+
+    printf("Instructions: %u\n", cxuint(instrsNum));
+    for (cxuint w = 0; w < workloadsNum; w++)
+        if ((workloadsMask & (1U<<w)) != 0)
+            for (BinaryFormat format: benchFormats)
+                for (GPUDeviceType deviceType: benchDevices)
+                    runBenchmark(Workload(w), format, deviceType, instrsNum);
+    return 0;
+}
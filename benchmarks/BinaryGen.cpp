@@ -0,0 +1,167 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/amdasm/Assembler.h>
+
+using namespace CLRX;
+
+/* benchmark: measures binary generation (writeBinary) for sources with many kernels
+ * and many symbols (symbols are added to binaries). Source is assembled once,
+ * next binary is generated few times. For AMD and AMDCL2 whole binary layout
+ * is computed while generating, for ROCm and Gallium layout is prepared once
+ * while assembling */
+
+struct BenchFormat
+{
+    const char* name;
+    BinaryFormat format;
+    GPUDeviceType deviceType;
+};
+
+static const BenchFormat benchFormats[4] =
+{
+    { "AMD", BinaryFormat::AMD, GPUDeviceType::BONAIRE },
+    { "AMDCL2", BinaryFormat::AMDCL2, GPUDeviceType::TONGA },
+    { "Gallium", BinaryFormat::GALLIUM, GPUDeviceType::BONAIRE },
+    { "ROCm", BinaryFormat::ROCM, GPUDeviceType::GFX900 }
+};
+
+// global labels (symbols) in every kernel
+static const size_t kernelLabelsNum = 32;
+
+static std::string generateSource(BinaryFormat format, size_t kernelsNum)
+{
+    std::string out;
+    char buf[80];
+    if (format == BinaryFormat::AMDCL2)
+        out += ".driver_version 234000\n";
+    if (format == BinaryFormat::GALLIUM || format == BinaryFormat::ROCM)
+    {
+        // kernel configurations before code
+        for (size_t k = 0; k < kernelsNum; k++)
+        {
+            snprintf(buf, 80, ".kernel kernel_with_long_name_%u\n", cxuint(k));
+            out += buf;
+            out += "    .config\n        .dims x\n";
+        }
+        out += ".text\n";
+    }
+    for (size_t k = 0; k < kernelsNum; k++)
+    {
+        if (format == BinaryFormat::AMD || format == BinaryFormat::AMDCL2)
+        {
+            snprintf(buf, 80, ".kernel kernel_with_long_name_%u\n", cxuint(k));
+            out += buf;
+            out += "    .config\n        .dims x\n    .text\n";
+        }
+        else
+        {
+            snprintf(buf, 80, "kernel_with_long_name_%u:\n    .skip 256\n", cxuint(k));
+            out += buf;
+        }
+        for (size_t l = 0; l < kernelLabelsNum; l++)
+        {
+            // Gallium does not accept global symbols
+            if (format != BinaryFormat::GALLIUM)
+            {
+                snprintf(buf, 80, ".globl L_%u_%u\n", cxuint(k), cxuint(l));
+                out += buf;
+            }
+            snprintf(buf, 80, "L_%u_%u:\n", cxuint(k), cxuint(l));
+            out += buf;
+            snprintf(buf, 80, "    s_mov_b32 s%u, %u\n", cxuint(l&31),
+                    cxuint(k*kernelLabelsNum+l));
+            out += buf;
+        }
+        out += "    s_endpgm\n";
+    }
+    return out;
+}
+
+static void runBenchmark(const BenchFormat& benchFormat, size_t kernelsNum,
+            cxuint repeatsNum)
+{
+    printf("%-8s ", benchFormat.name);
+    fflush(stdout);
+    const std::string source = generateSource(benchFormat.format, kernelsNum);
+    std::istringstream input(source);
+    std::ostringstream msgStream;
+    Array<cxbyte> output;
+    bool good = false;
+    double time = 0.0;
+    try
+    {
+        Assembler assembler("", input, ASM_FORCE_ADD_SYMBOLS, benchFormat.format,
+                    benchFormat.deviceType, msgStream, msgStream);
+        if (benchFormat.format == BinaryFormat::GALLIUM)
+            assembler.setLLVMVersion(40000);
+        good = assembler.assemble();
+        if (good)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            for (cxuint r = 0; r < repeatsNum; r++)
+                assembler.writeBinary(output);
+            auto t1 = std::chrono::steady_clock::now();
+            time = std::chrono::duration<double>(t1-t0).count() / repeatsNum;
+        }
+    }
+    catch(const std::exception& ex)
+    {
+        msgStream << ex.what() << "\n";
+        good = false;
+    }
+    if (!good)
+    {
+        // print first line of error messages
+        std::string msg = msgStream.str();
+        msg = msg.substr(0, msg.find('\n'));
+        printf("skipped: %s\n", msg.c_str());
+        return;
+    }
+    printf("%9.3f ms %10u bytes %8.3f MB/s\n", time*1000.0, cxuint(output.size()),
+            output.size() / time / 1048576.0);
+}
+
+int main(int argc, const char** argv)
+{
+    size_t kernelsNum = 2000;
+    cxuint repeatsNum = 10;
+    if (argc >= 2)
+        kernelsNum = strtoul(argv[1], nullptr, 10);
+    if (argc >= 3)
+        repeatsNum = strtoul(argv[2], nullptr, 10);
+    if (kernelsNum == 0)
+        kernelsNum = 1;
+    if (repeatsNum == 0)
+        repeatsNum = 1;
+    
+    printf("Kernels: %u, symbols: %u, repeats: %u\n", cxuint(kernelsNum),
+           cxuint(kernelsNum*(kernelLabelsNum+1)), repeatsNum);
+    for (const BenchFormat& benchFormat: benchFormats)
+        runBenchmark(benchFormat, kernelsNum, repeatsNum);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#ifdef HAVE_LINUX
+#include <unistd.h>
+#endif
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdbin/AmdCL2Binaries.h>
+#include <CLRX/amdbin/ROCmBinaries.h>
+#include <CLRX/amdbin/GalliumBinaries.h>
+
+using namespace CLRX;
+
+/* benchmark: compares loading binary by loadDataFromFile (copy of file)
+ * with MappedFile (parsing binary in place). Prints average time of loading and
+ * parsing and increase of resident memory (RSS) while binary is loaded. */
+
+// get resident memory size in kilobytes (0 if not available)
+static size_t getResidentMemory()
+{
+#ifdef HAVE_LINUX
+    FILE* file = fopen("/proc/self/statm", "rb");
+    if (file == nullptr)
+        return 0;
+    unsigned long totalPages = 0, residentPages = 0;
+    if (fscanf(file, "%lu %lu", &totalPages, &residentPages) != 2)
+        residentPages = 0;
+    fclose(file);
+    return residentPages * (sysconf(_SC_PAGESIZE) >> 10);
+#else
+    return 0;
+#endif
+}
+
+// parse binary like clrxdisasm, returns number of kernels
+static size_t parseBinary(size_t binarySize, cxbyte* binary)
+{
+    const Flags binFlags = AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_KERNELINFOMAP |
+                AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
+                AMDBIN_CREATE_KERNELHEADERMAP;
+    if (isAmdBinary(binarySize, binary))
+    {
+        std::unique_ptr<AmdMainBinaryBase> base(createAmdBinaryFromCode(
+                    binarySize, binary, binFlags));
+        return base->getKernelInfosNum();
+    }
+    else if (isAmdCL2Binary(binarySize, binary))
+    {
+        std::unique_ptr<AmdCL2MainGPUBinaryBase> base(createAmdCL2BinaryFromCode(
+                    binarySize, binary, binFlags | AMDCL2BIN_INNER_CREATE_KERNELDATA |
+                    AMDCL2BIN_INNER_CREATE_KERNELDATAMAP |
+                    AMDCL2BIN_INNER_CREATE_KERNELSTUBS));
+        return base->getKernelInfosNum();
+    }
+    else if (isROCmBinary(binarySize, binary))
+    {
+        ROCmBinary rocmBin(binarySize, binary, ROCMBIN_CREATE_REGIONMAP);
+        return rocmBin.getRegionsNum();
+    }
+    GalliumBinary galliumBin(binarySize, binary, 0);
+    return galliumBin.getKernelsNum();
+}
+
+int main(int argc, const char** argv)
+{
+    const char* filename = CLRX_SOURCE_DIR "/tests/amdasm/amdbins/amdcl2.clo";
+    if (argc >= 2)
+        filename = argv[1];
+    cxuint repeats = 100;
+    if (argc >= 3)
+        repeats = atoi(argv[2]);
+    if (repeats == 0)
+        repeats = 1;
+    
+    try
+    {
+        size_t kernelsNum = 0;
+        size_t loadRss = 0, mapRss = 0;
+        // load whole file to memory and parse it
+        auto t0 = std::chrono::steady_clock::now();
+        for (cxuint r = 0; r < repeats; r++)
+        {
+            const size_t rssBefore = getResidentMemory();
+            Array<cxbyte> content = loadDataFromFile(filename);
+            kernelsNum = parseBinary(content.size(), content.data());
+            const size_t rssAfter = getResidentMemory();
+            if (rssAfter > rssBefore + loadRss)
+                loadRss = rssAfter - rssBefore;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        const double loadTime = std::chrono::duration<double, std::milli>(
+                    t1-t0).count() / repeats;
+        
+        // map file and parse it in place
+        t0 = std::chrono::steady_clock::now();
+        for (cxuint r = 0; r < repeats; r++)
+        {
+            const size_t rssBefore = getResidentMemory();
+            MappedFile content(filename);
+            kernelsNum = parseBinary(content.size(), content.data());
+            const size_t rssAfter = getResidentMemory();
+            if (rssAfter > rssBefore + mapRss)
+                mapRss = rssAfter - rssBefore;
+        }
+        t1 = std::chrono::steady_clock::now();
+        const double mapTime = std::chrono::duration<double, std::milli>(
+                    t1-t0).count() / repeats;
+        
+        std::cout << "File: " << filename << " (kernels: " << kernelsNum << ")\n";
+        std::cout << "loadDataFromFile: " << loadTime << " ms, RSS increase: " <<
+                    loadRss << " kB\n";
+        std::cout << "MappedFile:       " << mapTime << " ms, RSS increase: " <<
+                    mapRss << " kB" << std::endl;
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/utils/GPUId.h>
+#include "../amdasm/GCNAsmInternals.h"
+#include "../tests/amdasm/GCNAsmOpc.h"
+
+using namespace CLRX;
+
+/* microbenchmark: compares lookup of GCN mnemonics by binary search in
+ * sorted instruction table (old method) with lookup by perfect hash.
+ * Mnemonics are taken from GCN assembler opcode test cases. */
+
+// extract mnemonic from test case line (in lower case, without encoding suffix)
+static std::string getMnemonic(const char* line)
+{
+    const char* p = line;
+    // skip statements before instruction (like 'sym=value ;')
+    const char* semicolon = ::strrchr(p, ';');
+    if (semicolon != nullptr)
+        p = semicolon+1;
+    while (isSpace(*p)) p++;
+    const char* start = p;
+    while (isAlnum(*p) || *p=='_') p++;
+    std::string mnemonic(start, p);
+    toLowerString(mnemonic);
+    const size_t len = mnemonic.size();
+    if (len > 4 && (mnemonic.compare(len-4, 4, "_e64")==0 ||
+            mnemonic.compare(len-4, 4, "_e32")==0 ||
+            mnemonic.compare(len-4, 4, "_dpp")==0))
+        mnemonic.resize(len-4);
+    else if (len > 5 && mnemonic.compare(len-5, 5, "_sdwa")==0)
+        mnemonic.resize(len-5);
+    return mnemonic;
+}
+
+// old lookup: binary search and linear walk to entry for architecture
+static const GCNAsmInstruction* findByBinarySearch(const char* mnemonic,
+            GPUArchMask archMask)
+{
+    const GCNAsmInstruction* tableEnd = gcnInstrSortedTable + gcnInstrSortedTableSize;
+    const GCNAsmInstruction* it = binaryFind(gcnInstrSortedTable, tableEnd,
+               GCNAsmInstruction{mnemonic},
+               [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
+               { return ::strcmp(instr1.mnemonic, instr2.mnemonic)<0; });
+    if (it != tableEnd && (it->archMask & archMask)==0)
+        for (++it ;it != tableEnd && ::strcmp(it->mnemonic, mnemonic)==0 &&
+               (it->archMask & archMask)==0; ++it);
+    if (it == tableEnd || ::strcmp(it->mnemonic, mnemonic)!=0)
+        return nullptr;
+    return it;
+}
+
+struct CorpusEntry
+{
+    const char* name;
+    const GCNAsmOpcodeCase* cases;
+    GPUArchitecture arch;
+};
+
+static const CorpusEntry corpora[] =
+{
+    { "GCN1.0", encGCNOpcodeCases, GPUArchitecture::GCN1_0 },
+    { "GCN1.1", encGCN11OpcodeCases, GPUArchitecture::GCN1_1 },
+    { "GCN1.2", encGCN12OpcodeCases, GPUArchitecture::GCN1_2 },
+    { "GCN1.4", encGCN14OpcodeCases, GPUArchitecture::GCN1_4 },
+    { "GCN1.4.1", encGCN141OpcodeCases, GPUArchitecture::GCN1_4_1 }
+};
+
+int main(int argc, const char** argv)
+{
+    cxuint repeats = 200;
+    if (argc >= 2)
+        repeats = atoi(argv[1]);
+    
+    int retVal = 0;
+    for (const CorpusEntry& corpus: corpora)
+    {
+        std::vector<std::string> mnemonics;
+        for (cxuint i = 0; corpus.cases[i].input != nullptr; i++)
+        {
+            std::string mnemonic = getMnemonic(corpus.cases[i].input);
+            if (!mnemonic.empty())
+                mnemonics.push_back(mnemonic);
+        }
+        const GPUArchMask archMask = 1U<<cxuint(corpus.arch);
+        
+        // check whether both methods give same results
+        for (const std::string& mnemonic: mnemonics)
+            if (findByBinarySearch(mnemonic.c_str(), archMask) !=
+                findGCNAsmInstruction(mnemonic.c_str(), corpus.arch))
+            {
+                std::cerr << "Mismatch for " << corpus.name << " " <<
+                            mnemonic << std::endl;
+                retVal = 1;
+            }
+        
+        size_t found = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (cxuint r = 0; r < repeats; r++)
+            for (const std::string& mnemonic: mnemonics)
+                found += (findByBinarySearch(mnemonic.c_str(), archMask) != nullptr);
+        auto t1 = std::chrono::steady_clock::now();
+        for (cxuint r = 0; r < repeats; r++)
+            for (const std::string& mnemonic: mnemonics)
+                found += (findGCNAsmInstruction(mnemonic.c_str(),
+                            corpus.arch) != nullptr);
+        auto t2 = std::chrono::steady_clock::now();
+        
+        const double lookups = double(mnemonics.size())*repeats;
+        const double binaryNs = std::chrono::duration<double, std::nano>(t1-t0).count();
+        const double hashNs = std::chrono::duration<double, std::nano>(t2-t1).count();
+        printf("%-9s lookups: %8zu  binary search: %7.2f ns/lookup  "
+               "perfect hash: %7.2f ns/lookup  speedup: %.2fx  (found: %zu)\n",
+               corpus.name, mnemonics.size(), binaryNs/lookups, hashNs/lookups,
+               binaryNs/hashNs, found);
+    }
+    return retVal;
+}
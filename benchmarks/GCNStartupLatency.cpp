@@ -0,0 +1,131 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <chrono>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/Disassembler.h>
+
+using namespace CLRX;
+
+/* startup latency benchmark: measures time of first assembling and
+ * first disassembling of small GCN code in process (what short clrxasm/clrxdisasm
+ * invocation pays) and compares it with average time of next runs.
+ * GCN instruction tables are constant data, hence first run should not be
+ * noticeably slower than next runs. */
+
+static const char* asmSource =
+    "s_mov_b32 s0, s1\n"
+    "v_add_f32 v1, v2, v3\n"
+    "v_mad_f32 v1, v2, v3, v4\n"
+    "buffer_load_dword v1, v2, s[4:7], s3 offen\n"
+    "s_waitcnt vmcnt(0)\n"
+    "s_endpgm\n";
+
+// assemble source, return output size
+static size_t assembleSource(GPUDeviceType devType)
+{
+    std::istringstream input(asmSource);
+    std::ostringstream msgStream;
+    Assembler assembler("", input, 0, BinaryFormat::RAWCODE, devType, msgStream);
+    if (!assembler.assemble())
+        throw Exception(msgStream.str());
+    return assembler.getSections()[0].content.size();
+}
+
+// disassemble code, return output size
+static size_t disassembleCode(GPUDeviceType devType, const Array<cxbyte>& code)
+{
+    std::ostringstream output;
+    Disassembler disasm(devType, code.size(), code.data(), output);
+    disasm.disassemble();
+    return output.str().size();
+}
+
+static double elapsedMicros(std::chrono::steady_clock::time_point t0,
+            std::chrono::steady_clock::time_point t1)
+{
+    return std::chrono::duration<double, std::micro>(t1-t0).count();
+}
+
+int main(int argc, const char** argv)
+{
+    cxuint repeats = 1000;
+    if (argc >= 2)
+        repeats = atoi(argv[1]);
+    if (repeats == 0)
+        repeats = 1;
+    const GPUDeviceType devType = GPUDeviceType::FIJI;
+    
+    try
+    {
+        size_t total = 0;
+        // first run - includes initialization of assembler
+        auto t0 = std::chrono::steady_clock::now();
+        total += assembleSource(devType);
+        auto t1 = std::chrono::steady_clock::now();
+        const double asmFirst = elapsedMicros(t0, t1);
+    
+        t0 = std::chrono::steady_clock::now();
+        for (cxuint r = 0; r < repeats; r++)
+            total += assembleSource(devType);
+        t1 = std::chrono::steady_clock::now();
+        const double asmNext = elapsedMicros(t0, t1) / repeats;
+    
+        // prepare code to disassemble
+        Array<cxbyte> code;
+        {
+            std::istringstream input(asmSource);
+            std::ostringstream msgStream;
+            Assembler assembler("", input, 0, BinaryFormat::RAWCODE, devType, msgStream);
+            assembler.assemble();
+            const std::vector<cxbyte>& content = assembler.getSections()[0].content;
+            code.assign(content.begin(), content.end());
+        }
+    
+        // first run - includes initialization of disassembler
+        t0 = std::chrono::steady_clock::now();
+        total += disassembleCode(devType, code);
+        t1 = std::chrono::steady_clock::now();
+        const double disasmFirst = elapsedMicros(t0, t1);
+    
+        t0 = std::chrono::steady_clock::now();
+        for (cxuint r = 0; r < repeats; r++)
+            total += disassembleCode(devType, code);
+        t1 = std::chrono::steady_clock::now();
+        const double disasmNext = elapsedMicros(t0, t1) / repeats;
+    
+        std::cout << "Assembler: first " << asmFirst << " us, next " <<
+                asmNext << " us\n";
+        std::cout << "Disassembler: first " << disasmFirst << " us, next " <<
+                disasmNext << " us\n";
+        std::cout << "Total output: " << total << std::endl;
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <climits>
+#include <algorithm>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+
+using namespace CLRX;
+
+/* benchmark: measures register allocator (graph coloring and linear scan mode)
+ * for generated kernels with many register variables, and compares decoding
+ * of register usages from usage handler with usage arrays.
+ * Every regvar is read by next instruction and by instruction after window
+ * (hence about window regvars are live at same time). Kernel is divided
+ * to code blocks by conditional jumps. */
+
+// put kernel with regvarsNum SGPR and VGPR regvars
+static std::string generateSource(size_t regvarsNum, size_t window)
+{
+    std::string out;
+    char buf[100];
+    for (size_t i = 0; i < regvarsNum; i++)
+    {
+        snprintf(buf, 100, ".regvar sa%u:s, va%u:v\n", cxuint(i), cxuint(i));
+        out += buf;
+    }
+    const size_t swindow = (window >> 1);
+    for (size_t i = 0; i < regvarsNum; i++)
+    {
+        if (i < window)
+            snprintf(buf, 100, "    v_mov_b32 va%u, v0\n", cxuint(i));
+        else
+            snprintf(buf, 100, "    v_add_f32 va%u, va%u, va%u\n", cxuint(i),
+                    cxuint(i-1), cxuint(i-window));
+        out += buf;
+        if (i < swindow)
+            snprintf(buf, 100, "    s_mov_b32 sa%u, s0\n", cxuint(i));
+        else
+            snprintf(buf, 100, "    s_add_u32 sa%u, sa%u, sa%u\n", cxuint(i),
+                    cxuint(i-1), cxuint(i-swindow));
+        out += buf;
+        if ((i & 255) == 255)
+        {
+            // split to code blocks
+            snprintf(buf, 100, "    s_cbranch_scc0 L%u\nL%u:\n", cxuint(i), cxuint(i));
+            out += buf;
+        }
+    }
+    // use last regvars
+    for (size_t i = regvarsNum > window ? regvarsNum-window : 0; i < regvarsNum; i++)
+    {
+        snprintf(buf, 100, "    v_mov_b32 v1, va%u\n    s_mov_b32 s1, sa%u\n",
+                 cxuint(i), cxuint(i));
+        out += buf;
+    }
+    out += "    s_endpgm\n";
+    return out;
+}
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+static double msecs(const TimePoint& t0, const TimePoint& t1)
+{ return std::chrono::duration<double>(t1-t0).count()*1000.0; }
+
+static void runBenchmark(size_t regvarsNum, size_t window, AsmRegAllocMode mode)
+{
+    const std::string source = generateSource(regvarsNum, window);
+    printf("%8u %6u %-8s ", cxuint(regvarsNum), cxuint(window),
+           mode == AsmRegAllocMode::LINEAR_SCAN ? "linear" : "coloring");
+    fflush(stdout);
+    
+    std::istringstream input(source);
+    std::ostringstream msgStream;
+    // register variable usage is collected only in test runs
+    Assembler assembler("", input, (ASM_ALL&~ASM_ALTMACRO) | ASM_TESTRUN |
+                ASM_TESTRESOLVE, BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE,
+                msgStream, msgStream);
+    if (!assembler.assemble())
+    {
+        std::string msg = msgStream.str();
+        msg = msg.substr(0, msg.find('\n'));
+        printf("skipped: %s\n", msg.c_str());
+        return;
+    }
+    const AsmSection& section = assembler.getSections()[0];
+    AsmRegAllocator regAlloc(assembler);
+    try
+    {
+        const TimePoint t0 = std::chrono::steady_clock::now();
+        regAlloc.createCodeStructure(section.codeFlow, section.getSize(),
+                    section.content.data());
+        regAlloc.createSSAData(*section.usageHandler, *section.linearDepHandler);
+        regAlloc.applySSAReplaces();
+        regAlloc.createLivenesses(*section.usageHandler, *section.linearDepHandler);
+        const TimePoint t1 = std::chrono::steady_clock::now();
+        if (mode == AsmRegAllocMode::LINEAR_SCAN)
+            regAlloc.linearScanRegisters();
+        else
+        {
+            regAlloc.createInterferenceGraph();
+            regAlloc.colorInterferenceGraph();
+        }
+        const TimePoint t2 = std::chrono::steady_clock::now();
+        
+        // count used colors
+        cxuint colorsNum[2] = { 0, 0 };
+        for (cxuint r = 0; r < 2; r++)
+            for (cxuint color: regAlloc.getGraphColorMaps()[r])
+                if (color != UINT_MAX)
+                    colorsNum[r] = std::max(colorsNum[r], color+1);
+        printf("%10.3f ms %10.3f ms %5u %5u\n", msecs(t0, t1), msecs(t1, t2),
+               colorsNum[0], colorsNum[1]);
+    }
+    catch(const std::exception& ex)
+    { printf("failed: %s\n", ex.what()); }
+}
+
+// compare usage handler encoding with usage arrays (memory and time)
+static void runUsageBenchmark(size_t regvarsNum, size_t window)
+{
+    const std::string source = generateSource(regvarsNum, window);
+    printf("%8u %6u ", cxuint(regvarsNum), cxuint(window));
+    fflush(stdout);
+    
+    std::istringstream input(source);
+    std::ostringstream msgStream;
+    Assembler assembler("", input, (ASM_ALL&~ASM_ALTMACRO) | ASM_TESTRUN |
+                ASM_TESTRESOLVE, BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE,
+                msgStream, msgStream);
+    if (!assembler.assemble())
+    {
+        printf("skipped\n");
+        return;
+    }
+    ISAUsageHandler& usageHandler = *assembler.getSections()[0].usageHandler;
+    size_t sum = 0;
+    const TimePoint t0 = std::chrono::steady_clock::now();
+    usageHandler.rewind();
+    while (usageHandler.hasNext())
+        sum += usageHandler.nextUsage().rend;
+    const TimePoint t1 = std::chrono::steady_clock::now();
+    ISAUsageArrays usageArrays;
+    usageArrays.assign(usageHandler);
+    const TimePoint t2 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < usageArrays.getInstrsNum(); i++)
+        for (size_t ui = usageArrays.instrUsageStarts[i];
+                    ui < usageArrays.instrUsageStarts[i+1]; ui++)
+            sum -= usageArrays.getUsage(i, ui).rend;
+    const TimePoint t3 = std::chrono::steady_clock::now();
+    // usages vector: previous form of usages in wait scheduler
+    printf("%10u %10u %10u %10.3f ms %10.3f ms %10.3f ms%s\n",
+           cxuint(usageHandler.getEncodedSize()), cxuint(usageArrays.getMemorySize()),
+           cxuint(usageHandler.getUsagesNum()*sizeof(AsmRegVarUsage)),
+           msecs(t0, t1), msecs(t1, t2), msecs(t2, t3), sum != 0 ? " mismatch" : "");
+}
+
+int main(int argc, const char** argv)
+{
+    size_t maxRegvarsNum = 16000;
+    size_t window = 64;
+    if (argc >= 2)
+        maxRegvarsNum = strtoul(argv[1], nullptr, 10);
+    if (argc >= 3)
+        window = strtoul(argv[2], nullptr, 10);
+    if (window < 2)
+        window = 2;
+    printf("regvars  window mode        prepare       allocation sgprs vgprs\n");
+    for (size_t regvarsNum = 1000; regvarsNum <= maxRegvarsNum; regvarsNum *= 4)
+    {
+        runBenchmark(regvarsNum, window, AsmRegAllocMode::GRAPH_COLORING);
+        runBenchmark(regvarsNum, window, AsmRegAllocMode::LINEAR_SCAN);
+    }
+    printf("\nregvars  window encoded(B)  arrays(B)  vector(B)     decode        "
+            "convert       scan\n");
+    for (size_t regvarsNum = 1000; regvarsNum <= maxRegvarsNum; regvarsNum *= 4)
+        runUsageBenchmark(regvarsNum, window);
+    return 0;
+}
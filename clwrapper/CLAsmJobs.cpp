@@ -0,0 +1,335 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#ifdef HAVE_WINDOWS
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <fstream>
+#include <functional>
+#include <inttypes.h>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/utils/InputOutput.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "CLAsmJobs.h"
+
+using namespace CLRX;
+
+/* persistent cache of assembled programs.
+ * Cache entry is a file in cache directory whose name is hash of all assembler inputs
+ * (source, options, device type, driver version, CLRX version). Entry holds list of
+ * included files with hashes of their contents, list of include candidates that
+ * did not exist (tried before included files), build log and program binary. */
+
+static const char clrxAsmCacheMagic[8] = { 'C', 'L', 'R', 'X', 'W', 'C', 'H', '2' };
+
+template<typename T>
+static inline void putCacheValue(std::string& out, T value)
+{ out.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+static inline void putCacheString(std::string& out, size_t size, const char* str)
+{
+    putCacheValue<uint64_t>(out, size);
+    out.append(str, size);
+}
+
+// simple reader of cache entry (returns false if entry is corrupted)
+struct CLRX_INTERNAL CLAsmCacheReader
+{
+    const cxbyte* data;
+    const cxbyte* end;
+    
+    template<typename T>
+    bool get(T& value)
+    {
+        if (size_t(end-data) < sizeof(T))
+            return false;
+        ::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return true;
+    }
+    
+    bool getString(size_t& size, const char*& str)
+    {
+        uint64_t size64;
+        if (!get(size64) || uint64_t(end-data) < size64)
+            return false;
+        size = size64;
+        str = reinterpret_cast<const char*>(data);
+        data += size;
+        return true;
+    }
+};
+
+std::string clrxGetAsmCachePath(size_t sourceCodeSize, const char* sourceCode,
+            const CLAsmCommonOptions& options, const CLAsmDeviceJob& asmJob,
+            bool useCL20StdByDev)
+{
+    std::string keyData;
+    putCacheString(keyData, ::strlen(CLRX_VERSION), CLRX_VERSION);
+    putCacheValue<uint32_t>(keyData, cxuint(asmJob.devType));
+    putCacheValue<cxbyte>(keyData, asmJob.is64Bit);
+    putCacheValue<cxbyte>(keyData, useCL20StdByDev);
+    putCacheValue<uint32_t>(keyData, options.asmFlags);
+    putCacheValue<cxbyte>(keyData, options.havePolicy);
+    putCacheValue<uint32_t>(keyData, options.policyVersion);
+    putCacheValue<uint32_t>(keyData, options.driverVersion);
+    putCacheValue<uint64_t>(keyData, options.includePaths.size());
+    for (const CString& incPath: options.includePaths)
+        putCacheString(keyData, incPath.size(), incPath.c_str());
+    putCacheValue<uint64_t>(keyData, options.defSyms.size());
+    for (const auto& defSym: options.defSyms)
+    {
+        putCacheString(keyData, defSym.first.size(), defSym.first.c_str());
+        putCacheValue<uint64_t>(keyData, defSym.second);
+    }
+    putCacheString(keyData, sourceCodeSize, sourceCode);
+    
+    const std::pair<uint64_t, uint64_t> hash = calculateHash128(
+                keyData.size(), keyData.data());
+    char nameBuf[48];
+    ::snprintf(nameBuf, sizeof nameBuf, "%016" PRIx64 "%016" PRIx64 ".clrxcache",
+               hash.first, hash.second);
+    return joinPaths(options.cacheDir, nameBuf);
+}
+
+// calculate hash of file content (returns false if file can not be read)
+static bool clrxGetFileHash(const char* filename, std::pair<uint64_t, uint64_t>& hash)
+{
+    try
+    {
+        const Array<cxbyte> content = loadDataFromFile(filename);
+        hash = calculateHash128(content.size(), content.data());
+        return true;
+    }
+    catch(const Exception& ex)
+    { return false; }
+}
+
+// try to load program from cache (returns true if loaded)
+static bool clrxLoadAsmCacheEntry(const std::string& cachePath, CLAsmDeviceJob& asmJob)
+{
+    Array<cxbyte> entry;
+    try
+    { entry = loadDataFromFile(cachePath.c_str()); }
+    catch(const Exception& ex)
+    { return false; } // no entry
+    
+    CLAsmCacheReader reader{ entry.data(), entry.data()+entry.size() };
+    char magic[8];
+    if (!reader.get(magic) || ::memcmp(magic, clrxAsmCacheMagic, 8)!=0)
+        return false;
+    // check whether included files are unchanged
+    uint64_t depsNum;
+    if (!reader.get(depsNum))
+        return false;
+    for (uint64_t i = 0; i < depsNum; i++)
+    {
+        size_t pathSize;
+        const char* pathStr;
+        std::pair<uint64_t, uint64_t> depHash, curHash;
+        if (!reader.getString(pathSize, pathStr) || !reader.get(depHash.first) ||
+            !reader.get(depHash.second))
+            return false;
+        if (!clrxGetFileHash(std::string(pathStr, pathSize).c_str(), curHash) ||
+            curHash != depHash)
+            return false; // changed or removed
+    }
+    // check whether include resolution gives these same files
+    uint64_t absentsNum;
+    if (!reader.get(absentsNum))
+        return false;
+    for (uint64_t i = 0; i < absentsNum; i++)
+    {
+        size_t pathSize;
+        const char* pathStr;
+        if (!reader.getString(pathSize, pathStr))
+            return false;
+        if (isFileExists(std::string(pathStr, pathSize).c_str()))
+            return false; // new file shadows included file
+    }
+    size_t logSize, binarySize;
+    const char* logStr;
+    const char* binaryData;
+    if (!reader.getString(logSize, logStr) || !reader.getString(binarySize, binaryData))
+        return false;
+    
+    asmJob.log = RefPtr<CLProgLogEntry>(new CLProgLogEntry(std::string(logStr, logSize)));
+    asmJob.good = true;
+    asmJob.progBin = RefPtr<CLProgBinEntry>(new CLProgBinEntry(
+                Array<cxbyte>((const cxbyte*)binaryData,
+                        (const cxbyte*)binaryData + binarySize)));
+    return true;
+}
+
+/* store program in cache (errors are ignored). Hashes of included files are hashes
+ * of content read by assembler (not content of files after assembling) */
+static void clrxStoreAsmCacheEntry(const std::string& cachePath,
+            const std::vector<CString>& dependencyFiles,
+            const std::vector<std::pair<uint64_t, uint64_t> >& dependencyFileHashes,
+            const std::vector<CString>& absentDependencyFiles, const CLAsmDeviceJob& asmJob)
+{
+    if (dependencyFiles.size() != dependencyFileHashes.size())
+        return; // do not cache if some hashes are not recorded
+    std::string entry(clrxAsmCacheMagic, 8);
+    putCacheValue<uint64_t>(entry, dependencyFiles.size());
+    for (size_t i = 0; i < dependencyFiles.size(); i++)
+    {
+        const CString& depFile = dependencyFiles[i];
+        putCacheString(entry, depFile.size(), depFile.c_str());
+        putCacheValue<uint64_t>(entry, dependencyFileHashes[i].first);
+        putCacheValue<uint64_t>(entry, dependencyFileHashes[i].second);
+    }
+    putCacheValue<uint64_t>(entry, absentDependencyFiles.size());
+    for (const CString& absentFile: absentDependencyFiles)
+        putCacheString(entry, absentFile.size(), absentFile.c_str());
+    const std::string& log = asmJob.log->log;
+    putCacheString(entry, log.size(), log.c_str());
+    const Array<cxbyte>& binary = asmJob.progBin->binary;
+    putCacheString(entry, binary.size(), (const char*)binary.data());
+    
+    /* write to temporary file and rename to final name
+     * (other processes can read this entry at this same time).
+     * temporary name is unique for process and thread */
+#ifdef HAVE_WINDOWS
+    const uint64_t processId = ::_getpid();
+#else
+    const uint64_t processId = ::getpid();
+#endif
+    const std::string tmpPath = cachePath + ".tmp" + std::to_string(processId) + "_" +
+            std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream ofs(tmpPath.c_str(), std::ios::binary);
+        if (!ofs)
+            return;
+        ofs.write(entry.data(), entry.size());
+        if (!ofs)
+        {
+            ofs.close();
+            ::remove(tmpPath.c_str());
+            return;
+        }
+    }
+    if (::rename(tmpPath.c_str(), cachePath.c_str()) != 0)
+        ::remove(tmpPath.c_str());
+}
+
+void clrxAssembleForDevice(size_t sourceCodeSize, const char* sourceCode,
+            const CLAsmCommonOptions& options, CLAsmDeviceJob& asmJob)
+{
+    /// determine whether use useCL20StdByDev
+    bool useCL20StdByDev = (options.useCL20Std || (options.useCL2StdForGCN11 &&
+            getGPUArchitectureFromDeviceType(asmJob.devType) >= GPUArchitecture::GCN1_1));
+    std::string cachePath;
+    if (!options.cacheDir.empty())
+    {
+        cachePath = clrxGetAsmCachePath(sourceCodeSize, sourceCode, options,
+                    asmJob, useCL20StdByDev);
+        if (clrxLoadAsmCacheEntry(cachePath, asmJob))
+            return; // program found in cache
+    }
+    // assemble it
+    ArrayIStream astream(sourceCodeSize, sourceCode);
+    std::string msgString;
+    StringOStream msgStream(msgString);
+    Assembler assembler("", astream, options.asmFlags,
+                (useCL20StdByDev) ? BinaryFormat::AMDCL2 : BinaryFormat::AMD,
+                asmJob.devType, msgStream);
+    assembler.set64Bit(asmJob.is64Bit);
+    // use same driver version as in cache key
+    assembler.setDriverVersion(options.driverVersion);
+    
+    for (const CString& incPath: options.includePaths)
+        assembler.addIncludeDir(incPath);
+    for (const auto& defSym: options.defSyms)
+        assembler.addInitialDefSym(defSym.first, defSym.second);
+    if (options.havePolicy)
+        assembler.setPolicyVersion(options.policyVersion);
+    
+    /// call main assembler routine
+    bool good = false;
+    try
+    { good = assembler.assemble(); }
+    catch(...)
+    {
+        // if failed
+        asmJob.log = RefPtr<CLProgLogEntry>(new CLProgLogEntry(std::move(msgString)));
+        asmJob.good = false;
+        return;
+    }
+    /// set up logs
+    asmJob.log = RefPtr<CLProgLogEntry>(new CLProgLogEntry(std::move(msgString)));
+    if (good)
+    {
+        // try to write binary and keep it in compiled program binaries
+        try
+        {
+            asmJob.good = true;
+            Array<cxbyte> output;
+            assembler.writeBinary(output);
+            asmJob.progBin = RefPtr<CLProgBinEntry>(
+                        new CLProgBinEntry(std::move(output)));
+            if (!cachePath.empty())
+                clrxStoreAsmCacheEntry(cachePath, assembler.getDependencyFiles(),
+                            assembler.getDependencyFileHashes(),
+                            assembler.getAbsentDependencyFiles(), asmJob);
+        }
+        catch(const Exception& ex)
+        {
+            // if exception during writing binary
+            asmJob.progBin.reset();
+            asmJob.log->log.append(ex.what());
+            asmJob.good = false;
+        }
+    }
+    else // error
+        asmJob.good = false;
+}
+
+void clrxMergeAsmJobResults(size_t devicesNum, const cxuint* devJobIndices,
+            const std::vector<CLAsmDeviceJob>& asmJobs, CLAsmDeviceJob* devResults,
+            bool& asmFailure, bool& asmNotAvailable)
+{
+    for (size_t i = 0; i < devicesNum; i++)
+    {
+        CLAsmDeviceJob& devResult = devResults[i];
+        if (devJobIndices[i] == UINT_MAX)
+        {
+            // if assembler not available for this device
+            devResult = CLAsmDeviceJob();
+            asmNotAvailable = true;
+            continue;
+        }
+        devResult = asmJobs[devJobIndices[i]];
+        if (!devResult.good)
+            asmFailure = true;
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* assembler jobs of CLRXWrapper. This part does not use OpenCL headers,
+ * hence it can be tested without OpenCL */
+
+#ifndef __CLRX_CLASMJOBS_H__
+#define __CLRX_CLASMJOBS_H__
+
+#include <CLRX/Config.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/utils/GPUId.h>
+
+struct CLRX_INTERNAL CLProgLogEntry: public CLRX::FastRefCountable
+{
+    std::string log;
+    CLProgLogEntry() { }
+    CLProgLogEntry(const std::string& _log) : log(_log) { }
+    CLProgLogEntry(std::string&& _log) noexcept
+            : log(std::move(_log)) { }
+};
+
+struct CLRX_INTERNAL CLProgBinEntry: public CLRX::FastRefCountable
+{
+    CLRX::Array<cxbyte> binary;
+    CLProgBinEntry() { }
+    CLProgBinEntry(const CLRX::Array<cxbyte>& _binary) : binary(_binary) { }
+    CLProgBinEntry(CLRX::Array<cxbyte>&& _binary) noexcept
+            : binary(std::move(_binary)) { }
+};
+
+// common assembler options for all devices
+struct CLRX_INTERNAL CLAsmCommonOptions
+{
+    CLRX::Flags asmFlags;
+    bool useCL20Std;
+    bool useCL2StdForGCN11;
+    bool havePolicy;
+    cxuint policyVersion;
+    uint32_t driverVersion; // detected AMD driver version (chooses binary layout)
+    const std::vector<CLRX::CString>& includePaths;
+    const std::vector<std::pair<CLRX::CString, uint64_t> >& defSyms;
+    std::string cacheDir;   // empty if cache is disabled
+};
+
+// assembler job for single device type
+struct CLRX_INTERNAL CLAsmDeviceJob
+{
+    CLRX::GPUDeviceType devType;
+    bool is64Bit;
+    bool good;  // true if assembled successfully (build status)
+    CLRX::RefPtr<CLProgLogEntry> log;
+    CLRX::RefPtr<CLProgBinEntry> progBin; // null if failed
+
+    CLAsmDeviceJob() : devType(CLRX::GPUDeviceType::CAPE_VERDE), is64Bit(false),
+            good(false)
+    { }
+};
+
+// get path to cache entry for assembler inputs
+CLRX_INTERNAL extern std::string clrxGetAsmCachePath(size_t sourceCodeSize,
+            const char* sourceCode, const CLAsmCommonOptions& options,
+            const CLAsmDeviceJob& asmJob, bool useCL20StdByDev);
+
+/* assemble source for single device type. This routine does not call any
+ * OpenCL function, hence can be called concurrently for many device types */
+CLRX_INTERNAL extern void clrxAssembleForDevice(size_t sourceCodeSize,
+            const char* sourceCode, const CLAsmCommonOptions& options,
+            CLAsmDeviceJob& asmJob);
+
+/* merge results of jobs in device order. devJobIndices[i] is index of job for
+ * i'th device (UINT_MAX if assembler is not available for device).
+ * devResults[i] is set to result of job for i'th device (failed if no job) */
+CLRX_INTERNAL extern void clrxMergeAsmJobResults(size_t devicesNum,
+            const cxuint* devJobIndices, const std::vector<CLAsmDeviceJob>& asmJobs,
+            CLAsmDeviceJob* devResults, bool& asmFailure, bool& asmNotAvailable);
+
+#endif
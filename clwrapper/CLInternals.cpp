@@ -1477,15 +1477,6 @@ static std::pair<CString, uint64_t> getDefSym(const CString& word)
     return defSym;
 }
 
-struct CLRX_INTERNAL CLProgBinEntry: public FastRefCountable
-{
-    Array<cxbyte> binary;
-    CLProgBinEntry() { }
-    CLProgBinEntry(const Array<cxbyte>& _binary) : binary(_binary) { }
-    CLProgBinEntry(Array<cxbyte>&& _binary) noexcept
-            : binary(std::move(_binary)) { }
-};
-
 // generate table with order of associated devices (from program)
 static cl_int genDeviceOrder(cl_uint devicesNum, const cl_device_id* devices,
                cl_uint assocDevicesNum, const cl_device_id* assocDevices,
@@ -1581,7 +1572,8 @@ try
     bool useCL20Std = false;
     bool useLegacy = false;
     // drivers since 200406 version uses AmdCL2 binary format by default for >=GCN1.1
-    bool useCL2StdForGCN11 = detectAmdDriverVersion() >= 200406;
+    const uint32_t driverVersion = detectAmdDriverVersion();
+    bool useCL2StdForGCN11 = driverVersion >= 200406;
     bool havePolicy = false;
     cxuint policyVersion = 0;
     
@@ -1734,42 +1726,31 @@ try
     
     bool asmFailure = false;
     bool asmNotAvailable = false;
+    /* prepare assembler jobs: one job per distinct device type. If next device
+     * has this same type then its results will be copied from previous device */
+    std::vector<CLAsmDeviceJob> asmJobs;
+    std::unique_ptr<cxuint[]> devJobIndices(new cxuint[devicesNum]);
     cxuint prevDeviceType = -1;
     for (cxuint i = 0; i < devicesNum; i++)
     {
         const auto& entry = outDeviceIndexMap[i];
-        ProgDeviceEntry& progDevEntry = progDeviceEntries[i];
         cxuint devType = -1;
         try
         { devType = cxuint(getGPUDeviceTypeFromName(entry.devName.c_str())); }
         catch(const Exception& ex)
         {
             // if assembler not available for this device
-            progDevEntry.status = CL_BUILD_ERROR;
-            asmNotAvailable = true;
+            devJobIndices[i] = UINT_MAX;
             prevDeviceType = devType;
             continue;
         }
         // make duplicate only if not first entry
         if (i!=0 && devType == prevDeviceType)
         {
-            // copy from previous device (if this same device type)
-            compiledProgBins[i] = compiledProgBins[i-1];
-            progDevEntry = progDeviceEntries[i-1];
+            devJobIndices[i] = devJobIndices[i-1];
             continue; // skip if this same architecture
         }
         prevDeviceType = devType;
-        // assemble it
-        ArrayIStream astream(sourceCodeSize-1, sourceCode.get());
-        std::string msgString;
-        StringOStream msgStream(msgString);
-        /// determine whether use useCL20StdByDev
-        bool useCL20StdByDev = (useCL20Std || (useCL2StdForGCN11 &&
-                getGPUArchitectureFromDeviceType(GPUDeviceType(devType))
-                        >=GPUArchitecture::GCN1_1));
-        Assembler assembler("", astream, asmFlags,
-                    (useCL20StdByDev) ? BinaryFormat::AMDCL2 : BinaryFormat::AMD,
-                    GPUDeviceType(devType), msgStream);
         
         // get address bit - for bitness
         cl_uint addressBits;
@@ -1777,58 +1758,40 @@ try
                     CL_DEVICE_ADDRESS_BITS, sizeof(cl_uint), &addressBits, nullptr);
         if (error != CL_SUCCESS)
             clrxAbort("Fatal error at clCompilerCall (clGetDeviceInfo)");
-        assembler.set64Bit(addressBits==64);
-        
-        for (const CString& incPath: includePaths)
-            assembler.addIncludeDir(incPath);
-        for (const auto& defSym: defSyms)
-            assembler.addInitialDefSym(defSym.first, defSym.second);
-        if (havePolicy)
-            assembler.setPolicyVersion(policyVersion);
         
-        /// call main assembler routine
-        bool good = false;
-        try
-        { good = assembler.assemble(); }
-        catch(...)
-        {
-            // if failed
-            progDevEntry.log = RefPtr<CLProgLogEntry>(
-                            new CLProgLogEntry(std::move(msgString)));
-            progDevEntry.status = CL_BUILD_ERROR;
-            asmFailure = true;
-            continue;
-        }
-        /// set up logs
-        progDevEntry.log = RefPtr<CLProgLogEntry>(
-                            new CLProgLogEntry(std::move(msgString)));
-        if (good)
-        {
-            // try to write binary and keep it in compiled program binaries
-            try
-            {
-                progDevEntry.status = CL_BUILD_SUCCESS;
-                Array<cxbyte> output;
-                assembler.writeBinary(output);
-                compiledProgBins[i] = RefPtr<CLProgBinEntry>(
-                            new CLProgBinEntry(std::move(output)));
-            }
-            catch(const Exception& ex)
-            {
-                // if exception during writing binary
-                compiledProgBins[i].reset();
-                msgString.append(ex.what());
-                progDevEntry.log = RefPtr<CLProgLogEntry>(
-                            new CLProgLogEntry(std::move(msgString)));
-                progDevEntry.status = CL_BUILD_ERROR;
-                asmFailure = true;
-            }
-        }
-        else // error
-        {
-            progDevEntry.status = CL_BUILD_ERROR;
-            asmFailure = true;
-        }
+        devJobIndices[i] = asmJobs.size();
+        CLAsmDeviceJob asmJob;
+        asmJob.devType = GPUDeviceType(devType);
+        asmJob.is64Bit = (addressBits==64);
+        asmJobs.push_back(std::move(asmJob));
+    }
+    
+    /* assemble for all device types concurrently
+     * (number of threads is limited by number of hardware threads) */
+    std::string cacheDir = parseEnvVariable<std::string>("CLRX_WRAPPER_CACHE_DIR", "");
+    if (!cacheDir.empty())
+        // hashes of included files will be stored in cache entries
+        asmFlags |= ASM_FILEHASHES;
+    const CLAsmCommonOptions asmOptions = { asmFlags, useCL20Std, useCL2StdForGCN11,
+                havePolicy, policyVersion, driverVersion, includePaths, defSyms,
+                std::move(cacheDir) };
+    runParallelJobs(asmJobs.size(), 0, [&asmJobs, &asmOptions, &sourceCode,
+                sourceCodeSize](size_t i)
+    {
+        clrxAssembleForDevice(sourceCodeSize-1, sourceCode.get(), asmOptions,
+                    asmJobs[i]);
+    });
+    
+    /* merge results in device order */
+    std::unique_ptr<CLAsmDeviceJob[]> devResults(new CLAsmDeviceJob[devicesNum]);
+    clrxMergeAsmJobResults(devicesNum, devJobIndices.get(), asmJobs, devResults.get(),
+                asmFailure, asmNotAvailable);
+    for (cxuint i = 0; i < devicesNum; i++)
+    {
+        ProgDeviceEntry& progDevEntry = progDeviceEntries[i];
+        progDevEntry.log = devResults[i].log;
+        progDevEntry.status = devResults[i].good ? CL_BUILD_SUCCESS : CL_BUILD_ERROR;
+        compiledProgBins[i] = devResults[i].progBin;
     }
     /* set program binaries in order of original devices list */
     std::unique_ptr<size_t[]> programBinSizes(new size_t[devicesNum]);
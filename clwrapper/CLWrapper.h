@@ -139,6 +139,7 @@ extern CL_API_ENTRY cl_int CL_API_CALL clEnqueueMakeBuffersResidentAMD(
 #include <map>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/Containers.h>
+#include "CLAsmJobs.h"
 
 struct CLRXExtensionEntry
 {
@@ -263,15 +264,6 @@ typedef std::map<cl_device_id, cl_device_id> CLRXProgramDevicesMap;
 
 typedef CLRX::Array<std::pair<CLRX::CString, std::vector<bool> > > CLRXKernelArgFlagMap;
 
-struct CLRX_INTERNAL CLProgLogEntry: public CLRX::FastRefCountable
-{
-    std::string log;
-    CLProgLogEntry() { }
-    CLProgLogEntry(const std::string& _log) : log(_log) { }
-    CLProgLogEntry(std::string&& _log) noexcept
-            : log(std::move(_log)) { }
-};
-
 struct CLRX_INTERNAL ProgDeviceEntry
 {
     CLRX::RefPtr<CLProgLogEntry> log;
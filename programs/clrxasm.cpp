@@ -21,7 +21,12 @@
 #include <iostream>
 #include <memory>
 #include <fstream>
+#include <sstream>
+#include <cstdio>
 #include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/CLIParser.h>
 #include <CLRX/amdbin/AmdBinaries.h>
@@ -64,6 +69,14 @@ static const CLIOption programOptions[] =
     { "policy", 0, CLIArgType::UINT, false, false,
         "set policy version", "VERSION" },
     { "noWarnings", 'w', CLIArgType::NONE, false, false, "disable warnings", nullptr },
+    { "stats", 0, CLIArgType::NONE, false, false,
+        "print assembler statistics (phase times, counters)", nullptr },
+    { "checkWaits", 0, CLIArgType::NONE, false, false,
+        "warn about missing and too broad waits for delayed results", nullptr },
+    { "batch", 0, CLIArgType::STRING, false, false,
+        "assemble jobs from manifest file (options and inputs per line)", "FILE" },
+    { "jobs", 'j', CLIArgType::UINT, false, false,
+        "set number of parallel jobs in batch mode", "JOBS" },
     CLRX_CLI_AUTOHELP
     { nullptr, 0 }
 };
@@ -79,14 +92,43 @@ static bool verifySymbolName(const CString& symbolName)
     return *c==0;
 }
 
-int main(int argc, const char** argv)
-try
+// print assembler statistics to error stream
+static void printStats(const AsmStats& stats, std::ostream& msgStream)
+{
+#ifdef HAVE_ASM_STATS
+    msgStream << "Assembler statistics:\n";
+    uint64_t totalTime = 0;
+    for (cxuint i = 0; i < ASM_PHASES_NUM; i++)
+        totalTime += stats.phaseTimes[i];
+    char buf[100];
+    for (cxuint i = 0; i < ASM_PHASES_NUM; i++)
+    {
+        snprintf(buf, sizeof buf, "  %-20s %12.3f ms %6.2f%%\n",
+                 getAsmPhaseName(AsmPhase(i)), stats.phaseTimes[i]*1e-6,
+                 totalTime!=0 ? 100.0*stats.phaseTimes[i]/totalTime : 0.0);
+        msgStream << buf;
+    }
+    snprintf(buf, sizeof buf, "  %-20s %12.3f ms\n", "total", totalTime*1e-6);
+    msgStream << buf;
+    msgStream <<
+        "  Lines: " << stats.linesNum << "\n"
+        "  Macro expansions: " << stats.macroExpansions << "\n"
+        "  Repetitions: " << stats.repetitionsNum << "\n"
+        "  Symbols: " << stats.symbolsNum << "\n"
+        "  Relocations: " << stats.relocationsNum << "\n"
+        "  Unevaluated expressions: " << stats.unevalExpressionsNum << "\n"
+        "  Allocated expressions: " << stats.exprAllocsNum << "\n"
+        "  Allocated input filters: " << stats.inputFilterAllocsNum << std::endl;
+#else
+    msgStream << "Assembler statistics are not available "
+            "(disabled at compilation)" << std::endl;
+#endif
+}
+
+// assemble source by options from command line, returns exit code
+static int assembleByOptions(const CLIParser& cli, std::ostream& msgStream,
+            std::ostream& printStream, bool batchJob)
 {
-    CLIParser cli("clrxasm", programOptions, argc, argv);
-    cli.parse();
-    if (cli.handleHelpOrUsage())
-        return 0;
-    
     int ret = 0;
     bool is64Bit = false;
     BinaryFormat binFormat = BinaryFormat::AMD;
@@ -139,6 +181,14 @@ try
         flags |= ASM_OLDMODPARAM;
     if (cli.hasLongOption("newROCmBinFormat"))
         newROCmBinFormat = true;
+    if (cli.hasLongOption("checkWaits"))
+        flags |= ASM_CHECKWAITS;
+    if (batchJob)
+        // jobs share filtered included files (for example macro libraries)
+        flags |= ASM_INCLUDECACHE;
+    const bool printStatistics = cli.hasLongOption("stats");
+    if (printStatistics)
+        flags |= ASM_STATS;
     if (cli.hasLongOption("policy"))
     {
         policyVersion = cli.getLongOptArg<cxuint>("policy");
@@ -150,11 +200,18 @@ try
     for (cxuint i = 0; i < argsNum; i++)
         filenames[i] = cli.getArgs()[i];
     
+    if (batchJob && filenames.empty())
+        throw Exception("No input files for job");
+    if (batchJob && !cli.hasShortOption('o'))
+        throw Exception("No output file for job");
+    
     std::unique_ptr<Assembler> assembler;
     if (!filenames.empty())
-        assembler.reset(new Assembler(filenames, flags, binFormat, deviceType));
+        assembler.reset(new Assembler(filenames, flags, binFormat, deviceType,
+                    msgStream, printStream));
     else // if from stdin
-        assembler.reset(new Assembler(nullptr, std::cin, flags, binFormat, deviceType));
+        assembler.reset(new Assembler(nullptr, std::cin, flags, binFormat, deviceType,
+                    msgStream, printStream));
     assembler->set64Bit(is64Bit);
     assembler->setDriverVersion(driverVersion);
     assembler->setLLVMVersion(llvmVersion);
@@ -190,7 +247,7 @@ try
             { value = cstrtovCStyle<uint64_t>(eqPlace, nullptr, outEnd); }
             catch(const ParseException& ex)
             {
-                std::cerr << "For symbol '" << symName << "': " << ex.what() << std::endl;
+                msgStream << "For symbol '" << symName << "': " << ex.what() << std::endl;
                 ret = 1;
                 parsed = false;
             }
@@ -201,7 +258,7 @@ try
                 while (isSpace(*outEnd)) outEnd++;
                 if (*outEnd!=0)
                 {
-                    std::cerr << "Garbages at symbol '" << symName <<
+                    msgStream << "Garbages at symbol '" << symName <<
                                     "' value" << std::endl;
                     ret = 1;
                 }
@@ -213,7 +270,7 @@ try
             assembler->addInitialDefSym(symName, value);
         else
         {
-            std::cerr << "Invalid symbol name '" << symName << "'" << std::endl;
+            msgStream << "Invalid symbol name '" << symName << "'" << std::endl;
             ret = 1;
         }
     }
@@ -222,14 +279,178 @@ try
         return ret;
     /// run assembling
     if (!assembler->assemble())
+    {
+        if (printStatistics)
+            printStats(assembler->getStats(), msgStream);
         return 1;
+    }
     /// write output to file
     const char* outputName = "a.out";
     if (cli.hasShortOption('o'))
         outputName = cli.getShortOptArg<const char*>('o');
     assembler->writeBinary(outputName);
+    if (printStatistics)
+        printStats(assembler->getStats(), msgStream);
     return 0;
 }
+
+/*
+ * batch mode
+ */
+
+struct BatchJob
+{
+    size_t lineNo;  // line in manifest
+    std::vector<std::string> args;
+    int ret;
+    std::string messages;   // warnings and errors
+    std::string printed;    // output from .print pseudo-ops
+};
+
+// split manifest line to arguments (arguments can be quoted by '"')
+static bool splitManifestLine(const std::string& line, std::vector<std::string>& args)
+{
+    size_t pos = 0;
+    while (true)
+    {
+        while (pos < line.size() && isSpace(line[pos])) pos++;
+        if (pos == line.size())
+            return true;
+        std::string arg;
+        while (pos < line.size() && !isSpace(line[pos]))
+        {
+            if (line[pos] == '"')
+            {
+                // quoted part of argument
+                for (pos++; pos < line.size() && line[pos] != '"'; pos++)
+                {
+                    if (line[pos] == '\\' && pos+1 < line.size() &&
+                        (line[pos+1] == '"' || line[pos+1] == '\\'))
+                        pos++;
+                    arg.push_back(line[pos]);
+                }
+                if (pos == line.size())
+                    return false; // unterminated
+                pos++;
+            }
+            else
+                arg.push_back(line[pos++]);
+        }
+        args.push_back(arg);
+    }
+}
+
+static void runBatchJob(BatchJob& job)
+{
+    std::ostringstream msgStream;
+    std::ostringstream printStream;
+    try
+    {
+        std::vector<const char*> argv;
+        argv.push_back("clrxasm");
+        for (const std::string& arg: job.args)
+            argv.push_back(arg.c_str());
+        argv.push_back(nullptr);
+        CLIParser cli("clrxasm", programOptions, argv.size()-1, argv.data());
+        cli.parse();
+        if (cli.hasLongOption("batch") || cli.hasShortOption('j'))
+            throw Exception("Batch options are not allowed in job");
+        job.ret = assembleByOptions(cli, msgStream, printStream, true);
+    }
+    catch(const Exception& ex)
+    {
+        msgStream << ex.what() << std::endl;
+        job.ret = 1;
+    }
+    catch(const std::bad_alloc& ex)
+    {
+        msgStream << "Out of memory" << std::endl;
+        job.ret = 1;
+    }
+    catch(const std::exception& ex)
+    {
+        msgStream << "System exception: " << ex.what() << std::endl;
+        job.ret = 1;
+    }
+    if (job.ret != 0)
+        msgStream << "Job at manifest line " << job.lineNo << " failed" << std::endl;
+    job.messages = msgStream.str();
+    job.printed = printStream.str();
+}
+
+/* run jobs from manifest in parallel. messages of the jobs are printed
+ * in manifest order, just after finishing all preceding jobs */
+static int runBatch(const char* manifestName, cxuint threadsNum)
+{
+    std::ifstream manifestFile;
+    std::istream* manifest = &std::cin;
+    if (::strcmp(manifestName, "-") != 0)
+    {
+        manifestFile.open(manifestName);
+        if (!manifestFile)
+            throw Exception(std::string("Can't open manifest file '") +
+                        manifestName + "'");
+        manifest = &manifestFile;
+    }
+    std::vector<BatchJob> jobs;
+    std::string line;
+    for (size_t lineNo = 1; std::getline(*manifest, line); lineNo++)
+    {
+        BatchJob job{ lineNo, { }, 0, "", "" };
+        if (!splitManifestLine(line, job.args))
+            throw Exception(std::string("Unterminated quote in manifest line ") +
+                        std::to_string(lineNo));
+        // skip empty lines and comments
+        if (job.args.empty() || job.args[0][0] == '#')
+            continue;
+        jobs.push_back(std::move(job));
+    }
+    
+    std::mutex printMutex;
+    std::vector<bool> jobsDone(jobs.size(), false);
+    size_t nextJobToPrint = 0;
+    runParallelJobs(jobs.size(), threadsNum, [&](size_t i)
+    {
+        runBatchJob(jobs[i]);
+        std::lock_guard<std::mutex> lock(printMutex);
+        jobsDone[i] = true;
+        for (; nextJobToPrint < jobs.size() && jobsDone[nextJobToPrint];
+                    nextJobToPrint++)
+        {
+            BatchJob& job = jobs[nextJobToPrint];
+            std::cout << job.printed << std::flush;
+            std::cerr << job.messages << std::flush;
+            job.printed.clear();
+            job.messages.clear();
+        }
+    });
+    
+    int ret = 0;
+    for (const BatchJob& job: jobs)
+        if (job.ret != 0)
+            ret = 1;
+    return ret;
+}
+
+int main(int argc, const char** argv)
+try
+{
+    CLIParser cli("clrxasm", programOptions, argc, argv);
+    cli.parse();
+    if (cli.handleHelpOrUsage())
+        return 0;
+    
+    if (cli.hasLongOption("batch"))
+    {
+        if (cli.getArgsNum() != 0)
+            throw Exception("Input files can not be given in batch mode");
+        cxuint threadsNum = 0; // number of hardware threads
+        if (cli.hasShortOption('j'))
+            threadsNum = cli.getShortOptArg<cxuint>('j');
+        return runBatch(cli.getLongOptArg<const char*>("batch"), threadsNum);
+    }
+    return assembleByOptions(cli, std::cerr, std::cout, false);
+}
 catch(const Exception& ex)
 {
     std::cerr << ex.what() << std::endl;
@@ -57,6 +57,8 @@ static const CLIOption programOptions[] =
         "set LLVM version (for Gallium)", "VERSION" },
     { "buggyFPLit", 0, CLIArgType::NONE, false, false,
         "use old and buggy fplit rules", nullptr },
+    { "jobs", 'j', CLIArgType::UINT, false, false,
+        "disassemble kernel codes in N threads (0 - all threads)", "N" },
     CLRX_CLI_AUTOHELP
     { nullptr, 0 }
 };
@@ -90,6 +92,18 @@ try
              (cli.hasShortOption('H')?DISASM_HSACONFIG:0) |
              (cli.hasShortOption('L')?DISASM_HSALAYOUT:0);
     
+    cxuint threadsNum = 1;
+    if (cli.hasShortOption('j'))
+        threadsNum = cli.getShortOptArg<cxuint>('j');
+    if (threadsNum != 1)
+        disasmFlags |= DISASM_PARALLEL;
+    // set threads number and disassemble
+    auto runDisassembler = [threadsNum](Disassembler& disasm)
+    {
+        disasm.setThreadsNum(threadsNum);
+        disasm.disassemble();
+    };
+    
     GPUDeviceType gpuDeviceType = GPUDeviceType::CAPE_VERDE;
     const bool fromRawCode = cli.hasShortOption('r');
     if (cli.hasShortOption('g'))
@@ -109,11 +123,12 @@ try
     for (const char* const* args = cli.getArgs();*args != nullptr; args++)
     {
         std::cout << "/* Disassembling '" << *args << "\' */" << std::endl;
-        Array<cxbyte> binaryData;
+        // binary is parsed in place from mapped file (without copying)
+        MappedFile binaryData;
         std::unique_ptr<AmdMainBinaryBase> base = nullptr;
         try
         {
-            binaryData = loadDataFromFile(*args);
+            binaryData.open(*args);
             
             if (!fromRawCode)
             {
@@ -138,14 +153,14 @@ try
                         AmdMainGPUBinary32* amdGpuBin =
                                 static_cast<AmdMainGPUBinary32*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags);
-                        disasm.disassemble();
+                        runDisassembler(disasm);
                     }
                     else if (base->getType() == AmdMainType::GPU_64_BINARY)
                     {
                         AmdMainGPUBinary64* amdGpuBin =
                                 static_cast<AmdMainGPUBinary64*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags);
-                        disasm.disassemble();
+                        runDisassembler(disasm);
                     }
                     else
                         throw Exception("This is not AMDGPU binary file!");
@@ -164,7 +179,7 @@ try
                                 static_cast<AmdCL2MainGPUBinary32*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags,
                                             driverVersion);
-                        disasm.disassemble();
+                        runDisassembler(disasm);
                     }
                     else if (base->getType() == AmdMainType::GPU_CL2_64_BINARY)
                     {
@@ -172,7 +187,7 @@ try
                                 static_cast<AmdCL2MainGPUBinary64*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags,
                                             driverVersion);
-                        disasm.disassemble();
+                        runDisassembler(disasm);
                     }
                     else
                         throw Exception("This is not AMDGPU binary file!");
@@ -182,7 +197,7 @@ try
                     // ROCm binary
                     ROCmBinary rocmBin(binaryData.size(), binaryData.data(), 0);
                     Disassembler disasm(rocmBin, std::cout, disasmFlags);
-                    disasm.disassemble();
+                    runDisassembler(disasm);
                 }
                 else
                 {
@@ -190,7 +205,7 @@ try
                     GalliumBinary galliumBin(binaryData.size(),binaryData.data(), 0);
                     Disassembler disasm(gpuDeviceType, galliumBin, std::cout,
                             disasmFlags, llvmVersion);
-                    disasm.disassemble();
+                    runDisassembler(disasm);
                 }
             }
             else
@@ -198,7 +213,7 @@ try
                 /* raw binaries */
                 Disassembler disasm(gpuDeviceType, binaryData.size(), binaryData.data(),
                         std::cout, disasmFlags);
-                disasm.disassemble();
+                runDisassembler(disasm);
             }
         }
         catch(const std::exception& ex)
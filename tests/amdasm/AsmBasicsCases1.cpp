@@ -2501,5 +2501,27 @@ bb2=11)ffDXD",
         },
         true, "", ""
     },
+    /* 69 - macro substitutions between continued lines */
+    {   R"ffDXD(            .macro sub1 a,b
+            .ascii "\a\()x\b:\\:\@"
+            .byte \a+\
+            \b, \b+2*, \a
+            .endm
+            sub1 1,2
+            sub1 33,44)ffDXD",
+        BinaryFormat::AMD, GPUDeviceType::CAPE_VERDE, false, { },
+        { { nullptr, ASMKERN_GLOBAL, AsmSectionType::DATA,
+            {
+                0x31, 0x78, 0x32, 0x3a, 0x5c, 0x3a, 0x30, 0x03,
+                0x01, 0x33, 0x33, 0x78, 0x34, 0x34, 0x3a, 0x5c,
+                0x3a, 0x31, 0x4d, 0x21
+            } } },
+        { { ".", 20U, 0, 0U, true, false, false, 0, 0 } },
+        false, R"ffDXD(In macro substituted from test.s:6:13:
+test.s:4:20: Error: Unterminated expression
+In macro substituted from test.s:7:13:
+test.s:4:22: Error: Unterminated expression
+)ffDXD", ""
+    },
     { nullptr }
 };
@@ -2499,5 +2499,27 @@ aa2=6
         { }, { }, { { ".", 0, 0, 0, true, false, false, 0, 0 } }, true,
         "", "isNotGCN1.4.1\n",
     },
+    /* 91 - include same file twice */
+    {   R"ffDXD(            .include "inc4.s"
+            .include "inc4.s")ffDXD",
+        BinaryFormat::AMD, GPUDeviceType::CAPE_VERDE, false, { },
+        { { nullptr, ASMKERN_GLOBAL, AsmSectionType::DATA,
+            { 0x01, 0x02, 0x03, 0x04, 0x61, 0x20, 0x62,
+              0x01, 0x02, 0x03, 0x04, 0x61, 0x20, 0x62 } } },
+        { { ".", 14U, 0, 0U, true, false, false, 0, 0 } },
+        false, "In file included from test.s:1:13:\n"
+        CLRX_SOURCE_DIR "/tests/amdasm/incdir1/inc4.s:7:23: "
+        "Warning: Unterminated string: newline inserted\n"
+        "In file included from test.s:1:13:\n"
+        CLRX_SOURCE_DIR "/tests/amdasm/incdir1/inc4.s:6:20: "
+        "Error: Unterminated string\n"
+        "In file included from test.s:2:13:\n"
+        CLRX_SOURCE_DIR "/tests/amdasm/incdir1/inc4.s:7:23: "
+        "Warning: Unterminated string: newline inserted\n"
+        "In file included from test.s:2:13:\n"
+        CLRX_SOURCE_DIR "/tests/amdasm/incdir1/inc4.s:6:20: "
+        "Error: Unterminated string\n", "",
+        { CLRX_SOURCE_DIR "/tests/amdasm/incdir1" }
+    },
     { nullptr }
 };
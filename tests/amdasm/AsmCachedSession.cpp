@@ -0,0 +1,215 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <CLRX/Config.h>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static void writeTestFile(const char* filename, const char* content)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << content;
+}
+
+static bool equalBinaries(const Array<cxbyte>& a, const Array<cxbyte>& b)
+{ return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin()); }
+
+static void testAsmCachedSession()
+{
+    const char* testName = "testAsmCachedSession";
+    writeTestFile("AsmCachedMain.s",
+            ".rawcode\n.include \"AsmCachedInc.s\"\n.warning \"xxx\"\n");
+    writeTestFile("AsmCachedInc.s", "s_mov_b32 s1, s2\n");
+    
+    std::ostringstream msgStream;
+    AsmCachedSession session([](std::ostream& assemblerMsgStream)
+        {
+            return new Assembler(Array<CString>{ "AsmCachedMain.s" },
+                    ASM_ALL|ASM_INCLUDECACHE|ASM_FILEHASHES, BinaryFormat::RAWCODE,
+                    GPUDeviceType::CAPE_VERDE, assemblerMsgStream);
+        }, msgStream);
+    
+    const char* warning = "AsmCachedMain.s:3:1: Warning: xxx\n";
+    // first assembling
+    assertTrue(testName, "good0", session.assemble());
+    assertTrue(testName, "reused0", !session.isReused());
+    assertString(testName, "messages0", warning, msgStream.str());
+    const Array<cxbyte> binary0 = session.getBinary();
+    assertValue(testName, "binary0.size", size_t(4), binary0.size());
+    
+    // nothing changed, result and messages should be reused
+    msgStream.str("");
+    const Assembler* assembler0 = session.getAssembler();
+    assertTrue(testName, "good1", session.assemble());
+    assertTrue(testName, "reused1", session.isReused());
+    assertTrue(testName, "assembler1", assembler0 == session.getAssembler());
+    assertString(testName, "messages1", warning, msgStream.str());
+    assertTrue(testName, "binary1", equalBinaries(binary0, session.getBinary()));
+    
+    // change included file (same size)
+    writeTestFile("AsmCachedInc.s", "s_mov_b32 s3, s2\n");
+    msgStream.str("");
+    assertTrue(testName, "good2", session.assemble());
+    assertTrue(testName, "reused2", !session.isReused());
+    assertString(testName, "messages2", warning, msgStream.str());
+    const Array<cxbyte> binary2 = session.getBinary();
+    assertValue(testName, "binary2.size", size_t(4), binary2.size());
+    assertTrue(testName, "binary2", !equalBinaries(binary0, binary2));
+    
+    assertTrue(testName, "good3", session.assemble());
+    assertTrue(testName, "reused3", session.isReused());
+    
+    // change main file
+    writeTestFile("AsmCachedMain.s", ".rawcode\n.include \"AsmCachedInc.s\"\n");
+    msgStream.str("");
+    assertTrue(testName, "good4", session.assemble());
+    assertTrue(testName, "reused4", !session.isReused());
+    assertString(testName, "messages4", "", msgStream.str());
+    assertTrue(testName, "binary4", equalBinaries(binary2, session.getBinary()));
+}
+
+// include file that appears earlier in include path must not be missed
+static void testAsmCachedSessionShadowing()
+{
+    const char* testName = "testAsmCachedSessionShadowing";
+    makeDir("AsmCachedDir");
+    writeTestFile("AsmCachedMain2.s", ".rawcode\n.include \"AsmCachedShd.s\"\n");
+    writeTestFile("AsmCachedDir/AsmCachedShd.s", ".byte 1\n");
+    
+    std::ostringstream msgStream;
+    AsmCachedSession session([](std::ostream& assemblerMsgStream)
+        {
+            Assembler* assembler = new Assembler(
+                    Array<CString>{ "AsmCachedMain2.s" },
+                    ASM_ALL|ASM_INCLUDECACHE|ASM_FILEHASHES, BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, assemblerMsgStream);
+            assembler->addIncludeDir("AsmCachedDir");
+            return assembler;
+        }, msgStream);
+    
+    assertTrue(testName, "good0", session.assemble());
+    assertTrue(testName, "reused0", !session.isReused());
+    assertArray<cxbyte>(testName, "binary0", Array<cxbyte>{ 1 }, session.getBinary());
+    assertTrue(testName, "good1", session.assemble());
+    assertTrue(testName, "reused1", session.isReused());
+    
+    // new file in current directory shadows file from include directory
+    writeTestFile("AsmCachedShd.s", ".byte 2\n");
+    assertTrue(testName, "good2", session.assemble());
+    assertTrue(testName, "reused2", !session.isReused());
+    assertArray<cxbyte>(testName, "binary2", Array<cxbyte>{ 2 }, session.getBinary());
+    assertString(testName, "messages", "", msgStream.str());
+}
+
+static std::pair<uint64_t, uint64_t> stringHash(const char* content)
+{ return calculateHash128(::strlen(content), content); }
+
+// hashes of content of read files (with and without include cache)
+static void testAsmFileHashes()
+{
+    const char* testName = "testAsmFileHashes";
+    const char* mainContent = ".rawcode\n.include \"AsmCachedInc3.s\"\n"
+            ".incbin \"AsmCachedBin.bin\", 1, 2\n";
+    const char* incContent = ".byte 7 # comment\n";
+    const char* binContent = "abcd";
+    writeTestFile("AsmCachedMain3.s", mainContent);
+    writeTestFile("AsmCachedInc3.s", incContent);
+    writeTestFile("AsmCachedBin.bin", binContent);
+    for (cxuint i = 0; i < 3; i++)
+    {
+        // second and third run with include cache (third gets cached files)
+        std::ostringstream msgStream;
+        Assembler assembler(Array<CString>{ "AsmCachedMain3.s" },
+                ASM_ALL|ASM_FILEHASHES|(i != 0 ? ASM_INCLUDECACHE : 0),
+                BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, msgStream);
+        assertTrue(testName, "good", assembler.assemble());
+        assertArray<cxbyte>(testName, "content", Array<cxbyte>{ 7, 'b', 'c' },
+                    assembler.getSections()[0].content);
+        assertValue(testName, "sourceHashesNum", size_t(1),
+                    assembler.getSourceFileHashes().size());
+        assertTrue(testName, "sourceHash", stringHash(mainContent) ==
+                    assembler.getSourceFileHashes()[0]);
+        assertValue(testName, "depHashesNum", size_t(2),
+                    assembler.getDependencyFileHashes().size());
+        assertTrue(testName, "incHash", stringHash(incContent) ==
+                    assembler.getDependencyFileHashes()[0]);
+        assertTrue(testName, "binHash", stringHash(binContent) ==
+                    assembler.getDependencyFileHashes()[1]);
+    }
+    
+    // session requires hashes of sources
+    std::ostringstream msgStream;
+    AsmCachedSession session([](std::ostream& assemblerMsgStream)
+        {
+            return new Assembler(Array<CString>{ "AsmCachedMain3.s" }, ASM_ALL,
+                    BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, assemblerMsgStream);
+        }, msgStream);
+    bool thrown = false;
+    try
+    { session.assemble(); }
+    catch(const AsmException& ex)
+    { thrown = true; }
+    assertTrue(testName, "noFileHashes", thrown);
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    try
+    { testAsmCachedSession(); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    try
+    { testAsmCachedSessionShadowing(); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    try
+    { testAsmFileHashes(); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    std::remove("AsmCachedMain.s");
+    std::remove("AsmCachedInc.s");
+    std::remove("AsmCachedMain2.s");
+    std::remove("AsmCachedShd.s");
+    std::remove("AsmCachedDir/AsmCachedShd.s");
+    std::remove("AsmCachedDir");
+    std::remove("AsmCachedMain3.s");
+    std::remove("AsmCachedInc3.s");
+    std::remove("AsmCachedBin.bin");
+    return retVal;
+}
@@ -2964,6 +2964,15 @@ static void checkVIdxSetEntries(const std::string& testCaseName, const char* vva
     }
 }
 
+static bool livenessesOverlap(const OutLiveness& lv1, const OutLiveness& lv2)
+{
+    for (const std::pair<size_t, size_t>& blk1: lv1)
+        for (const std::pair<size_t, size_t>& blk2: lv2)
+            if (blk1.first < blk2.second && blk2.first < blk1.second)
+                return true;
+    return false;
+}
+
 static void testCreateLivenessesCase(cxuint i, const AsmLivenessesCase& testCase)
 {
     std::cout << "-----------------------------------------------\n"
@@ -3138,6 +3147,31 @@ static void testCreateLivenessesCase(cxuint i, const AsmLivenessesCase& testCase
     // checking vidxCallMap
     checkVIdxSetEntries(testCaseName, "vidxCallMap", testCase.vidxCallMap,
                 regAlloc.getVIdxCallMap(), revLvIndexCvtTables);
+    
+    // checking linear scan (every variable must have register and
+    // variables with overlapping livenesses must have different registers)
+    regAlloc.linearScanRegisters();
+    const Array<cxuint>* resColorMaps = regAlloc.getGraphColorMaps();
+    for (size_t r = 0; r < MAX_REGTYPES_NUM; r++)
+        for (size_t li = 0; li < resColorMaps[r].size(); li++)
+        {
+            std::ostringstream lOss;
+            lOss << "lscan.regtype#" << r << ".color#" << revLvIndexCvtTables[r][li];
+            assertTrue("testAsmLivenesses", testCaseName + lOss.str(),
+                        resColorMaps[r][li] != UINT_MAX);
+        }
+    for (size_t r = 0; r < MAX_REGTYPES_NUM; r++)
+        for (size_t li = 0; li < resLivenesses[r].size(); li++)
+            for (size_t li2 = li+1; li2 < resLivenesses[r].size(); li2++)
+                if (livenessesOverlap(resLivenesses[r][li], resLivenesses[r][li2]))
+                {
+                    std::ostringstream lOss;
+                    lOss << "lscan.regtype#" << r << ".colors#" <<
+                            revLvIndexCvtTables[r][li] << "," << revLvIndexCvtTables[r][li2];
+                    assertTrue("testAsmLivenesses", testCaseName + lOss.str(),
+                        resColorMaps[r][li] != UINT_MAX &&
+                        resColorMaps[r][li] != resColorMaps[r][li2]);
+                }
 }
 
 int main(int argc, const char** argv)
@@ -0,0 +1,122 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+struct AsmStatsTestCase
+{
+    const char* input;
+    uint64_t linesNum;
+    uint64_t macroExpansions;
+    uint64_t repetitionsNum;
+    uint64_t symbolsNum;
+    uint64_t unevalExpressionsNum;
+    uint64_t inputFilterAllocsNum;
+};
+
+static const AsmStatsTestCase asmStatsTestCases[] =
+{
+    {   /* 0 - simple code */
+        R"ffDXD(.rawcode
+        s_mov_b32 s1, s2
+        s_add_u32 s1, s2, 10
+)ffDXD", 3, 0, 0, 1, 0, 1 },
+    {   /* 1 - macros and repetitions */
+        R"ffDXD(.rawcode
+lab0:   .macro foo x
+            s_mov_b32 s\x, \x
+        .endm
+        .rept 3
+        foo 4
+        .endr
+        .irp r, 1, 2
+        s_mov_b32 s\r, lab1-lab0
+        .endr
+lab1:   s_endpgm
+)ffDXD", 19, 3, 2, 3, 2, 6 },
+    {   /* 2 - scopes and symbols */
+        R"ffDXD(.rawcode
+        .scope ala
+        x = 10
+        y = 11
+        .ends
+        z = 2
+        s_endpgm
+)ffDXD", 7, 0, 0, 4, 0, 1 }
+};
+
+static void testAsmStats(cxuint testId, const AsmStatsTestCase& testCase)
+{
+    std::istringstream input(testCase.input);
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_STATS, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    std::ostringstream oss;
+    oss << "testAsmStats#" << testId;
+    const std::string testCaseName = oss.str();
+    bool good = assembler.assemble();
+    if (!good)
+        std::cerr << errorStream.str();
+    assertTrue(testCaseName, "good", good);
+    Array<cxbyte> output;
+    assembler.writeBinary(output);
+    
+    const AsmStats& stats = assembler.getStats();
+#ifdef HAVE_ASM_STATS
+    assertValue(testCaseName, "linesNum", testCase.linesNum, stats.linesNum);
+    assertValue(testCaseName, "macroExpansions", testCase.macroExpansions,
+                stats.macroExpansions);
+    assertValue(testCaseName, "repetitionsNum", testCase.repetitionsNum,
+                stats.repetitionsNum);
+    assertValue(testCaseName, "symbolsNum", testCase.symbolsNum, stats.symbolsNum);
+    assertValue(testCaseName, "relocationsNum", uint64_t(0), stats.relocationsNum);
+    assertValue(testCaseName, "unevalExpressionsNum", testCase.unevalExpressionsNum,
+                stats.unevalExpressionsNum);
+    assertValue(testCaseName, "inputFilterAllocsNum", testCase.inputFilterAllocsNum,
+                stats.inputFilterAllocsNum);
+    assertTrue(testCaseName, "phaseTimes[INSTRUCTION]!=0",
+                stats.phaseTimes[cxuint(AsmPhase::INSTRUCTION)] != 0);
+    assertValue(testCaseName, "phaseTimes[REG_ALLOC]", uint64_t(0),
+                stats.phaseTimes[cxuint(AsmPhase::REG_ALLOC)]);
+#else
+    assertValue(testCaseName, "linesNum", uint64_t(0), stats.linesNum);
+#endif
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (cxuint i = 0; i < sizeof(asmStatsTestCases)/sizeof(AsmStatsTestCase); i++)
+        try
+        { testAsmStats(i, asmStatsTestCases[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    return retVal;
+}
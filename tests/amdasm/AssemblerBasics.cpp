@@ -20,6 +20,7 @@
 #include <CLRX/Config.h>
 #include <iostream>
 #include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <memory>
 #include <CLRX/utils/Containers.h>
@@ -49,7 +50,8 @@ static void pushSymbolsFromScopes(const AsmScope& scope,
     }
 }
 
-static void testAssembler(cxuint testSuiteId, cxuint testId, const AsmTestCase& testCase)
+static void testAssembler(cxuint testSuiteId, cxuint testId, const AsmTestCase& testCase,
+            Flags extraFlags = 0)
 {
     std::istringstream input(testCase.input);
     std::ostringstream errorStream;
@@ -57,7 +59,7 @@ static void testAssembler(cxuint testSuiteId, cxuint testId, const AsmTestCase&
     
     // create assembler with testcase input
     // enable ASM_TESTRUN (needed while testing)
-    Assembler assembler("test.s", input, (ASM_ALL|ASM_TESTRUN)&~ASM_ALTMACRO,
+    Assembler assembler("test.s", input, ((ASM_ALL|ASM_TESTRUN)&~ASM_ALTMACRO) | extraFlags,
             BinaryFormat::AMD, GPUDeviceType::CAPE_VERDE, errorStream, printStream);
     // include include dirs from testcase
     for (const char* incDir: testCase.includeDirs)
@@ -173,5 +175,15 @@ int main(int argc, const char** argv)
             std::cerr << ex.what() << std::endl;
             retVal = 1;
         }
+    // include testcases with include cache (included files are cached by previous runs)
+    for (size_t i = 0; asmTestCases2Tbl[i].input != nullptr; i++)
+        if (::strstr(asmTestCases2Tbl[i].input, ".include") != nullptr)
+            try
+            { testAssembler(2, i, asmTestCases2Tbl[i], ASM_INCLUDECACHE); }
+            catch(const std::exception& ex)
+            {
+                std::cerr << ex.what() << std::endl;
+                retVal = 1;
+            }
     return retVal;
 }
@@ -1995,7 +1995,8 @@ data2:
     },
 };
 
-static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
+static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase,
+            bool parallel)
 {
     std::ostringstream disasmOss;
     std::string resultStr;
@@ -2004,6 +2005,14 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
         disasmFlags |= DISASM_CONFIG;
     if (testCase.hsaConfig)
         disasmFlags |= DISASM_HSACONFIG;
+    if (parallel)
+        disasmFlags |= DISASM_PARALLEL;
+    // output must be same in parallel mode
+    auto runDisassembler = [](Disassembler& disasm)
+    {
+        disasm.setThreadsNum(4);
+        disasm.disassemble();
+    };
     
     bool haveException = false;
     std::string resExceptionStr;
@@ -2015,13 +2024,13 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
         if (testCase.amdInput != nullptr)
         {
             Disassembler disasm(testCase.amdInput, disasmOss, disasmFlags);
-            disasm.disassemble();
+            runDisassembler(disasm);
             resultStr = disasmOss.str();
         }
         else if (testCase.galliumInput != nullptr)
         {
             Disassembler disasm(testCase.galliumInput, disasmOss, disasmFlags);
-            disasm.disassemble();
+            runDisassembler(disasm);
             resultStr = disasmOss.str();
         }
     }
@@ -2040,7 +2049,7 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
                     AMDBIN_CREATE_INFOSTRINGS));
             AmdMainGPUBinary32* amdGpuBin = static_cast<AmdMainGPUBinary32*>(base.get());
             Disassembler disasm(*amdGpuBin, disasmOss, disasmFlags);
-            disasm.disassemble();
+            runDisassembler(disasm);
             resultStr = disasmOss.str();
         }
         else if (isAmdCL2Binary(binaryData.size(), binaryData.data()))
@@ -2053,7 +2062,7 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
                 AMDBIN_CREATE_INFOSTRINGS | AMDCL2BIN_INNER_CREATE_KERNELDATA |
                 AMDCL2BIN_INNER_CREATE_KERNELDATAMAP | AMDCL2BIN_INNER_CREATE_KERNELSTUBS);
             Disassembler disasm(amdBin, disasmOss, disasmFlags);
-            disasm.disassemble();
+            runDisassembler(disasm);
             resultStr = disasmOss.str();
         }
         else if (isROCmBinary(binaryData.size(), binaryData.data()))
@@ -2061,7 +2070,7 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
             // if ROCm (HSACO) binary
             ROCmBinary rocmBin(binaryData.size(), binaryData.data(), 0);
             Disassembler disasm(rocmBin, disasmOss, disasmFlags);
-            disasm.disassemble();
+            runDisassembler(disasm);
             resultStr = disasmOss.str();
         }
         else
@@ -2069,7 +2078,7 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
             GalliumBinary galliumBin(binaryData.size(),binaryData.data(), 0);
             Disassembler disasm(GPUDeviceType::CAPE_VERDE, galliumBin,
                             disasmOss, disasmFlags, testCase.llvmVersion);
-            disasm.disassemble();
+            runDisassembler(disasm);
             resultStr = disasmOss.str();
         }
     }
@@ -2083,7 +2092,7 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
     std::string caseName;
     {
         std::ostringstream oss;
-        oss << "DisasmCase#" << testId;
+        oss << "DisasmCase#" << testId << (parallel ? "Parallel" : "");
         oss.flush();
         caseName = oss.str();
     }
@@ -2102,7 +2111,7 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
     {
         // print error
         std::ostringstream oss;
-        oss << "Failed for #" << testId << std::endl;
+        oss << "Failed for #" << testId << (parallel ? " (parallel)" : "") << std::endl;
         oss << resultStr << std::endl;
         oss.flush();
         throw Exception(oss.str());
@@ -2113,12 +2122,13 @@ int main(int argc, const char** argv)
 {
     int retVal = 0;
     for (cxuint i = 0; i < sizeof(disasmDataTestCases)/sizeof(DisasmAmdTestCase); i++)
-        try
-        { testDisasmData(i, disasmDataTestCases[i]); }
-        catch(const std::exception& ex)
-        {
-            std::cerr << ex.what() << std::endl;
-            retVal = 1;
-        }
+        for (bool parallel: { false, true })
+            try
+            { testDisasmData(i, disasmDataTestCases[i], parallel); }
+            catch(const std::exception& ex)
+            {
+                std::cerr << ex.what() << std::endl;
+                retVal = 1;
+            }
     return retVal;
 }
@@ -340,6 +340,37 @@ static void testDecGCNNamedLabels()
         throw Exception("FAILED namedLabelsTest: result: "+disOss.str());
 }
 
+// testing disassemblying same buffer with changed content
+static void testDecGCNChangedInput()
+{
+    std::ostringstream disOss;
+    AmdDisasmInput input;
+    input.deviceType = GPUDeviceType::PITCAIRN;
+    input.is64BitMode = false;
+    Disassembler disasm(&input, disOss, DISASM_FLOATLITS);
+    GCNDisassembler gcnDisasm(disasm);
+    uint32_t code[3] = { LEV(0xbf820001U), LEV(0xb1abd3b9U), LEV(0xbf82fffeU) };
+    gcnDisasm.setInput(sizeof(code), reinterpret_cast<const cxbyte*>(code));
+    gcnDisasm.beforeDisassemble();
+    gcnDisasm.disassemble();
+    // content changed, analyze and disassemble again
+    code[1] = LEV(0x81953d04U);
+    gcnDisasm.beforeDisassemble();
+    gcnDisasm.disassemble();
+    // content changed, input set again (labels from previous analysis)
+    code[1] = LEV(0xbed60414U);
+    gcnDisasm.setInput(sizeof(code), reinterpret_cast<const cxbyte*>(code));
+    gcnDisasm.disassemble();
+    if (disOss.str() !=
+        "        s_branch        .L8_0\n.L4_0:\n        s_cmpk_eq_i32   s43, 0xd3b9\n"
+        ".L8_0:\n        s_branch        .L4_0\n"
+        "        s_branch        .L8_0\n.L4_0:\n        s_sub_i32       s21, s4, s61\n"
+        ".L8_0:\n        s_branch        .L4_0\n"
+        "        s_branch        .L8_0\n.L4_0:\n        s_mov_b64       s[86:87], s[20:21]\n"
+        ".L8_0:\n        s_branch        .L4_0\n")
+        throw Exception("FAILED changedInputTest: result: "+disOss.str());
+}
+
 static const uint32_t relocationCode[] =
 {
     LEV(0x0934d6ffU), LEV(0x11110000U),
@@ -499,6 +530,7 @@ int main(int argc, const char** argv)
     try
     {
         testDecGCNNamedLabels();
+        testDecGCNChangedInput();
         testDecGCNRelocations();
     }
     catch(const std::exception& ex)
@@ -2143,6 +2143,45 @@ static void testGCNRegVarUsages(cxuint i, const GCNRegVarUsageCase& testCase)
     }
     assertTrue("testGCNRegVarUsages", testCaseName+".length",
                    j == testCase.regVarUsages.size());
+    
+    // check usage arrays (must be same as usages from handler)
+    ISAUsageArrays usageArrays;
+    usageArrays.assign(*usageHandler);
+    assertValue("testGCNRegVarUsages", testCaseName+".arrays.length",
+                testCase.regVarUsages.size(), usageArrays.getUsagesNum());
+    assertValue("testGCNRegVarUsages", testCaseName+".arrays.instrsNum",
+                usageHandler->getInstrsNum(), usageArrays.getInstrsNum());
+    usageHandler->rewind();
+    size_t instrIndex = 0;
+    for (j = 0; j < usageArrays.getUsagesNum(); j++)
+    {
+        if (j == usageArrays.instrUsageStarts[instrIndex+1])
+            instrIndex++;
+        const AsmRegVarUsage expectedRvu = usageHandler->nextUsage();
+        const AsmRegVarUsage resultRvu = usageArrays.getUsage(instrIndex, j);
+        std::ostringstream rvuOss;
+        rvuOss << ".arrays.regVarUsage#" << j << ".";
+        rvuOss.flush();
+        std::string rvuName(rvuOss.str());
+        assertValue("testGCNRegVarUsages", testCaseName+rvuName+"offset",
+                    expectedRvu.offset, resultRvu.offset);
+        assertTrue("testGCNRegVarUsages", testCaseName+rvuName+"regVar",
+                    expectedRvu.regVar==resultRvu.regVar);
+        assertValue("testGCNRegVarUsages", testCaseName+rvuName+"rstart",
+                    expectedRvu.rstart, resultRvu.rstart);
+        assertValue("testGCNRegVarUsages", testCaseName+rvuName+"rend",
+                    expectedRvu.rend, resultRvu.rend);
+        assertValue("testGCNRegVarUsages", testCaseName+rvuName+"regField",
+                    cxuint(expectedRvu.regField), cxuint(resultRvu.regField));
+        assertValue("testGCNRegVarUsages", testCaseName+rvuName+"rwFlags",
+                    cxuint(expectedRvu.rwFlags), cxuint(resultRvu.rwFlags));
+        assertValue("testGCNRegVarUsages", testCaseName+rvuName+"align",
+                    cxuint(expectedRvu.align), cxuint(resultRvu.align));
+        assertValue<bool>("testGCNRegVarUsages", testCaseName+rvuName+"useRegMode",
+                    expectedRvu.useRegMode, resultRvu.useRegMode);
+        assertValue("testGCNRegVarUsages", testCaseName+rvuName+"lowerBound",
+                    instrIndex, usageArrays.lowerBound(resultRvu.offset));
+    }
 }
 
 int main(int argc, const char** argv)
@@ -1067,6 +1067,253 @@ static void testWaitHandlerCase(cxuint i, const AsmWaitHandlerCase& testCase)
                    k == testCase.delayedOps.size());
 }
 
+struct AsmWaitSchedulerCase
+{
+    const char* input;
+    Array<AsmWaitInstr> neededWaitInstrs;
+    const char* warnings;   // warnings from assembler with ASM_CHECKWAITS
+    bool checkAllocated;    // check also with allocated registers
+    Array<AsmWaitInstr> tooBroadWaitInstrs;
+};
+
+static const AsmWaitSchedulerCase waitSchedulerTestCases[] =
+{
+    {   /* 0 - SMRD result used later */
+        R"ffDXD(.regvar sa:s:8
+            s_load_dword sa[2], s[10:11], 4
+            s_mov_b32 s5, s6
+            s_mov_b32 sa[1], sa[2]
+            s_endpgm
+)ffDXD",
+        { { 8U, { 15, 0, 7, 0 } } },
+        "test.s:4:13: Warning: Missing wait for delayed results (lgkmcnt(0))\n", true
+    },
+    {   /* 1 - wait is already in code */
+        R"ffDXD(.regvar sa:s:8
+            s_load_dword sa[2], s[10:11], 4
+            s_waitcnt lgkmcnt(0)
+            s_mov_b32 sa[1], sa[2]
+            s_endpgm
+)ffDXD",
+        { }, "", true
+    },
+    {   /* 2 - ordered VMEM loads */
+        R"ffDXD(.regvar va:v:8
+            buffer_load_dword va[0], v1, s[4:7], 0 offen
+            buffer_load_dword va[1], v1, s[4:7], 0 offen
+            buffer_load_dword va[2], v1, s[4:7], 0 offen
+            v_mov_b32 va[3], va[0]
+            v_mov_b32 va[4], va[1]
+            v_mov_b32 va[5], va[2]
+            s_endpgm
+)ffDXD",
+        { { 24U, { 2, 7, 7, 0 } }, { 28U, { 1, 7, 7, 0 } }, { 32U, { 0, 7, 7, 0 } } },
+        "test.s:5:13: Warning: Missing wait for delayed results (vmcnt(2))\n"
+        "test.s:6:13: Warning: Missing wait for delayed results (vmcnt(1))\n"
+        "test.s:7:13: Warning: Missing wait for delayed results (vmcnt(0))\n", true
+    },
+    {   /* 3 - too broad wait in code, unordered SMRD with VMEM */
+        R"ffDXD(.regvar va:v:8, sa:s:8
+            buffer_load_dword va[0], v1, s[4:7], 0 offen
+            s_load_dword sa[2], s[10:11], 4
+            s_load_dword sa[3], s[10:11], 8
+            buffer_load_dword va[1], v1, s[4:7], 0 offen
+            buffer_load_dword va[2], v1, s[4:7], 0 offen
+            s_waitcnt vmcnt(1)
+            v_mov_b32 va[3], va[0]
+            v_mov_b32 va[4], va[1]
+            v_mov_b32 va[5], sa[2]
+            s_endpgm
+)ffDXD",
+        { { 44U, { 15, 0, 7, 0 } } }, nullptr, true,
+        { { 32U, { 2, 7, 7, 0 } } }
+    },
+    {   /* 4 - branches */
+        R"ffDXD(.regvar sa:s:8
+            s_load_dword sa[2], s[10:11], 4
+            s_cbranch_scc0 l1
+            s_waitcnt lgkmcnt(0)
+            s_mov_b32 sa[1], sa[2]
+            s_endpgm
+l1:         s_mov_b32 sa[3], sa[2]
+            s_endpgm
+)ffDXD",
+        { { 20U, { 15, 0, 7, 0 } } }, nullptr, true
+    },
+    {   /* 5 - loop (result used in next iteration) */
+        R"ffDXD(.regvar va:v:8
+            s_mov_b32 s0, 10
+loop:       v_mov_b32 va[1], va[0]
+            buffer_load_dword va[0], v1, s[4:7], 0 offen
+            buffer_load_dword va[2], v1, s[4:7], 0 offen
+            s_sub_u32 s0, s0, 1
+            s_cbranch_scc0 loop
+            v_mov_b32 va[3], va[2]
+            s_endpgm
+)ffDXD",
+        { { 4U, { 1, 7, 7, 0 } }, { 32U, { 0, 7, 7, 0 } } }, nullptr, true
+    },
+    {   /* 6 - export (overwriting register before read out) */
+        R"ffDXD(.gpu Bonaire
+            exp  mrt0, v0, v1, v2, v3
+            v_mov_b32 v5, v1
+            v_mov_b32 v1, v4
+            s_endpgm
+)ffDXD",
+        { { 12U, { 15, 15, 0, 0 } } }, nullptr, true
+    },
+    {   /* 7 - routine */
+        R"ffDXD(.regvar sa:s:8
+            s_getpc_b64 s[2:3]
+            s_add_u32 s2, s2, routine-.
+            s_addc_u32 s3, s3, 0
+            .cf_call routine
+            s_swappc_b64 s[0:1], s[2:3]
+            s_mov_b32 sa[1], sa[2]
+            s_endpgm
+routine:
+            s_load_dword sa[2], s[10:11], 4
+            .cf_ret
+            s_swappc_b64 s[0:1], s[0:1]
+)ffDXD",
+        { { 20U, { 15, 0, 7, 0 } } }, nullptr, false
+    },
+    {   /* 8 - not read load result pending in next blocks */
+        R"ffDXD(.regvar va:v:8
+            buffer_load_dword va[2], v1, s[4:7], 0 offen
+            s_cbranch_scc0 l1
+            s_waitcnt vmcnt(0)
+            s_endpgm
+l1:         v_mov_b32 va[5], 1
+            v_mov_b32 va[6], 2
+            v_mov_b32 va[7], 3
+            v_add_f32 va[0], va[5], va[6]
+            v_add_f32 va[1], va[0], va[7]
+            v_mov_b32 v1, va[1]
+            s_endpgm
+)ffDXD",
+        { }, "", true
+    },
+    {   /* 9 - too broad wait (later waits are missing) */
+        R"ffDXD(.regvar va:v:8
+            buffer_load_dword va[0], v1, s[4:7], 0 offen
+            buffer_load_dword va[1], v1, s[4:7], 0 offen
+            buffer_load_dword va[2], v1, s[4:7], 0 offen
+            s_waitcnt vmcnt(0)
+            v_mov_b32 va[3], va[0]
+            v_mov_b32 va[4], va[1]
+            v_mov_b32 va[5], va[2]
+            s_endpgm
+)ffDXD",
+        { }, "test.s:5:13: Warning: Too broad wait "
+        "(vmcnt(2) is enough for next instruction)\n", true,
+        { { 24U, { 2, 7, 7, 0 } } }
+    }
+};
+
+static void testWaitSchedulerCase(cxuint i, const AsmWaitSchedulerCase& testCase)
+{
+    std::istringstream input(testCase.input);
+    std::ostringstream errorStream;
+    
+    Assembler assembler("test.s", input,
+                    (ASM_ALL&~ASM_ALTMACRO) | ASM_TESTRUN | ASM_TESTRESOLVE,
+                    BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    std::ostringstream oss;
+    oss << " testWaitSchedulerCase#" << i;
+    oss.flush();
+    const std::string testCaseName = oss.str();
+    assertTrue("testWaitScheduler", testCaseName+".good", good);
+    assertString("testWaitScheduler", testCaseName+".assemblerMessages",
+              "", errorStream.str());
+    if (assembler.getSections().size()<1)
+    {
+        std::ostringstream oss;
+        oss << "FAILED for " << " testWaitSchedulerCase#" << i;
+        throw Exception(oss.str());
+    }
+    
+    const AsmSection& section = assembler.getSections()[0];
+    AsmRegAllocator regAlloc(assembler);
+    regAlloc.createCodeStructure(section.codeFlow, section.getSize(),
+                            section.content.data());
+    regAlloc.createUsageArrays(*section.usageHandler);
+    GCNAssembler gcnAsm(assembler);
+    AsmWaitScheduler waitScheduler(gcnAsm.getWaitConfig(), assembler,
+                    regAlloc.getCodeBlocks(), regAlloc.getUsageArrays(),
+                    nullptr, nullptr, false);
+    waitScheduler.schedule(0);
+    
+    const std::vector<AsmWaitInstr>& resWaitInstrs = waitScheduler.getNeededWaitInstrs();
+    assertValue("testWaitScheduler", testCaseName+".size",
+                testCase.neededWaitInstrs.size(), resWaitInstrs.size());
+    for (size_t j = 0; j < resWaitInstrs.size(); j++)
+    {
+        std::ostringstream woss;
+        woss << testCaseName << ".waitInstr#" << j;
+        const std::string wiStr = woss.str();
+        const AsmWaitInstr& expWaitInstr = testCase.neededWaitInstrs[j];
+        assertValue("testWaitScheduler", wiStr+".offset", expWaitInstr.offset,
+                    resWaitInstrs[j].offset);
+        assertArray("testWaitScheduler", wiStr+".waits",
+                    Array<uint16_t>(expWaitInstr.waits, expWaitInstr.waits+4),
+                    4, resWaitInstrs[j].waits);
+    }
+    const std::vector<AsmWaitInstr>& resBroadWaits = waitScheduler.getTooBroadWaitInstrs();
+    assertValue("testWaitScheduler", testCaseName+".broadSize",
+                testCase.tooBroadWaitInstrs.size(), resBroadWaits.size());
+    for (size_t j = 0; j < resBroadWaits.size(); j++)
+    {
+        std::ostringstream woss;
+        woss << testCaseName << ".broadWait#" << j;
+        const std::string wiStr = woss.str();
+        const AsmWaitInstr& expWaitInstr = testCase.tooBroadWaitInstrs[j];
+        assertValue("testWaitScheduler", wiStr+".offset", expWaitInstr.offset,
+                    resBroadWaits[j].offset);
+        assertArray("testWaitScheduler", wiStr+".waits",
+                    Array<uint16_t>(expWaitInstr.waits, expWaitInstr.waits+4),
+                    4, resBroadWaits[j].waits);
+    }
+    
+    if (testCase.warnings != nullptr)
+    {
+        // check warnings printed by assembler
+        std::istringstream input2(testCase.input);
+        std::ostringstream errorStream2;
+        Assembler assembler2("test.s", input2, (ASM_ALL&~ASM_ALTMACRO) |
+                    ASM_CHECKWAITS | ASM_TESTRUN | ASM_TESTRESOLVE,
+                    BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, errorStream2);
+        assertTrue("testWaitScheduler", testCaseName+".good2", assembler2.assemble());
+        assertString("testWaitScheduler", testCaseName+".warnings",
+                    testCase.warnings, errorStream2.str());
+    }
+    
+    if (!testCase.checkAllocated)
+        return;
+    // with allocated registers (should give same waits)
+    regAlloc.allocateRegisters(0);
+    AsmWaitScheduler waitScheduler2(gcnAsm.getWaitConfig(), assembler,
+                    regAlloc.getCodeBlocks(), regAlloc.getUsageArrays(),
+                    regAlloc.getVregIndexMaps(), regAlloc.getGraphColorMaps(), false);
+    waitScheduler2.schedule(0);
+    const std::vector<AsmWaitInstr>& resWaitInstrs2 = waitScheduler2.getNeededWaitInstrs();
+    assertValue("testWaitScheduler", testCaseName+".alloc.size",
+                testCase.neededWaitInstrs.size(), resWaitInstrs2.size());
+    for (size_t j = 0; j < resWaitInstrs2.size(); j++)
+    {
+        std::ostringstream woss;
+        woss << testCaseName << ".alloc.waitInstr#" << j;
+        const std::string wiStr = woss.str();
+        const AsmWaitInstr& expWaitInstr = testCase.neededWaitInstrs[j];
+        assertValue("testWaitScheduler", wiStr+".offset", expWaitInstr.offset,
+                    resWaitInstrs2[j].offset);
+        assertArray("testWaitScheduler", wiStr+".waits",
+                    Array<uint16_t>(expWaitInstr.waits, expWaitInstr.waits+4),
+                    4, resWaitInstrs2[j].waits);
+    }
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -1078,5 +1325,14 @@ int main(int argc, const char** argv)
             std::cerr << ex.what() << std::endl;
             retVal = 1;
         }
+    for (cxuint i = 0; i < sizeof(waitSchedulerTestCases) /
+                    sizeof(AsmWaitSchedulerCase); i++)
+        try
+        { testWaitSchedulerCase(i, waitSchedulerTestCases[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
     return retVal;
 }
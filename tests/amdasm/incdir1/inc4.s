@@ -0,0 +1,6 @@
+            .byte 1, 2 # comment
+            .byte 3 /* long
+comment */ .byte 4
+            .ascii "a\
+ b"
+            .ascii "xy
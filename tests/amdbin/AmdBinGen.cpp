@@ -655,25 +655,31 @@ static void testOrigBinary(cxuint testCase, const char* origBinaryFilename, bool
         throw Exception("This is not AMDGPU binary file!");
     
     AmdGPUBinGenerator binGen(&amdInput);
-    binGen.generate(output);
-    
-    // compare result output binary
-    if (output.size() != inputData.size())
+    // check serial and parallel generation of inner binaries
+    for (cxuint threadsNum: { 1, 4 })
     {
-        std::ostringstream oss;
-        oss << "Failed for #" << testCase << " file=" << origBinaryFilename <<
-                ": expectedSize=" << inputData.size() <<
-                ", resultSize=" << output.size();
-        throw Exception(oss.str());
-    }
-    for (size_t i = 0; i < inputData.size(); i++)
-        if (output[i] != inputData[i])
+        binGen.setThreadsNum(threadsNum);
+        binGen.generate(output);
+        
+        // compare result output binary
+        if (output.size() != inputData.size())
         {
             std::ostringstream oss;
             oss << "Failed for #" << testCase << " file=" << origBinaryFilename <<
-                    ": byte=" << i;
+                    " threads=" << threadsNum <<
+                    ": expectedSize=" << inputData.size() <<
+                    ", resultSize=" << output.size();
             throw Exception(oss.str());
         }
+        for (size_t i = 0; i < inputData.size(); i++)
+            if (output[i] != inputData[i])
+            {
+                std::ostringstream oss;
+                oss << "Failed for #" << testCase << " file=" << origBinaryFilename <<
+                        " threads=" << threadsNum << ": byte=" << i;
+                throw Exception(oss.str());
+            }
+    }
 }
 
 int main(int argc, const char** argv)
@@ -608,6 +608,103 @@ static void testBinLoadingFailCase(cxuint testCaseId, const BinLoadingFailCase&
     }
 }
 
+template<typename ElfBinary>
+static void checkElfHashIndex(const std::string& testName, Array<cxbyte>& data)
+{
+    const ElfBinary hashBin(data.size(), data.data(),
+                ELF_CREATE_ALL|ELF_CREATE_HASHINDEX);
+    assertTrue(testName, "hasHashIndex", hashBin.hasHashIndex());
+    for (cxuint i = 0; i < hashBin.getSectionHeadersNum(); i++)
+    {
+        const char* name = hashBin.getSectionName(i);
+        std::ostringstream caseOss;
+        caseOss << "section#" << i;
+        const uint16_t index = hashBin.getSectionIndex(name);
+        assertString(testName, caseOss.str()+".name", name, hashBin.getSectionName(index));
+        assertValue(testName, caseOss.str()+".iter", size_t(index),
+                hashBin.getSectionIter(name)->second);
+    }
+    for (size_t i = 0; i < hashBin.getSymbolsNum(); i++)
+    {
+        const char* name = hashBin.getSymbolName(i);
+        std::ostringstream caseOss;
+        caseOss << "symbol#" << i;
+        const size_t index = hashBin.getSymbolIndex(name);
+        assertString(testName, caseOss.str()+".name", name, hashBin.getSymbolName(index));
+        assertValue(testName, caseOss.str()+".iter", index,
+                hashBin.getSymbolIter(name)->second);
+        // first symbol with this name should be found
+        assertTrue(testName, caseOss.str()+".first", index <= i);
+    }
+    bool notFound = false;
+    try
+    { hashBin.getSymbolIndex("____xxx_not_found_symbol"); }
+    catch(const BinException&)
+    { notFound = true; }
+    assertTrue(testName, "notFound", notFound);
+}
+
+// checking finding sections and symbols through hash index
+static void testElfHashIndex(const char* filename)
+{
+    const std::string testName = std::string("testElfHashIndex:") + filename;
+    Array<cxbyte> data = loadDataFromFile(filename);
+    if (data.size() > EI_CLASS && data[EI_CLASS] == ELFCLASS64)
+        checkElfHashIndex<ElfBinary64>(testName, data);
+    else
+        checkElfHashIndex<ElfBinary32>(testName, data);
+}
+
+// checking lazy parsing of AMD GPU binaries (also while accessing from many threads)
+static void testAmdLazyParsing(const char* filename)
+{
+    const std::string testName = std::string("testAmdLazyParsing:") + filename;
+    Array<cxbyte> data = loadDataFromFile(filename);
+    std::unique_ptr<AmdMainGPUBinaryBase> eagerBin(static_cast<AmdMainGPUBinaryBase*>(
+                createAmdBinaryFromCode(data.size(), data.data())));
+    std::unique_ptr<AmdMainGPUBinaryBase> lazyBin(static_cast<AmdMainGPUBinaryBase*>(
+                createAmdBinaryFromCode(data.size(), data.data(),
+                        AMDBIN_CREATE_ALL | AMDBIN_CREATE_LAZY)));
+    
+    const size_t kernelsNum = eagerBin->getKernelInfosNum();
+    assertValue(testName, "kernelsNum", kernelsNum, lazyBin->getKernelInfosNum());
+    assertValue(testName, "innerBinariesNum", eagerBin->getInnerBinariesNum(),
+                lazyBin->getInnerBinariesNum());
+    for (size_t i = 0; i < kernelsNum; i++)
+        assertValue(testName, "kernelName", eagerBin->getKernelName(i),
+                    lazyBin->getKernelName(i));
+    
+    // every kernel is accessed by few jobs at once
+    runParallelJobs(kernelsNum*4, 4, [&](size_t job)
+    {
+        const size_t i = job % kernelsNum;
+        std::ostringstream caseOss;
+        caseOss << "kernel#" << i;
+        const std::string caseName = caseOss.str();
+        const KernelInfo& expKInfo = eagerBin->getKernelInfo(i);
+        const KernelInfo& kinfo = lazyBin->getKernelInfo(expKInfo.kernelName.c_str());
+        assertValue(testName, caseName+".argsNum", expKInfo.argInfos.size(),
+                    kinfo.argInfos.size());
+        for (size_t k = 0; k < kinfo.argInfos.size(); k++)
+        {
+            assertValue(testName, caseName+".argName", expKInfo.argInfos[k].argName,
+                    kinfo.argInfos[k].argName);
+            assertValue(testName, caseName+".argType", expKInfo.argInfos[k].typeName,
+                    kinfo.argInfos[k].typeName);
+        }
+        const AmdInnerGPUBinary32& expInnerBin = eagerBin->getInnerBinary(i);
+        const AmdInnerGPUBinary32& innerBin = lazyBin->getInnerBinary(
+                    expInnerBin.getKernelName().c_str());
+        assertValue(testName, caseName+".innerSize", expInnerBin.getSize(),
+                    innerBin.getSize());
+        assertTrue(testName, caseName+".innerCode",
+                    expInnerBin.getBinaryCode() == innerBin.getBinaryCode());
+        assertValue(testName, caseName+".encodingsNum",
+                    expInnerBin.getCALEncodingEntriesNum(),
+                    innerBin.getCALEncodingEntriesNum());
+    });
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -657,6 +754,16 @@ int main(int argc, const char** argv)
             "/tests/amdbin/amdbins/structkernel2_cpu64.clo", "myKernel1",
             sizeof(expectedCPUKernelArgs2)/sizeof(AmdKernelArg), expectedCPUKernelArgs2);
     retVal |= callTest(testAmdGPUMetadataGen);
+    retVal |= callTest(testElfHashIndex, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/alltypes.clo");
+    retVal |= callTest(testElfHashIndex, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/alltypes_64.clo");
+    retVal |= callTest(testElfHashIndex, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/alltypes-15_11.clo");
+    retVal |= callTest(testAmdLazyParsing, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/prginfo8_14_12.clo.1_0.reconf");
+    retVal |= callTest(testAmdLazyParsing, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/prginfo8_14_12_64.clo.1_0.reconf");
     
     for (cxuint i = 0; i < sizeof(binLoadingTestCases)/sizeof(BinLoadingFailCase); i++)
     {
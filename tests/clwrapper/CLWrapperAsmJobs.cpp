@@ -0,0 +1,208 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../../clwrapper/CLAsmJobs.h"
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static void writeTestFile(const char* filename, const char* content)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << content;
+}
+
+static CLAsmDeviceJob makeAsmJob(GPUDeviceType devType, bool is64Bit)
+{
+    CLAsmDeviceJob asmJob;
+    asmJob.devType = devType;
+    asmJob.is64Bit = is64Bit;
+    return asmJob;
+}
+
+static void testAssembleForDevice()
+{
+    const char* testName = "testAssembleForDevice";
+    const std::vector<CString> includePaths;
+    const std::vector<std::pair<CString, uint64_t> > defSyms{ { "VALUE", 0x31 } };
+    const CLAsmCommonOptions options = { ASM_WARNINGS, false, false, false, 0, 0,
+                includePaths, defSyms, "" };
+    const char* source = ".rawcode\n.byte VALUE\n.warning \"xxx\"\n";
+    // for two device types
+    const GPUDeviceType devTypes[2] = { GPUDeviceType::PITCAIRN, GPUDeviceType::FIJI };
+    for (GPUDeviceType devType: devTypes)
+    {
+        CLAsmDeviceJob asmJob = makeAsmJob(devType, true);
+        clrxAssembleForDevice(::strlen(source), source, options, asmJob);
+        assertTrue(testName, "good", asmJob.good);
+        assertTrue(testName, "progBin", asmJob.progBin);
+        assertArray<cxbyte>(testName, "binary", Array<cxbyte>{ 0x31 },
+                    asmJob.progBin->binary);
+        assertString(testName, "log", "<stdin>:3:1: Warning: xxx\n", asmJob.log->log);
+    }
+    // failed assembling
+    const char* badSource = ".rawcode\ns_unknown_instr\n";
+    CLAsmDeviceJob asmJob = makeAsmJob(GPUDeviceType::PITCAIRN, false);
+    clrxAssembleForDevice(::strlen(badSource), badSource, options, asmJob);
+    assertTrue(testName, "badGood", !asmJob.good);
+    assertTrue(testName, "badProgBin", !asmJob.progBin);
+    assertString(testName, "badLog", "<stdin>:2:1: Error: Unknown instruction\n",
+                asmJob.log->log);
+}
+
+static void testAsmCache()
+{
+    const char* testName = "testAsmCache";
+    makeDir("CLAsmJobsCache");
+    writeTestFile("CLAsmJobsInc.s", ".byte 1\n");
+    const std::vector<CString> includePaths;
+    const std::vector<std::pair<CString, uint64_t> > defSyms;
+    const CLAsmCommonOptions options = { ASM_WARNINGS|ASM_FILEHASHES, false, false,
+                false, 0, 200406, includePaths, defSyms, "CLAsmJobsCache" };
+    const char* source = ".rawcode\n.include \"CLAsmJobsInc.s\"\n";
+    const size_t sourceSize = ::strlen(source);
+
+    CLAsmDeviceJob asmJob = makeAsmJob(GPUDeviceType::PITCAIRN, false);
+    const std::string cachePath = clrxGetAsmCachePath(sourceSize, source, options,
+                asmJob, false);
+    std::remove(cachePath.c_str());
+    clrxAssembleForDevice(sourceSize, source, options, asmJob);
+    assertTrue(testName, "good0", asmJob.good);
+    assertArray<cxbyte>(testName, "binary0", Array<cxbyte>{ 1 },
+                asmJob.progBin->binary);
+    assertTrue(testName, "entry0", isFileExists(cachePath.c_str()));
+
+    // replace binary in cache entry (last byte), to check whether it is taken
+    Array<cxbyte> entry = loadDataFromFile(cachePath.c_str());
+    entry[entry.size()-1] = 7;
+    {
+        std::ofstream ofs(cachePath.c_str(), std::ios::binary);
+        ofs.write((const char*)entry.data(), entry.size());
+    }
+    asmJob = makeAsmJob(GPUDeviceType::PITCAIRN, false);
+    clrxAssembleForDevice(sourceSize, source, options, asmJob);
+    assertTrue(testName, "good1", asmJob.good);
+    assertArray<cxbyte>(testName, "binary1", Array<cxbyte>{ 7 },
+                asmJob.progBin->binary);
+
+    // included file changed
+    writeTestFile("CLAsmJobsInc.s", ".byte 2\n");
+    asmJob = makeAsmJob(GPUDeviceType::PITCAIRN, false);
+    clrxAssembleForDevice(sourceSize, source, options, asmJob);
+    assertTrue(testName, "good2", asmJob.good);
+    assertArray<cxbyte>(testName, "binary2", Array<cxbyte>{ 2 },
+                asmJob.progBin->binary);
+
+    // key depends on driver version and device type
+    CLAsmCommonOptions options2 = options;
+    options2.driverVersion = 191205;
+    assertTrue(testName, "driverVersionKey", cachePath != clrxGetAsmCachePath(
+                sourceSize, source, options2, asmJob, false));
+    assertTrue(testName, "devTypeKey", cachePath != clrxGetAsmCachePath(
+                sourceSize, source, options,
+                makeAsmJob(GPUDeviceType::FIJI, false), false));
+    std::remove(cachePath.c_str());
+}
+
+static void testMergeAsmJobResults()
+{
+    const char* testName = "testMergeAsmJobResults";
+    std::vector<CLAsmDeviceJob> asmJobs(2);
+    asmJobs[0].good = true;
+    asmJobs[0].log = RefPtr<CLProgLogEntry>(new CLProgLogEntry("log0"));
+    asmJobs[0].progBin = RefPtr<CLProgBinEntry>(new CLProgBinEntry(Array<cxbyte>(4)));
+    asmJobs[1].good = false;
+    asmJobs[1].log = RefPtr<CLProgLogEntry>(new CLProgLogEntry("log1"));
+
+    // two devices share first job, third device is not supported
+    {
+        const cxuint devJobIndices[4] = { 0, 0, UINT_MAX, 1 };
+        CLAsmDeviceJob devResults[4];
+        bool asmFailure = false;
+        bool asmNotAvailable = false;
+        clrxMergeAsmJobResults(4, devJobIndices, asmJobs, devResults,
+                    asmFailure, asmNotAvailable);
+        assertTrue(testName, "asmFailure", asmFailure);
+        assertTrue(testName, "asmNotAvailable", asmNotAvailable);
+        for (cxuint i = 0; i < 2; i++)
+        {
+            assertTrue(testName, "good", devResults[i].good);
+            assertTrue(testName, "progBin", devResults[i].progBin == asmJobs[0].progBin);
+            assertString(testName, "log", "log0", devResults[i].log->log);
+        }
+        assertTrue(testName, "good2", !devResults[2].good);
+        assertTrue(testName, "log2", !devResults[2].log);
+        assertTrue(testName, "progBin2", !devResults[2].progBin);
+        assertTrue(testName, "good3", !devResults[3].good);
+        assertTrue(testName, "progBin3", !devResults[3].progBin);
+        assertString(testName, "log3", "log1", devResults[3].log->log);
+    }
+    // all devices succeeded
+    {
+        const cxuint devJobIndices[2] = { 0, 0 };
+        CLAsmDeviceJob devResults[2];
+        bool asmFailure = false;
+        bool asmNotAvailable = false;
+        clrxMergeAsmJobResults(2, devJobIndices, asmJobs, devResults,
+                    asmFailure, asmNotAvailable);
+        assertTrue(testName, "asmFailure1", !asmFailure);
+        assertTrue(testName, "asmNotAvailable1", !asmNotAvailable);
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    try
+    { testAssembleForDevice(); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    try
+    { testAsmCache(); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    try
+    { testMergeAsmJobResults(); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    std::remove("CLAsmJobsInc.s");
+    std::remove("CLAsmJobsCache");
+    return retVal;
+}
@@ -0,0 +1,115 @@
+####
+#  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+#  Copyright (C) 2014-2018 Mateusz Szpakowski
+#
+#  This library is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU Lesser General Public
+#  License as published by the Free Software Foundation; either
+#  version 2.1 of the License, or (at your option) any later version.
+#
+#  This library is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+#  Lesser General Public License for more details.
+#
+#  You should have received a copy of the GNU Lesser General Public
+#  License along with this library; if not, write to the Free Software
+#  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+####
+
+
+# test of clrxasm batch mode: manifest parsing (comments, empty lines, quoting),
+# rejecting batch options in jobs, order of messages, exit codes and jobs sharing
+# included files
+# variables: CLRXASM - clrxasm program, BATCH_DIR - manifests and sources,
+# WORK_DIR - directory where jobs are run
+
+FILE(REMOVE_RECURSE "${WORK_DIR}")
+FILE(MAKE_DIRECTORY "${WORK_DIR}")
+FILE(GLOB BATCH_FILES "${BATCH_DIR}/*")
+FILE(COPY ${BATCH_FILES} DESTINATION "${WORK_DIR}")
+
+MACRO(RUN_BATCH MANIFEST JOBS)
+    EXECUTE_PROCESS(COMMAND "${CLRXASM}" "--batch=${MANIFEST}" -j ${JOBS}
+            WORKING_DIRECTORY "${WORK_DIR}"
+            RESULT_VARIABLE BATCH_RESULT
+            OUTPUT_VARIABLE BATCH_OUTPUT
+            ERROR_VARIABLE BATCH_ERROR)
+ENDMACRO(RUN_BATCH)
+
+MACRO(CHECK_RESULT EXPECTED)
+    IF(NOT "${BATCH_RESULT}" STREQUAL "${EXPECTED}")
+        MESSAGE(FATAL_ERROR "${TEST_NAME}: exit code ${BATCH_RESULT}, "
+                "expected ${EXPECTED}\n${BATCH_ERROR}")
+    ENDIF(NOT "${BATCH_RESULT}" STREQUAL "${EXPECTED}")
+ENDMACRO(CHECK_RESULT)
+
+MACRO(CHECK_FILE FILENAME EXPECTED)
+    IF(NOT EXISTS "${WORK_DIR}/${FILENAME}")
+        MESSAGE(FATAL_ERROR "${TEST_NAME}: file '${FILENAME}' is not created")
+    ENDIF(NOT EXISTS "${WORK_DIR}/${FILENAME}")
+    FILE(READ "${WORK_DIR}/${FILENAME}" FILE_CONTENT HEX)
+    IF(NOT "${FILE_CONTENT}" STREQUAL "${EXPECTED}")
+        MESSAGE(FATAL_ERROR "${TEST_NAME}: content of '${FILENAME}' is "
+                "${FILE_CONTENT}, expected ${EXPECTED}")
+    ENDIF(NOT "${FILE_CONTENT}" STREQUAL "${EXPECTED}")
+ENDMACRO(CHECK_FILE)
+
+# check that messages are in stderr in given order
+MACRO(CHECK_MESSAGES)
+    SET(MSG_POS 0)
+    FOREACH(MSG ${ARGN})
+        STRING(FIND "${BATCH_ERROR}" "${MSG}" NEW_MSG_POS)
+        IF(NEW_MSG_POS LESS MSG_POS)
+            MESSAGE(FATAL_ERROR "${TEST_NAME}: missing or misordered "
+                    "message '${MSG}'\n${BATCH_ERROR}")
+        ENDIF(NEW_MSG_POS LESS MSG_POS)
+        SET(MSG_POS ${NEW_MSG_POS})
+    ENDFOREACH(MSG)
+ENDMACRO(CHECK_MESSAGES)
+
+# failing jobs (assembler error and rejected option) between good jobs
+FOREACH(JOBS 1 3)
+    SET(TEST_NAME "manifest.txt -j ${JOBS}")
+    FILE(REMOVE "${WORK_DIR}/good.bin" "${WORK_DIR}/good 2.bin")
+    RUN_BATCH(manifest.txt ${JOBS})
+    CHECK_RESULT(1)
+    CHECK_FILE(good.bin "000081bf")
+    CHECK_FILE("good 2.bin" "34120000")
+    IF(EXISTS "${WORK_DIR}/good3.bin")
+        MESSAGE(FATAL_ERROR "${TEST_NAME}: rejected job has been run")
+    ENDIF(EXISTS "${WORK_DIR}/good3.bin")
+    CHECK_MESSAGES("bad.s:3:9: Error: Unknown instruction"
+            "Job at manifest line 4 failed"
+            "good2.s:2:9: Warning: good2 assembled"
+            "Batch options are not allowed in job"
+            "Job at manifest line 6 failed")
+    STRING(FIND "${BATCH_ERROR}" "manifest line 2 " FAILED_POS)
+    IF(NOT FAILED_POS EQUAL -1)
+        MESSAGE(FATAL_ERROR "${TEST_NAME}: good job is failed\n${BATCH_ERROR}")
+    ENDIF(NOT FAILED_POS EQUAL -1)
+ENDFOREACH(JOBS)
+
+# all jobs succeeded
+SET(TEST_NAME "manifest_good.txt")
+RUN_BATCH(manifest_good.txt 2)
+CHECK_RESULT(0)
+CHECK_FILE(good2.bin "05000000")
+
+# jobs including this same file (by include cache)
+SET(TEST_NAME "manifest_include.txt")
+RUN_BATCH(manifest_include.txt 3)
+CHECK_RESULT(0)
+CHECK_FILE(incl1.bin "01000000")
+CHECK_FILE(incl2.bin "02000000")
+CHECK_FILE(incl3.bin "03000000")
+
+# unterminated quote stops batch before running any job
+SET(TEST_NAME "manifest_quote.txt")
+FILE(REMOVE "${WORK_DIR}/good.bin")
+RUN_BATCH(manifest_quote.txt 2)
+CHECK_RESULT(1)
+CHECK_MESSAGES("Unterminated quote in manifest line 1")
+IF(EXISTS "${WORK_DIR}/good.bin")
+    MESSAGE(FATAL_ERROR "${TEST_NAME}: job has been run")
+ENDIF(EXISTS "${WORK_DIR}/good.bin")
@@ -0,0 +1,3 @@
+        .rawcode
+        s_endpgm
+        s_unknown_instr
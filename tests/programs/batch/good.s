@@ -0,0 +1,2 @@
+        .rawcode
+        s_endpgm
@@ -0,0 +1,3 @@
+        .rawcode
+        .warning "good2 assembled"
+        .int VALUE
@@ -0,0 +1,3 @@
+        .rawcode
+        .include "macros.inc"
+        putval VALUE
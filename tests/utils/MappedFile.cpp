@@ -0,0 +1,74 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* mappedFileNames[] =
+{
+    CLRX_SOURCE_DIR "/tests/amdasm/amdbins/amd1.clo",
+    CLRX_SOURCE_DIR "/tests/amdasm/amdbins/amdcl2.clo",
+    CLRX_SOURCE_DIR "/tests/amdasm/amdbins/rocm-fiji.hsaco"
+};
+
+static void testMappedFile()
+{
+    for (const char* filename: mappedFileNames)
+    {
+        // content of mapped file must be same as loaded content
+        const Array<cxbyte> loaded = loadDataFromFile(filename);
+        MappedFile mapped(filename);
+        assertTrue("testMappedFile", std::string(filename) + ".isMapped",
+                   mapped.isMapped());
+        assertValue("testMappedFile", std::string(filename) + ".size",
+                    loaded.size(), mapped.size());
+        assertTrue("testMappedFile", std::string(filename) + ".content",
+                ::memcmp(loaded.data(), mapped.data(), loaded.size()) == 0);
+        // modification of mapping should not change file
+        mapped.data()[0] ^= 0xff;
+        const Array<cxbyte> loaded2 = loadDataFromFile(filename);
+        assertTrue("testMappedFile", std::string(filename) + ".notModified",
+                ::memcmp(loaded.data(), loaded2.data(), loaded.size()) == 0);
+        mapped.close();
+        assertValue("testMappedFile", std::string(filename) + ".closeSize",
+                    size_t(0), mapped.size());
+    }
+    
+    // directory can not be mapped
+    bool failed = false;
+    try
+    { MappedFile mapped(CLRX_SOURCE_DIR "/tests"); }
+    catch(const Exception& ex)
+    { failed = true; }
+    assertTrue("testMappedFile", "directory", failed);
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testMappedFile);
+    return retVal;
+}
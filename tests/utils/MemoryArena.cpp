@@ -0,0 +1,105 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static void testMemoryArena()
+{
+    MemoryArena arena;
+    // objects of same size are not overlapped
+    uint64_t* ptrs[10000];
+    for (size_t i = 0; i < 10000; i++)
+    {
+        ptrs[i] = reinterpret_cast<uint64_t*>(arena.allocate(24));
+        ptrs[i][0] = ptrs[i][1] = ptrs[i][2] = i;
+    }
+    for (size_t i = 0; i < 10000; i++)
+        for (size_t j = 0; j < 3; j++)
+            assertValue("testMemoryArena", "ptrs", uint64_t(i), ptrs[i][j]);
+    const size_t chunksNum = arena.getChunksNum();
+    // freed objects must be reused
+    for (size_t i = 0; i < 10000; i++)
+        arena.deallocate(ptrs[i], 24);
+    for (size_t i = 0; i < 10000; i++)
+        ptrs[i] = reinterpret_cast<uint64_t*>(arena.allocate(20));
+    assertValue("testMemoryArena", "chunksNum", chunksNum, arena.getChunksNum());
+    // big objects are allocated from heap
+    void* bigPtr = arena.allocate(10000);
+    assertValue("testMemoryArena", "chunksNum2", chunksNum, arena.getChunksNum());
+    arena.deallocate(bigPtr, 10000);
+}
+
+typedef std::unordered_map<std::string, size_t, std::hash<std::string>,
+        std::equal_to<std::string>, ArenaAllocator<std::pair<const std::string, size_t> > >
+        ArenaStringMap;
+
+static void testArenaAllocator()
+{
+    char buf[40];
+    MemoryArena arena;
+    {
+        ArenaStringMap map(0, ArenaStringMap::hasher(), ArenaStringMap::key_equal(),
+                    ArenaStringMap::allocator_type(&arena));
+        for (size_t i = 0; i < 5000; i++)
+        {
+            snprintf(buf, sizeof buf, "sym%zu", i);
+            map.insert(std::make_pair(std::string(buf), i));
+        }
+        assertTrue("testArenaAllocator", "chunksNum", arena.getChunksNum() != 0);
+        for (size_t i = 0; i < 5000; i += 2)
+        {
+            snprintf(buf, sizeof buf, "sym%zu", i);
+            map.erase(buf);
+        }
+        // copy of map must not use arena
+        ArenaStringMap mapCopy(map);
+        assertTrue("testArenaAllocator", "copyArena",
+                   mapCopy.get_allocator().getArena() == nullptr);
+        assertValue("testArenaAllocator", "copySize", size_t(2500), mapCopy.size());
+        for (size_t i = 0; i < 5000; i++)
+        {
+            snprintf(buf, sizeof buf, "sym%zu", i);
+            auto it = mapCopy.find(buf);
+            if ((i&1) == 0)
+                assertTrue("testArenaAllocator", buf, it == mapCopy.end());
+            else
+            {
+                assertTrue("testArenaAllocator", buf, it != mapCopy.end());
+                assertValue("testArenaAllocator", buf, i, it->second);
+            }
+        }
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testMemoryArena);
+    retVal |= callTest(testArenaAllocator);
+    return retVal;
+}
@@ -0,0 +1,82 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <atomic>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static void testRunParallelJobs()
+{
+    char descBuf[60];
+    static const size_t jobsNums[] = { 0, 1, 2, 7, 100, 1000 };
+    static const cxuint threadsNums[] = { 0, 1, 2, 3, 8 };
+    for (size_t jobsNum: jobsNums)
+        for (cxuint threadsNum: threadsNums)
+        {
+            snprintf(descBuf, sizeof descBuf, "Test %zu %u", jobsNum, threadsNum);
+            // every job must be executed exactly once
+            std::vector<std::atomic<cxuint> > counts(jobsNum);
+            for (std::atomic<cxuint>& c: counts)
+                c.store(0);
+            runParallelJobs(jobsNum, threadsNum, [&counts](size_t i)
+                    { counts[i].fetch_add(1); });
+            for (size_t i = 0; i < jobsNum; i++)
+                assertValue("testRunParallelJobs", descBuf, cxuint(1),
+                            cxuint(counts[i].load()));
+        }
+    
+    // checking exceptions
+    for (cxuint threadsNum: threadsNums)
+    {
+        snprintf(descBuf, sizeof descBuf, "TestExc %u", threadsNum);
+        std::atomic<size_t> doneJobs(0);
+        bool failed = false;
+        try
+        {
+            runParallelJobs(100, threadsNum, [&doneJobs](size_t i)
+            {
+                if (i == 5)
+                    throw Exception("Job failed");
+                doneJobs.fetch_add(1);
+            });
+        }
+        catch(const Exception& ex)
+        {
+            failed = true;
+            assertString("testRunParallelJobs", descBuf, "Job failed", ex.what());
+        }
+        assertTrue("testRunParallelJobs", descBuf, failed);
+        assertTrue("testRunParallelJobs", descBuf, doneJobs.load() < 100);
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testRunParallelJobs);
+    return retVal;
+}
@@ -235,6 +235,47 @@ std::streambuf* VectorStreamBuf::setbuf(std::streambuf::char_type* buffer,
     return this;
 }
 
+GatherStreamBuf::GatherStreamBuf() : size(0)
+{ }
+
+void GatherStreamBuf::addExternal(size_t length, const char* external)
+{
+    if (length == 0)
+        return;
+    segments.push_back({ external, 0, length });
+    size += length;
+}
+
+void GatherStreamBuf::writeTo(FastOutputBuffer& fob) const
+{
+    for (const Segment& segment: segments)
+        fob.write(segment.size, (segment.external != nullptr) ? segment.external :
+                    data.data() + segment.offset);
+}
+
+std::streambuf::int_type GatherStreamBuf::overflow(std::streambuf::int_type ch)
+{
+    if (ch == traits_type::eof())
+        return ch;
+    const char c = traits_type::to_char_type(ch);
+    xsputn(&c, 1);
+    return ch;
+}
+
+std::streamsize GatherStreamBuf::xsputn(const std::streambuf::char_type* s,
+            std::streamsize n)
+{
+    if (n <= 0)
+        return 0;
+    // join with last segment if it is in held buffer
+    if (segments.empty() || segments.back().external != nullptr)
+        segments.push_back({ nullptr, data.size(), 0 });
+    data.insert(data.end(), s, s+n);
+    segments.back().size += n;
+    size += n;
+    return n;
+}
+
 /*
  * Streams
  */
@@ -292,3 +333,8 @@ VectorIOStream::VectorIOStream(std::vector<char>& vector)
 {
     rdbuf(&buffer);
 }
+
+GatherOStream::GatherOStream() : std::ostream(nullptr)
+{
+    rdbuf(&buffer);
+}
@@ -30,17 +30,23 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
 #endif
 #include <fstream>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <mutex>
+#include <thread>
+#include <exception>
+#include <system_error>
 #include <cerrno>
 #include <cstring>
 #include <string>
 #include <climits>
+#include <algorithm>
 #define __UTILITIES_MODULE__ 1
 #include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/MemAccess.h>
 
 using namespace CLRX;
 
@@ -244,6 +250,63 @@ static const char cstyleEscapesTable[32] =
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
+static inline uint64_t rotl64(uint64_t x, cxuint r)
+{ return (x << r) | (x >> (64 - r)); }
+
+static inline uint64_t fmix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+std::pair<uint64_t, uint64_t> CLRX::calculateHash128(size_t size, const void* data,
+            uint64_t seed)
+{
+    const cxbyte* bytes = reinterpret_cast<const cxbyte*>(data);
+    const size_t blocksNum = size >> 4;
+    uint64_t h1 = seed, h2 = seed;
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+    
+    // body (16-byte blocks)
+    for (size_t i = 0; i < blocksNum; i++)
+    {
+        uint64_t k1, k2;
+        ::memcpy(&k1, bytes + i*16, 8);
+        ::memcpy(&k2, bytes + i*16 + 8, 8);
+        k1 = LEV(k1);
+        k2 = LEV(k2);
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1*5 + 0x52dce729;
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2*5 + 0x38495ab5;
+    }
+    
+    // tail
+    const cxbyte* tail = bytes + blocksNum*16;
+    uint64_t k1 = 0, k2 = 0;
+    const cxuint tailSize = size & 15;
+    for (cxuint i = tailSize; i > 8; i--)
+        k2 ^= uint64_t(tail[i-1]) << ((i-9)*8);
+    if (tailSize > 8)
+    { k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2; }
+    for (cxuint i = std::min(tailSize, 8U); i > 0; i--)
+        k1 ^= uint64_t(tail[i-1]) << ((i-1)*8);
+    if (tailSize != 0)
+    { k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1; }
+    
+    // finalization
+    h1 ^= size; h2 ^= size;
+    h1 += h2; h2 += h1;
+    h1 = fmix64(h1); h2 = fmix64(h2);
+    h1 += h2; h2 += h1;
+    return std::make_pair(h1, h2);
+}
+
 std::string CLRX::escapeStringCStyle(size_t strSize, const char* str)
 {
     std::string out;
@@ -463,6 +526,114 @@ Array<cxbyte> CLRX::loadDataFromFile(const char* filename)
     return buf;
 }
 
+MappedFile::MappedFile() : content(nullptr), contentSize(0), mapped(false)
+{ }
+
+MappedFile::MappedFile(const char* filename)
+        : content(nullptr), contentSize(0), mapped(false)
+{
+    open(filename);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+void MappedFile::open(const char* filename)
+{
+    close();
+    if (isDirectory(filename))
+        throw Exception("This is directory!");
+#ifdef HAVE_WINDOWS
+    HANDLE file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw Exception("Can't open file");
+    LARGE_INTEGER fileSize;
+    if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &fileSize))
+    {
+        if (uint64_t(fileSize.QuadPart) > SIZE_MAX)
+        {
+            CloseHandle(file);
+            throw Exception("File is too big to load");
+        }
+        if (fileSize.QuadPart == 0)
+        {
+            // empty file can not be mapped
+            CloseHandle(file);
+            mapped = true;
+            return;
+        }
+        HANDLE fileMapping = CreateFileMapping(file, nullptr, PAGE_WRITECOPY, 0, 0,
+                    nullptr);
+        if (fileMapping != nullptr)
+        {
+            // view holds file mapping, hence handles can be closed
+            content = (cxbyte*)MapViewOfFile(fileMapping, FILE_MAP_COPY, 0, 0, 0);
+            CloseHandle(fileMapping);
+        }
+        CloseHandle(file);
+        if (content == nullptr)
+            throw Exception("Can't map file");
+        contentSize = fileSize.QuadPart;
+        mapped = true;
+        return;
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+        throw Exception("Can't open file");
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+    {
+        if (uint64_t(st.st_size) > SIZE_MAX)
+        {
+            ::close(fd);
+            throw Exception("File is too big to load");
+        }
+        if (st.st_size == 0)
+        {
+            // empty file can not be mapped
+            ::close(fd);
+            mapped = true;
+            return;
+        }
+        // private mapping: modifications are not written to file
+        void* ptr = ::mmap(nullptr, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (ptr == MAP_FAILED)
+            throw Exception("Can't map file");
+        content = (cxbyte*)ptr;
+        contentSize = st.st_size;
+        mapped = true;
+        return;
+    }
+    ::close(fd);
+#endif
+    // if not regular file (pipe, device), just load content
+    loadedContent = loadDataFromFile(filename);
+    content = loadedContent.data();
+    contentSize = loadedContent.size();
+}
+
+void MappedFile::close()
+{
+    if (mapped && content != nullptr)
+    {
+#ifdef HAVE_WINDOWS
+        UnmapViewOfFile(content);
+#else
+        ::munmap(content, contentSize);
+#endif
+    }
+    loadedContent.clear();
+    content = nullptr;
+    contentSize = 0;
+    mapped = false;
+}
+
 void CLRX::filesystemPath(char* path)
 {
     while (*path != 0)  // change to native dir separator
@@ -804,3 +975,64 @@ std::string CLRX::findLLVMConfig()
     }
     return "";
 }
+
+cxuint CLRX::getHardwareThreadsNum()
+{
+    const cxuint threadsNum = std::thread::hardware_concurrency();
+    return (threadsNum!=0) ? threadsNum : 1;
+}
+
+void CLRX::runParallelJobs(size_t jobsNum, cxuint threadsNum,
+            const std::function<void(size_t)>& job)
+{
+    if (threadsNum == 0)
+        threadsNum = getHardwareThreadsNum();
+    if (threadsNum > jobsNum)
+        threadsNum = jobsNum;
+    if (threadsNum <= 1)
+    {
+        // just run serially in this thread
+        for (size_t i = 0; i < jobsNum; i++)
+            job(i);
+        return;
+    }
+    
+    std::atomic<size_t> nextJob(0);
+    std::mutex exMutex;
+    std::exception_ptr firstException;
+    
+    auto worker = [&]()
+    {
+        while (true)
+        {
+            const size_t i = nextJob.fetch_add(1);
+            if (i >= jobsNum)
+                break;
+            try
+            { job(i); }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(exMutex);
+                if (!firstException)
+                    firstException = std::current_exception();
+                // do not start remaining jobs
+                nextJob.store(jobsNum);
+            }
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    threads.reserve(threadsNum-1);
+    try
+    {
+        for (cxuint i = 1; i < threadsNum; i++)
+            threads.push_back(std::thread(worker));
+    }
+    catch(const std::system_error& ex)
+    { } // if thread creation failed, then just use already created threads
+    worker(); // caller thread also executes jobs
+    for (std::thread& thread: threads)
+        thread.join();
+    if (firstException)
+        std::rethrow_exception(firstException);
+}